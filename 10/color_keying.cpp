@@ -2,37 +2,11 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include <string>
+#include "../common/ltexture.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-class LTexture
-{
-public:
-    LTexture();
-
-    ~LTexture();
-
-    // Load image from path
-    bool loadFromFile(std::string path);
-
-    // Deallocates texture from memory
-    void free();
-
-    // Renders texture at (x, y)
-    void render(int x, int y);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    // Actual texture
-    SDL_Texture *mTexture;
-
-    int mWidth;
-    int mHeight;
-};
-
 bool init();
 bool loadMedia();
 void close();
@@ -40,80 +14,10 @@ void close();
 SDL_Window *gWindow = NULL;
 SDL_Renderer *gRenderer = NULL;
 
+TextureCache gTextures;
 LTexture gFooTexture;
 LTexture gBackgroundTexture;
 
-LTexture::LTexture()
-{
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-}
-
-LTexture::~LTexture()
-{
-    free();
-}
-
-bool LTexture::loadFromFile(std::string path)
-{
-    free();
-
-    SDL_Texture *newTexture = NULL;
-
-    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Unable to load image!" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-        newTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Unable to create texture!" << std::endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-
-        SDL_FreeSurface(loadedSurface);
-    }
-
-    mTexture = newTexture;
-    return mTexture != NULL;
-}
-
-void LTexture::free()
-{
-    if (mTexture != NULL)
-    {
-        SDL_DestroyTexture(mTexture);
-        mTexture = NULL;
-        mWidth = 0;
-        mHeight = 0;
-    }
-}
-
-void LTexture::render(int x, int y)
-{
-    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
-    SDL_RenderCopy(gRenderer, mTexture, NULL, &renderQuad);
-}
-
-int LTexture::getWidth()
-{
-    return mWidth;
-}
-
-int LTexture::getHeight()
-{
-    return mHeight;
-}
-
 bool init()
 {
     bool success = true;
@@ -159,13 +63,17 @@ bool loadMedia()
 {
     bool success = true;
 
-    if (!gFooTexture.loadFromFile("./foo.png"))
+    // Only the first run keys foo.png; the key-alpha bake cache keeps the result.
+    TextureLoadOptions keyAlpha;
+    keyAlpha.premultiply = true;
+
+    if (!gFooTexture.loadFromCache(gTextures, gRenderer, "./foo.png", keyAlpha))
     {
         std::cout << "Failed to load foo texture image" << std::endl;
         success = false;
     }
 
-    if (!gBackgroundTexture.loadFromFile("./background.png"))
+    if (!gBackgroundTexture.loadFromCache(gTextures, gRenderer, "./background.png"))
     {
         std::cout << "Failed to load background image" << std::endl;
         success = false;
@@ -178,6 +86,7 @@ void close()
 {
     gFooTexture.free();
     gBackgroundTexture.free();
+    gTextures.clear();
 
     SDL_DestroyRenderer(gRenderer);
     SDL_DestroyWindow(gWindow);
@@ -2,33 +2,12 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include <string>
+#include "../common/animation.h"
+#include "../common/ltexture.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-class LTexture
-{
-public:
-    LTexture();
-
-    ~LTexture();
-
-    bool loadFromFile(std::string path);
-
-    void free();
-
-    void render(int x, int y, SDL_Rect *clip = NULL);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    SDL_Texture *mTexture;
-
-    int mWidth;
-    int mHeight;
-};
-
 bool init();
 bool loadMedia();
 void close();
@@ -36,86 +15,9 @@ void close();
 SDL_Window *gWindow = NULL;
 SDL_Renderer *gRenderer = NULL;
 
-SDL_Rect gSpriteClips[4];
+AnimationSet gSpriteSheet;
 LTexture gSpriteSheetTexture;
 
-LTexture::LTexture()
-{
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-}
-
-LTexture::~LTexture()
-{
-    free();
-}
-
-bool LTexture::loadFromFile(std::string path)
-{
-    free();
-
-    SDL_Texture *newTexture = NULL;
-    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Unable to load image!" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-        newTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Unable to create texture" << std::endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-
-        SDL_FreeSurface(loadedSurface);
-    }
-
-    mTexture = newTexture;
-    return mTexture != NULL;
-}
-
-void LTexture::free()
-{
-    if (mTexture != NULL)
-    {
-        SDL_DestroyTexture(mTexture);
-        mTexture = NULL;
-        mWidth = 0;
-        mHeight = 0;
-    }
-}
-
-void LTexture::render(int x, int y, SDL_Rect *clip)
-{
-    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
-
-    if (clip != NULL)
-    {
-        renderQuad.w = clip->w;
-        renderQuad.h = clip->h;
-    }
-
-    SDL_RenderCopy(gRenderer, mTexture, clip, &renderQuad);
-}
-
-int LTexture::getWidth()
-{
-    return mWidth;
-}
-
-int LTexture::getHeight()
-{
-    return mHeight;
-}
-
 bool init()
 {
     bool success = true;
@@ -161,32 +63,14 @@ bool loadMedia()
 {
     bool success = true;
 
-    if (!gSpriteSheetTexture.loadFromFile("./dots.png"))
+    if (!gSpriteSheetTexture.loadFromFile(gRenderer, "./dots.png"))
     {
         std::cout << "Failed to load sprite sheet!" << std::endl;
         success = false;
     }
     else
     {
-        gSpriteClips[0].x = 0;
-        gSpriteClips[0].y = 0;
-        gSpriteClips[0].w = 100;
-        gSpriteClips[0].h = 100;
-
-        gSpriteClips[1].x = 100;
-        gSpriteClips[1].y = 0;
-        gSpriteClips[1].w = 100;
-        gSpriteClips[1].h = 100;
-
-        gSpriteClips[2].x = 0;
-        gSpriteClips[2].y = 100;
-        gSpriteClips[2].w = 100;
-        gSpriteClips[2].h = 100;
-
-        gSpriteClips[3].x = 100;
-        gSpriteClips[3].y = 100;
-        gSpriteClips[3].w = 100;
-        gSpriteClips[3].h = 100;
+        gSpriteSheet.addGrid(100, 100, 2, 2);
     }
 
     return success;
@@ -237,13 +121,13 @@ int main(int argc, char const *argv[])
                 SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
                 SDL_RenderClear(gRenderer);
 
-                gSpriteSheetTexture.render(0, 0, &gSpriteClips[0]);
+                gSpriteSheetTexture.render(0, 0, &gSpriteSheet.getFrame(0));
 
-                gSpriteSheetTexture.render(SCREEN_WIDTH - gSpriteClips[1].w, 0, &gSpriteClips[1]);
+                gSpriteSheetTexture.render(SCREEN_WIDTH - gSpriteSheet.getFrame(1).w, 0, &gSpriteSheet.getFrame(1));
 
-                gSpriteSheetTexture.render(0, SCREEN_HEIGHT - gSpriteClips[2].h, &gSpriteClips[2]);
+                gSpriteSheetTexture.render(0, SCREEN_HEIGHT - gSpriteSheet.getFrame(2).h, &gSpriteSheet.getFrame(2));
 
-                gSpriteSheetTexture.render(SCREEN_WIDTH - gSpriteClips[3].w, SCREEN_HEIGHT - gSpriteClips[3].h, &gSpriteClips[3]);
+                gSpriteSheetTexture.render(SCREEN_WIDTH - gSpriteSheet.getFrame(3).w, SCREEN_HEIGHT - gSpriteSheet.getFrame(3).h, &gSpriteSheet.getFrame(3));
 
                 SDL_RenderPresent(gRenderer);
             }
@@ -2,34 +2,12 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include <string>
+#include "../common/ltexture.h"
+#include "../common/render_queue.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-class LTexture
-{
-public:
-    LTexture();
-
-    ~LTexture();
-
-    bool loadFromFile(std::string path);
-
-    void free();
-
-    void setColor(Uint8 red, Uint8 green, Uint8 blue);
-
-    void render(int x, int y, SDL_Rect *clip = NULL);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    SDL_Texture *mTexture;
-    int mWidth;
-    int mHeight;
-};
-
 bool init();
 bool loadMedia();
 void close();
@@ -40,90 +18,8 @@ SDL_Renderer *gRenderer = NULL;
 
 LTexture modulatedTexture;
 
-LTexture::LTexture()
-{
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-}
-
-LTexture::~LTexture()
-{
-    free();
-}
-
-void LTexture::free()
-{
-    if (mTexture != NULL)
-    {
-        SDL_DestroyTexture(mTexture);
-
-        mTexture = NULL;
-        mWidth = 0;
-        mHeight = 0;
-    }
-}
-
-void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
-{
-    SDL_SetTextureColorMod(mTexture, red, green, blue);
-}
-
-bool LTexture::loadFromFile(std::string path)
-{
-    free();
-
-    SDL_Texture *newTexture = NULL;
-    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
-
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Unable to load image" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-
-        newTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Texture could not be created" << std::endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-
-        SDL_FreeSurface(loadedSurface);
-    }
-
-    mTexture = newTexture;
-    return mTexture != NULL;
-}
-
-int LTexture::getWidth()
-{
-    return mWidth;
-}
-
-int LTexture::getHeight()
-{
-    return mHeight;
-}
-
-void LTexture::render(int x, int y, SDL_Rect *clip)
-{
-    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
-
-    if (clip != NULL)
-    {
-        renderQuad.w = clip->w;
-        renderQuad.h = clip->h;
-    }
-
-    SDL_RenderCopy(gRenderer, mTexture, clip, &renderQuad);
-}
+// Color mod is only sent to SDL on frames where it changed
+RenderQueue renderQueue;
 
 bool init()
 {
@@ -171,7 +67,7 @@ bool loadMedia()
 {
     bool success = true;
 
-    if (!modulatedTexture.loadFromFile("./colors.png"))
+    if (!modulatedTexture.loadFromFile(gRenderer, "./colors.png"))
     {
         std::cout << "Unable to load file" << std::endl;
         success = false;
@@ -258,8 +154,9 @@ int main(int argc, char const *argv[])
                 SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
                 SDL_RenderClear(gRenderer);
 
-                modulatedTexture.setColor(r, g, b);
-                modulatedTexture.render(0, 0);
+                renderQueue.setColor(r, g, b);
+                renderQueue.copy(modulatedTexture, 0, 0);
+                renderQueue.submit(gRenderer);
 
                 SDL_RenderPresent(gRenderer);
             }
@@ -2,39 +2,12 @@
 #include <SDL2/SDL_image.h>
 #include <string>
 #include <iostream>
+#include "../common/ltexture.h"
+#include "../common/render_queue.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-class LTexture
-{
-public:
-    LTexture();
-
-    ~LTexture();
-
-    bool loadFromFile(std::string path);
-
-    void free();
-
-    void setColor(Uint8 red, Uint8 green, Uint8 blue);
-
-    void setBlendMode(SDL_BlendMode blending);
-
-    void setAlpha(Uint8 alpha);
-
-    void render(int x, int y, SDL_Rect *clip = NULL);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    SDL_Texture *mTexture;
-
-    int mWidth;
-    int mHeight;
-};
-
 bool init();
 bool loadMedia();
 void close();
@@ -45,96 +18,7 @@ SDL_Renderer *gRenderer = NULL;
 LTexture gModulatedTexture;
 LTexture gBackgroundTexture;
 
-LTexture::LTexture()
-{
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-}
-
-LTexture::~LTexture()
-{
-    free();
-}
-
-bool LTexture::loadFromFile(std::string path)
-{
-    SDL_Texture *newTexture = NULL;
-    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Failed to load image" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-        newTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Texture could not be created!" << std::endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-
-        SDL_FreeSurface(loadedSurface);
-    }
-
-    mTexture = newTexture;
-    return mTexture != NULL;
-}
-
-void LTexture::free()
-{
-    if (mTexture != NULL)
-    {
-        SDL_DestroyTexture(mTexture);
-
-        mTexture = NULL;
-        mWidth = 0;
-        mHeight = 0;
-    }
-}
-
-void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
-{
-    SDL_SetTextureColorMod(mTexture, red, green, blue);
-}
-
-void LTexture::setBlendMode(SDL_BlendMode blending)
-{
-    SDL_SetTextureBlendMode(mTexture, blending);
-}
-
-void LTexture::setAlpha(Uint8 alpha)
-{
-    SDL_SetTextureAlphaMod(mTexture, alpha);
-}
-
-void LTexture::render(int x, int y, SDL_Rect *clip)
-{
-    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
-
-    if (clip != NULL)
-    {
-        renderQuad.w = clip->w;
-        renderQuad.h = clip->h;
-    }
-
-    SDL_RenderCopy(gRenderer, mTexture, clip, &renderQuad);
-}
-
-int LTexture::getWidth()
-{
-    return mWidth;
-}
-
-int LTexture::getHeight()
-{
-    return mHeight;
-}
+RenderQueue gRenderQueue;
 
 bool init()
 {
@@ -182,7 +66,12 @@ bool loadMedia()
 {
     bool success = true;
 
-    if (!gModulatedTexture.loadFromFile("./fadeout.png"))
+    // Premultiplied so the fade leaves no cyan fringe; the key-alpha bake cache
+    // saves redoing it on the next run.
+    KeyAlphaOptions keyAlpha;
+    keyAlpha.premultiply = true;
+
+    if (!gModulatedTexture.loadFromFile(gRenderer, "./fadeout.png", keyAlpha))
     {
         std::cout << "Failed to load front texture!" << std::endl;
         success = false;
@@ -192,7 +81,7 @@ bool loadMedia()
         gModulatedTexture.setBlendMode(SDL_BLENDMODE_BLEND);
     }
 
-    if (!gBackgroundTexture.loadFromFile("./fadein.png"))
+    if (!gBackgroundTexture.loadFromFile(gRenderer, "./fadein.png"))
     {
         std::cout << "Failed to load background texture" << std::endl;
         success = false;
@@ -203,6 +92,9 @@ bool loadMedia()
 
 void close()
 {
+    gModulatedTexture.free();
+    gBackgroundTexture.free();
+
     SDL_DestroyRenderer(gRenderer);
     SDL_DestroyWindow(gWindow);
 
@@ -230,7 +122,10 @@ int main(int argc, char const *argv[])
             bool quit = false;
 
             SDL_Event e;
-            Uint8 a;
+            Uint8 a = 255;
+
+            // Print the queue stats on the first frame and after each fade step
+            bool printStats = true;
 
             while (!quit)
             {
@@ -252,6 +147,7 @@ int main(int argc, char const *argv[])
                             {
                                 a += 32;
                             }
+                            printStats = true;
                         }
                         else if (e.key.keysym.sym == SDLK_s)
                         {
@@ -263,6 +159,7 @@ int main(int argc, char const *argv[])
                             {
                                 a -= 32;
                             }
+                            printStats = true;
                         }
                     }
                 }
@@ -270,9 +167,23 @@ int main(int argc, char const *argv[])
                 SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
                 SDL_RenderClear(gRenderer);
 
-                gBackgroundTexture.render(0, 0);
-                gModulatedTexture.setAlpha(a);
-                gModulatedTexture.render(0, 0);
+                gRenderQueue.setLayer(0);
+                gRenderQueue.setColor(0xFF, 0xFF, 0xFF);
+                gRenderQueue.copy(gBackgroundTexture, 0, 0);
+
+                gRenderQueue.setLayer(1);
+                gRenderQueue.setColor(0xFF, 0xFF, 0xFF, a);
+                gRenderQueue.copy(gModulatedTexture, 0, 0);
+
+                gRenderQueue.submit(gRenderer);
+
+                if (printStats)
+                {
+                    const RenderQueueStats &stats = gRenderQueue.getStats();
+                    std::cout << "Alpha " << (int)a << ": " << stats.commands << " commands, " << stats.drawCalls << " draw calls, "
+                              << stats.stateChanges << " state changes, " << stats.stateChangesAvoided << " avoided" << std::endl;
+                    printStats = false;
+                }
 
                 SDL_RenderPresent(gRenderer);
             }
@@ -2,38 +2,14 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include <string>
+#include "../common/animation.h"
+#include "../common/game_loop.h"
+#include "../common/ltexture.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-class LTexture
-{
-public:
-    LTexture();
-
-    ~LTexture();
-
-    bool loadFromFile(std::string path);
-
-    void free();
-
-    void setColor(Uint8 red, Uint8 green, Uint8 blue);
-
-    void setBlendMode(SDL_BlendMode blend_mode);
-
-    void setAlpha(Uint8 alpha);
-
-    void render(int x, int y, SDL_Rect *clip = NULL);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    SDL_Texture *mTexture;
-
-    int mWidth;
-    int mHeight;
-};
+const float WALK_SPEED = 120.0f;
 
 bool init();
 
@@ -45,105 +21,14 @@ SDL_Window *gWindow = NULL;
 
 SDL_Renderer *gRenderer = NULL;
 
-const int WALKING_ANIMATION_FRAMES = 4;
-SDL_Rect gSpriteClips[WALKING_ANIMATION_FRAMES];
+AnimationSet gAnimations;
+AnimationPool gAnimationPool(&gAnimations);
+int gWalker = -1;
+float gWalkerX = 0.0f;
+float gPreviousWalkerX = 0.0f;
+TextureCache gTextures;
 LTexture gSpriteSheetTextures;
 
-LTexture::LTexture()
-{
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-}
-
-LTexture::~LTexture()
-{
-    free();
-}
-
-void LTexture::free()
-{
-    if (mTexture != NULL)
-    {
-        SDL_DestroyTexture(mTexture);
-
-        mTexture = NULL;
-        mWidth = 0;
-        mHeight = 0;
-    }
-}
-
-bool LTexture::loadFromFile(std::string path)
-{
-    free();
-
-    SDL_Texture *newTexture = NULL;
-    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
-
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Unable to load sprite" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-
-        newTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Unable to create texture" << std::endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-
-        SDL_FreeSurface(loadedSurface);
-    }
-
-    mTexture = newTexture;
-    return mTexture != NULL;
-}
-
-void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
-{
-    SDL_SetTextureColorMod(mTexture, red, green, blue);
-}
-
-void LTexture::setBlendMode(SDL_BlendMode blend_mode)
-{
-    SDL_SetTextureBlendMode(mTexture, blend_mode);
-}
-
-void LTexture::setAlpha(Uint8 alpha)
-{
-    SDL_SetTextureAlphaMod(mTexture, alpha);
-}
-
-void LTexture::render(int x, int y, SDL_Rect *clip)
-{
-    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
-
-    if (clip != NULL)
-    {
-        renderQuad.w = clip->w;
-        renderQuad.h = clip->h;
-    }
-
-    SDL_RenderCopy(gRenderer, mTexture, clip, &renderQuad);
-}
-
-int LTexture::getWidth()
-{
-    return mWidth;
-}
-
-int LTexture::getHeight()
-{
-    return mHeight;
-}
-
 bool init()
 {
     bool success = true;
@@ -189,32 +74,24 @@ bool loadMedia()
 {
     bool success = true;
 
-    if (!gSpriteSheetTextures.loadFromFile("./foo.png"))
+    if (!gSpriteSheetTextures.loadFromCache(gTextures, gRenderer, "./foo.png"))
     {
         std::cout << "Failed to load sprite sheet" << std::endl;
         success = false;
     }
+    else if (!gAnimations.loadFromFile("./foo.anim"))
+    {
+        std::cout << "Failed to load animations" << std::endl;
+        success = false;
+    }
     else
     {
-        gSpriteClips[0].x = 0;
-        gSpriteClips[0].y = 0;
-        gSpriteClips[0].w = 64;
-        gSpriteClips[0].h = 205;
-
-        gSpriteClips[1].x = 64;
-        gSpriteClips[1].y = 0;
-        gSpriteClips[1].w = 64;
-        gSpriteClips[1].h = 205;
-
-        gSpriteClips[2].x = 128;
-        gSpriteClips[2].y = 0;
-        gSpriteClips[2].w = 64;
-        gSpriteClips[2].h = 205;
-
-        gSpriteClips[3].x = 192;
-        gSpriteClips[3].y = 0;
-        gSpriteClips[3].w = 64;
-        gSpriteClips[3].h = 205;
+        gWalker = gAnimationPool.spawn(gAnimations.findAnimation("walk"));
+        if (gWalker < 0)
+        {
+            std::cout << "Failed to find the walk animation" << std::endl;
+            success = false;
+        }
     }
     return success;
 }
@@ -222,6 +99,7 @@ bool loadMedia()
 void close()
 {
     gSpriteSheetTextures.free();
+    gTextures.clear();
 
     SDL_DestroyRenderer(gRenderer);
     SDL_DestroyWindow(gWindow);
@@ -247,37 +125,55 @@ int main(int argc, char const *argv[])
         }
         else
         {
-            bool quit = false;
-
             SDL_Event e;
 
-            int frame = 0;
+            GameLoop loop;
+            loop.setTimestep(1.0 / 60.0);
 
-            while (!quit)
-            {
-                while (SDL_PollEvent(&e) != 0)
+            loop.run(
+                [&]()
                 {
-                    if (e.type == SDL_QUIT)
+                    while (SDL_PollEvent(&e) != 0)
                     {
-                        quit = true;
+                        if (e.type == SDL_QUIT)
+                        {
+                            loop.quit();
+                        }
                     }
-                }
-
-                SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
-                SDL_RenderClear(gRenderer);
-
-                SDL_Rect *currentClip = &gSpriteClips[frame / 4];
-                gSpriteSheetTextures.render((SCREEN_WIDTH - currentClip->w) / 2, (SCREEN_HEIGHT - currentClip->h) / 2, currentClip);
+                },
+                [&](double dt)
+                {
+                    gAnimationPool.update(dt);
 
-                SDL_RenderPresent(gRenderer);
+                    gPreviousWalkerX = gWalkerX;
+                    gWalkerX += WALK_SPEED * (float)dt;
+                    if (gWalkerX > SCREEN_WIDTH)
+                    {
+                        // Wrap without sliding back across the screen
+                        gWalkerX = (float)-gAnimationPool.getClip(gWalker)->w;
+                        gPreviousWalkerX = gWalkerX;
+                    }
+                },
+                [&](double alpha)
+                {
+                    SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+                    SDL_RenderClear(gRenderer);
 
-                ++frame;
+                    // Draw between the last two updates so the walk stays smooth
+                    // when the frame rate and timestep differ
+                    float x = gPreviousWalkerX + (gWalkerX - gPreviousWalkerX) * (float)alpha;
 
-                if (frame / 4 >= WALKING_ANIMATION_FRAMES)
+                    const SDL_Rect *currentClip = gAnimationPool.getClip(gWalker);
+                    gSpriteSheetTextures.render((int)x, (SCREEN_HEIGHT - currentClip->h) / 2, currentClip);
+                },
+                [&]()
                 {
-                    frame = 0;
-                }
-            }
+                    SDL_RenderPresent(gRenderer);
+                });
+
+            FrameTimings timings = loop.getAverageTimings();
+            std::cout << "Average frame " << timings.frameMs << " ms (events " << timings.eventsMs << ", update " << timings.updateMs
+                      << ", render " << timings.renderMs << ", present " << timings.presentMs << ")" << std::endl;
         }
     }
 
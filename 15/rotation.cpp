@@ -2,37 +2,11 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include <string>
+#include "../common/ltexture.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-class LTexture
-{
-public:
-    LTexture();
-
-    ~LTexture();
-
-    bool loadFromFile(std::string path);
-
-    void free();
-
-    void setColor(Uint8 red, Uint8 green, Uint8 blue);
-    void setBlendMode(SDL_BlendMode blend_mode);
-    void setAlpha(Uint8 alpha);
-
-    void render(int x, int y, SDL_Rect *clip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    SDL_Texture *mTexture;
-
-    int mWidth;
-    int mHeight;
-};
-
 bool init();
 bool loadMedia();
 void close();
@@ -42,99 +16,6 @@ SDL_Renderer *gRenderer = NULL;
 
 LTexture gArrow;
 
-LTexture::LTexture()
-{
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-}
-
-LTexture::~LTexture()
-{
-    free();
-}
-
-bool LTexture::loadFromFile(std::string path)
-{
-    SDL_Texture *newTexture = NULL;
-    SDL_Surface *loadedSurface = IMG_Load("./arrow.png");
-
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Unable to load image" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-
-        newTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Texture could not be created" << std::endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-
-        SDL_FreeSurface(loadedSurface);
-    }
-
-    mTexture = newTexture;
-    return mTexture != NULL;
-}
-
-void LTexture::free()
-{
-    if (mTexture != NULL)
-    {
-        SDL_DestroyTexture(mTexture);
-        mTexture = NULL;
-
-        mWidth = 0;
-        mHeight = 0;
-    }
-}
-
-void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
-{
-    SDL_SetTextureColorMod(mTexture, red, green, blue);
-}
-
-void LTexture::setAlpha(Uint8 alpha)
-{
-    SDL_SetTextureAlphaMod(mTexture, alpha);
-}
-
-void LTexture::setBlendMode(SDL_BlendMode blend_mode)
-{
-    SDL_SetTextureBlendMode(mTexture, blend_mode);
-}
-
-void LTexture::render(int x, int y, SDL_Rect *clip, double angle, SDL_Point *center, SDL_RendererFlip flip)
-{
-    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
-
-    if (clip != NULL)
-    {
-        renderQuad.w = clip->w;
-        renderQuad.h = clip->h;
-    }
-
-    SDL_RenderCopyEx(gRenderer, mTexture, clip, &renderQuad, angle, center, flip);
-}
-
-int LTexture::getWidth()
-{
-    return mWidth;
-}
-
-int LTexture::getHeight()
-{
-    return mHeight;
-}
-
 bool init()
 {
     bool success = true;
@@ -181,7 +62,7 @@ bool loadMedia()
 {
     bool success = true;
 
-    if (!gArrow.loadFromFile("./arrow.png"))
+    if (!gArrow.loadFromFile(gRenderer, "./arrow.png"))
     {
         std::cout << "Image could not be loaded" << std::endl;
         success = false;
@@ -4,41 +4,12 @@
 #include <iostream>
 #include <string>
 #include <cmath>
+#include "../common/glyph_cache.h"
+#include "../common/ltexture.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-class LTexture
-{
-public:
-    LTexture();
-
-    ~LTexture();
-
-    bool loadFromFile(std::string path);
-
-    bool loadFromRenderedText(std::string textureText, SDL_Color textColor);
-
-    void free();
-
-    void setColor(Uint8 red, Uint8 green, Uint8 blue);
-
-    void setBlendMode(SDL_BlendMode blend_mode);
-
-    void setAlpha(Uint8 alpha);
-
-    void render(int x, int y, SDL_Rect *clip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    SDL_Texture *mTexture;
-
-    int mWidth;
-    int mHeight;
-};
-
 bool init();
 bool loadMedia();
 void close();
@@ -49,126 +20,8 @@ TTF_Font *gFont = NULL;
 
 LTexture gTextTexture;
 
-LTexture::LTexture()
-{
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-}
-
-LTexture::~LTexture()
-{
-    free();
-}
-
-bool LTexture::loadFromRenderedText(std::string textureText, SDL_Color textColor)
-{
-    free();
-
-    SDL_Surface *textSurface = TTF_RenderText_Solid(gFont, textureText.c_str(), textColor);
-    if (textSurface == NULL)
-    {
-        std::cout << "Unable to render text surface" << std::endl;
-    }
-    else
-    {
-        mTexture = SDL_CreateTextureFromSurface(gRenderer, textSurface);
-        if (mTexture == NULL)
-        {
-            std::cout << "Unable to create texture from renderer" << std::endl;
-        }
-        else
-        {
-            mWidth = textSurface->w;
-            mHeight = textSurface->h;
-        }
-
-        SDL_FreeSurface(textSurface);
-    }
-
-    return mTexture != NULL;
-}
-
-bool LTexture::loadFromFile(std::string path)
-{
-    SDL_Texture *newTexture = NULL;
-
-    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Unable to create surface" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-
-        newTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Unable to create texture from surface" << std::endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-
-        SDL_FreeSurface(loadedSurface);
-    }
-
-    mTexture = newTexture;
-    return mTexture != NULL;
-}
-
-void LTexture::free()
-{
-    if (mTexture != NULL)
-    {
-        SDL_DestroyTexture(mTexture);
-        mTexture = NULL;
-
-        mWidth = 0;
-        mHeight = 0;
-    }
-}
-
-void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
-{
-    SDL_SetTextureColorMod(mTexture, red, green, blue);
-}
-
-void LTexture::setBlendMode(SDL_BlendMode blend_mode)
-{
-    SDL_SetTextureBlendMode(mTexture, blend_mode);
-}
-
-void LTexture::setAlpha(Uint8 alpha)
-{
-    SDL_SetTextureAlphaMod(mTexture, alpha);
-}
-
-void LTexture::render(int x, int y, SDL_Rect *clip, double angle, SDL_Point *center, SDL_RendererFlip flip)
-{
-    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
-
-    if (clip != NULL)
-    {
-        renderQuad.w = clip->w;
-        renderQuad.h = clip->h;
-    }
-
-    SDL_RenderCopyEx(gRenderer, mTexture, clip, &renderQuad, angle, center, flip);
-}
-
-int LTexture::getWidth()
-{
-    return mWidth;
-}
-
-int LTexture::getHeight()
-{
-    return mHeight;
-}
+GlyphCache gHudGlyphs;
+TextLayout gFrameCounterText;
 
 bool init()
 {
@@ -232,18 +85,25 @@ bool loadMedia()
     else
     {
         SDL_Color textColor = {0, 0, 0};
-        if (!gTextTexture.loadFromRenderedText("The quick brown fox jumps over the lazy dog", textColor))
+        if (!gTextTexture.loadFromRenderedText(gRenderer, gFont, "The quick brown fox jumps over the lazy dog", textColor))
         {
             std::cout << "Failed to load text" << std::endl;
             success = false;
         }
     }
+
+    if (!gHudGlyphs.load(gRenderer, "./lazy.ttf", 20))
+    {
+        std::cout << "Failed to load HUD glyphs" << std::endl;
+        success = false;
+    }
     return success;
 }
 
 void close()
 {
     gTextTexture.free();
+    gHudGlyphs.free();
 
     TTF_CloseFont(gFont);
     gFont = NULL;
@@ -277,6 +137,9 @@ int main(int argc, char const *argv[])
 
             SDL_Event e;
 
+            SDL_Color hudColor = {0x80, 0x80, 0x80, 0xFF};
+            int frame = 0;
+
             while (!quit)
             {
                 while (SDL_PollEvent(&e) != 0)
@@ -292,7 +155,12 @@ int main(int argc, char const *argv[])
 
                 gTextTexture.render((SCREEN_WIDTH - gTextTexture.getWidth()) / 2, (SCREEN_HEIGHT - gTextTexture.getHeight()) / 2);
 
+                gFrameCounterText.setText(&gHudGlyphs, "Frame: " + std::to_string(frame), hudColor);
+                gFrameCounterText.render(gRenderer, 10, 10);
+
                 SDL_RenderPresent(gRenderer);
+
+                ++frame;
             }
         }
     }
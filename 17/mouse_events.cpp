@@ -2,6 +2,11 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include <string>
+#include "../common/event_dispatcher.h"
+#include "../common/hit_grid.h"
+#include "../common/input_log.h"
+#include "../common/profiler.h"
+#include "../common/texture_atlas.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
@@ -18,40 +23,17 @@ enum LButtonSprite
     BUTTON_SPRITE_TOTAL = 4
 };
 
-class LTexture
-{
-public:
-    LTexture();
-    ~LTexture();
-
-    bool loadFromFile(std::string path);
-
-    void free();
-
-    void setColor(Uint8 red, Uint8 green, Uint8 blue);
-    void setAlpha(Uint8 alpha);
-    void setBlendmode(SDL_BlendMode blend_mode);
-
-    void render(int x, int y, SDL_Rect *clip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    SDL_Texture *mTexture;
-
-    int mWidth;
-    int mHeight;
-};
-
 class Button
 {
 public:
     Button();
 
-    void handleEvent(SDL_Event *e);
+    // Only called while the pointer is over the button
+    void handleEvent(const SDL_Event &e);
+    void handleMouseLeave();
     void render();
     void setPosition(int x, int y);
+    SDL_Rect getBounds();
 
 private:
     SDL_Point position;
@@ -60,173 +42,72 @@ private:
 
 bool init();
 bool loadMedia();
+void handleMouseEvent(const SDL_Event &e);
+void handleWindowEvent(const SDL_Event &e);
 void close();
 
 SDL_Window *window = NULL;
 SDL_Renderer *renderer = NULL;
 
+InputRecorder recorder;
+InputReplayer replayer;
+bool headless = false;
+
 SDL_Rect spriteClips[BUTTON_SPRITE_TOTAL];
-LTexture buttonSprite;
+TextureAtlas atlas;
+AtlasSprite *buttonSprite = NULL;
 
 Button buttons[TOTAL_BUTTONS];
 
-LTexture::LTexture()
-{
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-}
-
-LTexture::~LTexture()
-{
-    free();
-}
-
-bool LTexture::loadFromFile(std::string path)
-{
-    free();
-
-    SDL_Texture *newTexture = NULL;
-    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Unable to load image from file" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-
-        newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Texture could not be created" << std::endl;
-        }
-        else
-        {
-            mWidth = loadedSurface->w;
-            mHeight = loadedSurface->h;
-        }
-        SDL_FreeSurface(loadedSurface);
-    }
-
-    mTexture = newTexture;
-    return mTexture != NULL;
-}
-
-void LTexture::free()
-{
-    if (mTexture != NULL)
-    {
-        SDL_DestroyTexture(mTexture);
-        mTexture = NULL;
-        mWidth = 0;
-        mHeight = 0;
-    }
-}
-
-void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
-{
-    SDL_SetTextureColorMod(mTexture, red, green, blue);
-}
+// Button ids in the grid are their indices in buttons.
+HitGrid hitGrid(SCREEN_WIDTH, SCREEN_HEIGHT);
 
-void LTexture::setAlpha(Uint8 alpha)
+Button::Button()
 {
-    SDL_SetTextureAlphaMod(mTexture, alpha);
-}
+    position.x = 0;
+    position.y = 0;
 
-void LTexture::setBlendmode(SDL_BlendMode blend_mode)
-{
-    SDL_SetTextureBlendMode(mTexture, blend_mode);
+    currentSprite = BUTTON_SPRITE_MOUSE_OUT;
 }
 
-void LTexture::render(int x, int y, SDL_Rect *clip, double angle, SDL_Point *center, SDL_RendererFlip flip)
+void Button::handleEvent(const SDL_Event &e)
 {
-    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
+    PROFILE_SCOPE("Button::handleEvent");
 
-    if (clip != NULL)
+    switch (e.type)
     {
-        renderQuad.w = clip->w;
-        renderQuad.h = clip->h;
+    case SDL_MOUSEMOTION:
+        currentSprite = BUTTON_SPRITE_MOUSE_OVER_MOTION;
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+        currentSprite = BUTTON_SPROTE_MOUSE_DOWN;
+        break;
+    case SDL_MOUSEBUTTONUP:
+        currentSprite = BUTTON_SPRITE_MOUSE_UP;
+        break;
     }
-
-    SDL_RenderCopyEx(renderer, mTexture, clip, &renderQuad, angle, center, flip);
-}
-
-int LTexture::getWidth()
-{
-    return mWidth;
 }
 
-int LTexture::getHeight()
-{
-    return mHeight;
-}
-
-Button::Button()
+void Button::handleMouseLeave()
 {
-    position.x = 0;
-    position.y = 0;
-
     currentSprite = BUTTON_SPRITE_MOUSE_OUT;
 }
 
-void Button::handleEvent(SDL_Event *e)
-{
-    if (e->type == SDL_MOUSEMOTION || e->type == SDL_MOUSEBUTTONDOWN || e->type == SDL_MOUSEBUTTONUP)
-    {
-        int x, y;
-        SDL_GetMouseState(&x, &y);
-
-        bool inside = true;
-
-        if (x < position.x)
-        {
-            inside = false;
-        }
-        else if (x > position.x + BUTTON_WIDTH)
-        {
-            inside = false;
-        }
-        else if (y < position.y)
-        {
-            inside = false;
-        }
-        else if (y > position.y + BUTTON_HEIGHT)
-        {
-            inside = false;
-        }
-
-        if (!inside)
-        {
-            currentSprite = BUTTON_SPRITE_MOUSE_OUT;
-        }
-        else
-        {
-            switch (e->type)
-            {
-            case SDL_MOUSEMOTION:
-                currentSprite = BUTTON_SPRITE_MOUSE_OVER_MOTION;
-                break;
-            case SDL_MOUSEBUTTONDOWN:
-                currentSprite = BUTTON_SPROTE_MOUSE_DOWN;
-                break;
-            case SDL_MOUSEBUTTONUP:
-                currentSprite = BUTTON_SPRITE_MOUSE_UP;
-                break;
-            }
-        }
-    }
-}
-
 void Button::setPosition(int x, int y)
 {
     position.x = x;
     position.y = y;
 }
 
+SDL_Rect Button::getBounds()
+{
+    SDL_Rect bounds = {position.x, position.y, BUTTON_WIDTH, BUTTON_HEIGHT};
+    return bounds;
+}
+
 void Button::render()
 {
-    buttonSprite.render(position.x, position.y, &spriteClips[currentSprite]);
+    buttonSprite->render(renderer, position.x, position.y, &spriteClips[currentSprite]);
 }
 
 bool init()
@@ -248,7 +129,7 @@ bool init()
         }
         else
         {
-            renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+            renderer = SDL_CreateRenderer(window, -1, headless ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED);
             if (renderer == NULL)
             {
                 std::cout << "Renderer could not be created" << std::endl;
@@ -274,13 +155,15 @@ bool loadMedia()
 {
     bool success = true;
 
-    if (!buttonSprite.loadFromFile("./button.png"))
+    if (!atlas.addImage("button", "./button.png") || !atlas.build(renderer))
     {
         std::cout << "Button sprite could not be loaded" << std::endl;
         success = false;
     }
     else
     {
+        buttonSprite = atlas.getSprite("button");
+
         for (int i = 0; i < BUTTON_SPRITE_TOTAL; ++i)
         {
             spriteClips[i].x = 0;
@@ -293,14 +176,60 @@ bool loadMedia()
         buttons[1].setPosition(SCREEN_WIDTH - BUTTON_WIDTH, 0);
         buttons[2].setPosition(0, SCREEN_HEIGHT - BUTTON_HEIGHT);
         buttons[3].setPosition(SCREEN_WIDTH - BUTTON_WIDTH, SCREEN_HEIGHT - BUTTON_HEIGHT);
+
+        for (int i = 0; i < TOTAL_BUTTONS; ++i)
+        {
+            hitGrid.add(buttons[i].getBounds());
+        }
     }
 
     return success;
 }
 
+void handleMouseEvent(const SDL_Event &e)
+{
+    // The event carries the position it happened at; the global mouse
+    // state may already have moved on.
+    int x, y;
+    if (e.type == SDL_MOUSEMOTION)
+    {
+        x = e.motion.x;
+        y = e.motion.y;
+    }
+    else
+    {
+        x = e.button.x;
+        y = e.button.y;
+    }
+
+    HoverChange change = hitGrid.updateHover(x, y);
+    if (change.left >= 0)
+    {
+        buttons[change.left].handleMouseLeave();
+    }
+
+    int hovered = hitGrid.getHovered();
+    if (hovered >= 0)
+    {
+        buttons[hovered].handleEvent(e);
+    }
+}
+
+void handleWindowEvent(const SDL_Event &e)
+{
+    if (e.window.event == SDL_WINDOWEVENT_LEAVE)
+    {
+        HoverChange change = hitGrid.clearHover();
+        if (change.left >= 0)
+        {
+            buttons[change.left].handleMouseLeave();
+        }
+    }
+}
+
 void close()
 {
-    buttonSprite.free();
+    atlas.free();
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -314,6 +243,17 @@ void close()
 
 int main(int argc, char const *argv[])
 {
+    std::string recordPath;
+    std::string replayPath;
+    parseInputLogArgs(argc, argv, &recordPath, &replayPath);
+
+    // Replays need no display or vsync, so they time the frame work alone.
+    headless = !replayPath.empty();
+    if (headless)
+    {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    }
+
     if (!init())
     {
         std::cout << "SDL could not initialized" << std::endl;
@@ -327,22 +267,29 @@ int main(int argc, char const *argv[])
         else
         {
             bool quit = false;
-            SDL_Event e;
+
+            EventDispatcher events;
+            events.subscribe(SDL_QUIT, [&](const SDL_Event &e) { quit = true; });
+            events.subscribe(SDL_MOUSEMOTION, handleMouseEvent);
+            events.subscribe(SDL_MOUSEBUTTONDOWN, handleMouseEvent);
+            events.subscribe(SDL_MOUSEBUTTONUP, handleMouseEvent);
+            events.subscribe(SDL_WINDOWEVENT, handleWindowEvent);
+
+            if (!replayPath.empty())
+            {
+                quit = !replayer.open(replayPath);
+                replayer.attach(events);
+            }
+            else if (!recordPath.empty() && recorder.open(recordPath))
+            {
+                recorder.attach(events);
+            }
 
             while (!quit)
             {
-                while (SDL_PollEvent(&e) != 0)
-                {
-                    if (e.type == SDL_QUIT)
-                    {
-                        quit = true;
-                    }
-
-                    for (int i = 0; i < TOTAL_BUTTONS; i++)
-                    {
-                        buttons[i].handleEvent(&e);
-                    }
-                }
+                PROFILE_FRAME();
+
+                events.dispatch();
 
                 SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
                 SDL_RenderClear(renderer);
@@ -352,8 +299,18 @@ int main(int argc, char const *argv[])
                     buttons[i].render();
                 }
 
-                SDL_RenderPresent(renderer);
+                PROFILE_OVERLAY(renderer, 0, 0, SCREEN_WIDTH);
+
+                {
+                    PROFILE_SCOPE("SDL_RenderPresent");
+                    SDL_RenderPresent(renderer);
+                }
             }
+
+            recorder.close();
+            replayer.report();
+
+            PROFILE_EXPORT("./profile.json");
         }
     }
 
@@ -2,35 +2,14 @@
 #include <SDL2/SDL_image.h>
 #include <iostream>
 #include <string>
+#include "../common/action_map.h"
+#include "../common/asset_pack.h"
+#include "../common/event_dispatcher.h"
+#include "../common/input_log.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-class Texture
-{
-public:
-    Texture();
-    ~Texture();
-
-    bool loadFromFile(std::string path);
-
-    void render(int x, int y, SDL_Rect *clip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
-
-    void free();
-
-    void setColor(Uint8 red, Uint8 green, Uint8 blue);
-    void setAlpha(Uint8 alpha);
-    void setBlendMode(SDL_BlendMode blend_mode);
-
-    int getWidth();
-    int getHeight();
-
-private:
-    SDL_Texture *texture = NULL;
-    int tWidth;
-    int tHeight;
-};
-
 bool init();
 bool loadMedia();
 void close();
@@ -38,110 +17,30 @@ void close();
 SDL_Window *window = NULL;
 SDL_Renderer *renderer = NULL;
 
-Texture pressTexture;
-Texture upTexture;
-Texture downTexture;
-Texture leftTexture;
-Texture rightTexture;
-
-Texture::Texture()
-{
-    texture = NULL;
-    tWidth = 0;
-    tHeight = 0;
-}
-
-Texture::~Texture()
-{
-    free();
-}
-
-bool Texture::loadFromFile(std::string path)
-{
-    free();
-
-    SDL_Texture *newTexture = NULL;
-    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Surface could not be created" << std::endl;
-    }
-    else
-    {
-        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-
-        newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-        if (newTexture == NULL)
-        {
-            std::cout << "Texture could not be created" << std::endl;
-        }
-        else
-        {
-            tWidth = loadedSurface->w;
-            tHeight = loadedSurface->h;
-        }
+InputRecorder recorder;
+InputReplayer replayer;
+bool headless = false;
 
-        SDL_FreeSurface(loadedSurface);
-    }
+AssetPack arrowPack;
 
-    texture = newTexture;
-    return texture != NULL;
-}
+AtlasSprite *pressSprite = NULL;
+AtlasSprite *upSprite = NULL;
+AtlasSprite *downSprite = NULL;
+AtlasSprite *leftSprite = NULL;
+AtlasSprite *rightSprite = NULL;
 
-void Texture::render(int x, int y, SDL_Rect *clip, double angle, SDL_Point *center, SDL_RendererFlip flip)
-{
-    SDL_Rect renderQuad = {x, y, tWidth, tHeight};
-
-    if (clip != NULL)
-    {
-        renderQuad.w = clip->w;
-        renderQuad.h = clip->h;
-    }
-
-    SDL_RenderCopyEx(renderer, texture, clip, &renderQuad, angle, center, flip);
-}
-
-void Texture::setColor(Uint8 red, Uint8 green, Uint8 blue)
-{
-    SDL_SetTextureColorMod(texture, red, green, blue);
-}
-
-void Texture::setAlpha(Uint8 alpha)
-{
-    SDL_SetTextureAlphaMod(texture, alpha);
-}
-
-void Texture::setBlendMode(SDL_BlendMode blend_mode)
-{
-    SDL_SetTextureBlendMode(texture, blend_mode);
-}
-
-void Texture::free()
-{
-    if (texture != NULL)
-    {
-        SDL_DestroyTexture(texture);
-        texture = NULL;
-        tWidth = 0;
-        tHeight = 0;
-    }
-}
-
-int Texture::getWidth()
-{
-    return tWidth;
-}
-
-int Texture::getHeight()
-{
-    return tHeight;
-}
+ActionMap actions;
+int upAction = -1;
+int downAction = -1;
+int leftAction = -1;
+int rightAction = -1;
+int quitAction = -1;
 
 bool init()
 {
     bool success = true;
 
-    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) < 0)
     {
         std::cout << "SDL could not initialized" << std::endl;
         success = false;
@@ -156,7 +55,7 @@ bool init()
         }
         else
         {
-            renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+            renderer = SDL_CreateRenderer(window, -1, headless ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED);
             if (renderer == NULL)
             {
                 std::cout << "Renderer could not be created" << std::endl;
@@ -183,34 +82,40 @@ bool loadMedia()
 {
     bool success = true;
 
-    if (!pressTexture.loadFromFile("./press.png"))
+    // Pre-decoded, pre-keyed pages built by tools/asset_packer from
+    // arrows.manifest; one mapped read and one upload per page.
+    if (!arrowPack.open("./arrows.pack") || !arrowPack.upload(renderer))
     {
-        std::cout << "Unable to load press image" << std::endl;
+        std::cout << "Unable to load the arrow pack! Run make packs first." << std::endl;
         success = false;
     }
-
-    if (!upTexture.loadFromFile("./up.png"))
+    else
     {
-        std::cout << "Unable to load up image" << std::endl;
-        success = false;
-    }
+        pressSprite = arrowPack.getSprite("press");
+        upSprite = arrowPack.getSprite("up");
+        downSprite = arrowPack.getSprite("down");
+        leftSprite = arrowPack.getSprite("left");
+        rightSprite = arrowPack.getSprite("right");
 
-    if (!downTexture.loadFromFile("./down.png"))
-    {
-        std::cout << "Unable to load down image" << std::endl;
-        success = false;
+        if (pressSprite == NULL || upSprite == NULL || downSprite == NULL || leftSprite == NULL || rightSprite == NULL)
+        {
+            std::cout << "Arrow pack is missing sprites" << std::endl;
+            success = false;
+        }
     }
 
-    if (!leftTexture.loadFromFile("./left.png"))
+    if (!actions.loadFromFile("./controls.cfg"))
     {
-        std::cout << "Unable to load left image" << std::endl;
+        std::cout << "Unable to load controls" << std::endl;
         success = false;
     }
-
-    if (!rightTexture.loadFromFile("./right.png"))
+    else
     {
-        std::cout << "Unable to load right image" << std::endl;
-        success = false;
+        upAction = actions.addAction("up");
+        downAction = actions.addAction("down");
+        leftAction = actions.addAction("left");
+        rightAction = actions.addAction("right");
+        quitAction = actions.addAction("quit");
     }
 
     return success;
@@ -218,11 +123,7 @@ bool loadMedia()
 
 void close()
 {
-    pressTexture.free();
-    upTexture.free();
-    downTexture.free();
-    rightTexture.free();
-    leftTexture.free();
+    arrowPack.free();
 
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
@@ -236,6 +137,17 @@ void close()
 
 int main(int argc, char const *argv[])
 {
+    std::string recordPath;
+    std::string replayPath;
+    parseInputLogArgs(argc, argv, &recordPath, &replayPath);
+
+    // Replays need no display or vsync, so they time the frame work alone.
+    headless = !replayPath.empty();
+    if (headless)
+    {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    }
+
     if (!init())
     {
         std::cout << "SDL could not initialized" << std::endl;
@@ -249,52 +161,63 @@ int main(int argc, char const *argv[])
         else
         {
             bool quit = false;
-            SDL_Event e;
-            Texture *currentTexture = NULL;
+            AtlasSprite *currentSprite = NULL;
+
+            EventDispatcher events;
+            events.subscribe(SDL_QUIT, [&](const SDL_Event &e) { quit = true; });
+            actions.subscribe(events);
+
+            if (!replayPath.empty())
+            {
+                quit = !replayer.open(replayPath);
+                replayer.attach(events);
+            }
+            else if (!recordPath.empty() && recorder.open(recordPath))
+            {
+                recorder.attach(events);
+            }
 
             while (!quit)
             {
-                while (SDL_PollEvent(&e) != 0)
+                actions.newFrame();
+                events.dispatch();
+
+                if (actions.isPressed(quitAction))
                 {
-                    if (e.type == SDL_QUIT)
-                    {
-                        quit = true;
-                    }
+                    quit = true;
                 }
 
-                const Uint8 *currentKeyStates = SDL_GetKeyboardState(NULL);
-                if (currentKeyStates[SDL_SCANCODE_UP])
+                if (actions.isHeld(upAction))
                 {
-                    currentTexture = &upTexture;
+                    currentSprite = upSprite;
                 }
-
-                else if (currentKeyStates[SDL_SCANCODE_DOWN])
+                else if (actions.isHeld(downAction))
                 {
-                    currentTexture = &downTexture;
+                    currentSprite = downSprite;
                 }
-
-                else if (currentKeyStates[SDL_SCANCODE_RIGHT])
+                else if (actions.isHeld(rightAction))
                 {
-                    currentTexture = &rightTexture;
+                    currentSprite = rightSprite;
                 }
-
-                else if (currentKeyStates[SDL_SCANCODE_LEFT])
+                else if (actions.isHeld(leftAction))
                 {
-                    currentTexture = &leftTexture;
+                    currentSprite = leftSprite;
                 }
-
                 else
                 {
-                    currentTexture = &pressTexture;
+                    currentSprite = pressSprite;
                 }
 
                 SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
                 SDL_RenderClear(renderer);
 
-                currentTexture->render(0, 0);
+                currentSprite->render(renderer, 0, 0);
 
                 SDL_RenderPresent(renderer);
             }
+
+            recorder.close();
+            replayer.report();
         }
     }
 
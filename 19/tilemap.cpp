@@ -0,0 +1,213 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../common/camera.h"
+#include "../common/ltexture.h"
+#include "../common/tilemap.h"
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+
+// A million tiles: dots from the sheet drawn at 32 pixels each.
+const int MAP_SIZE = 1000;
+const int TILE_SIZE = 32;
+const int DOT_SIZE = 100;
+const Uint16 BLINKING_DOT = 5;
+
+// World pixels per second at zoom 1
+const float PAN_SPEED = 600.0f;
+const float ZOOM_STEP = 1.1f;
+
+// Keeps the visible chunks to a few dozen per layer
+const float MIN_ZOOM = 0.25f;
+const float MAX_ZOOM = 4.0f;
+
+bool init();
+bool loadMedia();
+void generateMap();
+void close();
+
+SDL_Window *gWindow = NULL;
+SDL_Renderer *gRenderer = NULL;
+
+LTexture gDotsTexture;
+Tilemap gMap;
+Camera gCamera;
+
+bool init()
+{
+    bool success = true;
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cout << "SDL could not initialized!" << std::endl;
+        success = false;
+    }
+    else
+    {
+        gWindow = SDL_CreateWindow("SDL", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+        if (gWindow == NULL)
+        {
+            std::cout << "Window could not be created!" << std::endl;
+            success = false;
+        }
+        else
+        {
+            gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED);
+            if (gRenderer == NULL)
+            {
+                std::cout << "Renderer could not be created!" << std::endl;
+                success = false;
+            }
+            else
+            {
+                SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+
+                int imgFlags = IMG_INIT_PNG;
+                if (!(IMG_Init(imgFlags) & imgFlags))
+                {
+                    std::cout << "Image could not initialized!" << std::endl;
+                    success = false;
+                }
+            }
+        }
+    }
+    return success;
+}
+
+// Ground of dot bands on layer 0, blinking dots scattered on layer 1. Long
+// runs of equal tiles keep the saved map small.
+void generateMap()
+{
+    gMap.create(MAP_SIZE, MAP_SIZE, 2);
+
+    std::vector<Uint16> blink;
+    blink.push_back(1);
+    blink.push_back(2);
+    blink.push_back(4);
+    blink.push_back(3);
+    gMap.setAnimation(BLINKING_DOT, blink, 250);
+
+    for (int y = 0; y < MAP_SIZE; ++y)
+    {
+        for (int x = 0; x < MAP_SIZE; ++x)
+        {
+            if ((x / 4 + y / 4) % 3 != 0)
+            {
+                gMap.setTile(0, x, y, (Uint16)((x / 12 + y / 12) % 4 + 1));
+            }
+
+            if (((Uint32)x * 73856093u ^ (Uint32)y * 19349663u) % 199 == 0)
+            {
+                gMap.setTile(1, x, y, BLINKING_DOT);
+            }
+        }
+    }
+}
+
+bool loadMedia()
+{
+    bool success = true;
+
+    if (!gDotsTexture.loadFromFile(gRenderer, "./dots.png"))
+    {
+        std::cout << "Failed to load tileset!" << std::endl;
+        success = false;
+    }
+    else
+    {
+        // The map is generated once and read back on later runs.
+        if (!gMap.loadFromFile("./world.map"))
+        {
+            std::cout << "Generating world.map" << std::endl;
+            generateMap();
+            gMap.saveToFile("./world.map");
+        }
+
+        gMap.setTileset(gDotsTexture.getTexture(), DOT_SIZE, DOT_SIZE, TILE_SIZE);
+    }
+
+    return success;
+}
+
+void close()
+{
+    gMap.free();
+    gDotsTexture.free();
+
+    SDL_DestroyRenderer(gRenderer);
+    SDL_DestroyWindow(gWindow);
+
+    gRenderer = NULL;
+    gWindow = NULL;
+
+    IMG_Quit();
+    SDL_Quit();
+}
+
+int main(int argc, char const *argv[])
+{
+    if (!init())
+    {
+        std::cout << "SDL could not initialized!" << std::endl;
+    }
+    else
+    {
+        if (!loadMedia())
+        {
+            std::cout << "Unable to load media" << std::endl;
+        }
+        else
+        {
+            bool quit = false;
+
+            SDL_Event e;
+
+            gCamera.setViewSize(SCREEN_WIDTH, SCREEN_HEIGHT);
+            gCamera.setPosition(SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f);
+
+            Uint32 lastTicks = SDL_GetTicks();
+
+            while (!quit)
+            {
+                while (SDL_PollEvent(&e) != 0)
+                {
+                    if (e.type == SDL_QUIT)
+                    {
+                        quit = true;
+                    }
+                    else if (e.type == SDL_MOUSEWHEEL)
+                    {
+                        float zoom = gCamera.getZoom() * powf(ZOOM_STEP, (float)e.wheel.y);
+                        gCamera.setZoom(SDL_min(SDL_max(zoom, MIN_ZOOM), MAX_ZOOM));
+                    }
+
+                    gMap.handleEvent(e);
+                }
+
+                Uint32 ticks = SDL_GetTicks();
+                float step = PAN_SPEED * (ticks - lastTicks) / 1000.0f / gCamera.getZoom();
+                lastTicks = ticks;
+
+                // Arrow keys pan the camera
+                const Uint8 *keys = SDL_GetKeyboardState(NULL);
+                gCamera.move((keys[SDL_SCANCODE_RIGHT] - keys[SDL_SCANCODE_LEFT]) * step,
+                             (keys[SDL_SCANCODE_DOWN] - keys[SDL_SCANCODE_UP]) * step);
+
+                SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+                SDL_RenderClear(gRenderer);
+
+                gMap.render(gRenderer, gCamera, ticks);
+
+                SDL_RenderPresent(gRenderer);
+            }
+        }
+    }
+
+    close();
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include "../common/animation.h"
+#include "../common/camera.h"
+#include "../common/spatial_hash.h"
+#include "../common/texture_atlas.h"
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+
+// The dots are scattered over a world sixteen screens across each way.
+const int WORLD_WIDTH = SCREEN_WIDTH * 16;
+const int WORLD_HEIGHT = SCREEN_HEIGHT * 16;
+const int DOT_COUNT = 20000;
+
+// World pixels per second at zoom 1
+const float PAN_SPEED = 600.0f;
+const float ZOOM_STEP = 1.1f;
+
+bool init();
+bool loadMedia();
+void addDot(int x, int y, int frame);
+void populateWorld();
+void close();
+
+SDL_Window *gWindow = NULL;
+SDL_Renderer *gRenderer = NULL;
+
+// The four dots of lesson 11's sheet
+AnimationSet gSpriteSheet;
+TextureAtlas gAtlas;
+AtlasSprite *gDotsSprite = NULL;
+
+// Only dots the hash returns for the camera's view are ever rendered.
+Camera gCamera;
+SpatialHash gDotHash;
+std::vector<int> gDotFrames;
+std::vector<int> gVisibleDots;
+
+bool init()
+{
+    bool success = true;
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cout << "SDL could not initialized!" << std::endl;
+        success = false;
+    }
+    else
+    {
+        gWindow = SDL_CreateWindow("SDL", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+        if (gWindow == NULL)
+        {
+            std::cout << "Window could not be created!" << std::endl;
+            success = false;
+        }
+        else
+        {
+            gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED);
+            if (gRenderer == NULL)
+            {
+                std::cout << "Renderer could not be created!" << std::endl;
+                success = false;
+            }
+            else
+            {
+                SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+
+                int imgFlags = IMG_INIT_PNG;
+                if (!(IMG_Init(imgFlags) & imgFlags))
+                {
+                    std::cout << "Image could not initialized!" << std::endl;
+                    success = false;
+                }
+            }
+        }
+    }
+    return success;
+}
+
+bool loadMedia()
+{
+    bool success = true;
+
+    if (!gAtlas.addImage("dots", "./dots.png") || !gAtlas.build(gRenderer))
+    {
+        std::cout << "Failed to load sprite sheet!" << std::endl;
+        success = false;
+    }
+    else
+    {
+        gDotsSprite = gAtlas.getSprite("dots");
+        gSpriteSheet.addGrid(100, 100, 2, 2);
+    }
+
+    return success;
+}
+
+void addDot(int x, int y, int frame)
+{
+    SDL_Rect bounds = {x, y, gSpriteSheet.getFrame(frame).w, gSpriteSheet.getFrame(frame).h};
+    int id = gDotHash.add(bounds);
+    if (id >= (int)gDotFrames.size())
+    {
+        gDotFrames.resize(id + 1);
+    }
+    gDotFrames[id] = frame;
+}
+
+void populateWorld()
+{
+    for (int i = 0; i < DOT_COUNT; ++i)
+    {
+        addDot(rand() % WORLD_WIDTH, rand() % WORLD_HEIGHT, rand() % 4);
+    }
+
+    gCamera.setViewSize(SCREEN_WIDTH, SCREEN_HEIGHT);
+    gCamera.setPosition(SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f);
+}
+
+void close()
+{
+    gAtlas.free();
+
+    SDL_DestroyRenderer(gRenderer);
+    SDL_DestroyWindow(gWindow);
+
+    gRenderer = NULL;
+    gWindow = NULL;
+
+    IMG_Quit();
+    SDL_Quit();
+}
+
+int main(int argc, char const *argv[])
+{
+    if (!init())
+    {
+        std::cout << "SDL could not initialized!" << std::endl;
+    }
+    else
+    {
+        if (!loadMedia())
+        {
+            std::cout << "Unable to load media" << std::endl;
+        }
+        else
+        {
+            bool quit = false;
+
+            SDL_Event e;
+
+            populateWorld();
+
+            Uint32 lastTicks = SDL_GetTicks();
+
+            while (!quit)
+            {
+                while (SDL_PollEvent(&e) != 0)
+                {
+                    if (e.type == SDL_QUIT)
+                    {
+                        quit = true;
+                    }
+                    else if (e.type == SDL_MOUSEWHEEL)
+                    {
+                        gCamera.setZoom(gCamera.getZoom() * powf(ZOOM_STEP, (float)e.wheel.y));
+                    }
+                }
+
+                Uint32 ticks = SDL_GetTicks();
+                float step = PAN_SPEED * (ticks - lastTicks) / 1000.0f / gCamera.getZoom();
+                lastTicks = ticks;
+
+                // Arrow keys pan the camera
+                const Uint8 *keys = SDL_GetKeyboardState(NULL);
+                gCamera.move((keys[SDL_SCANCODE_RIGHT] - keys[SDL_SCANCODE_LEFT]) * step,
+                             (keys[SDL_SCANCODE_DOWN] - keys[SDL_SCANCODE_UP]) * step);
+
+                SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+                SDL_RenderClear(gRenderer);
+
+                gDotHash.query(gCamera.getVisibleBounds(), gVisibleDots);
+                for (size_t i = 0; i < gVisibleDots.size(); ++i)
+                {
+                    int id = gVisibleDots[i];
+                    gDotsSprite->render(gRenderer, gCamera.worldToScreen(gDotHash.getBounds(id)), &gSpriteSheet.getFrame(gDotFrames[id]));
+                }
+
+                SDL_RenderPresent(gRenderer);
+            }
+        }
+    }
+
+    close();
+
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include "SDL2/SDL.h"
 #include <string>
 #include <iostream>
+#include "../common/asset_pack.h"
+#include "../common/soft_blit.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
@@ -18,11 +20,12 @@ enum KeyPressSurfaces
 bool init();
 bool loadMedia();
 void close();
-SDL_Surface *loadSurface(std::string path);
+SDL_Surface *loadSurface(std::string name);
 SDL_Window *gWindow = NULL;
 SDL_Surface *gScreenSurface = NULL;
 SDL_Surface *gKeyPressSurfaces[KEY_PRESS_SURFACE_TOTAL];
 SDL_Surface *gCurrentSurface = NULL;
+AssetPack gArrowPack;
 
 bool init()
 {
@@ -55,35 +58,41 @@ bool loadMedia()
 {
     bool success = true;
 
-    gKeyPressSurfaces[KEY_PRESS_SURFACE_DEFAULT] = loadSurface("./press.bmp");
+    if (!gArrowPack.open("./arrows.pack"))
+    {
+        std::cout << "Failed to open the arrow pack! Run make packs first." << std::endl;
+        return false;
+    }
+
+    gKeyPressSurfaces[KEY_PRESS_SURFACE_DEFAULT] = loadSurface("press");
     if (gKeyPressSurfaces[KEY_PRESS_SURFACE_DEFAULT] == NULL)
     {
         std::cout << "Failed to load default image!" << std::endl;
         success = false;
     }
 
-    gKeyPressSurfaces[KEY_PRESS_SURFACE_UP] = loadSurface("./up.bmp");
+    gKeyPressSurfaces[KEY_PRESS_SURFACE_UP] = loadSurface("up");
     if (gKeyPressSurfaces[KEY_PRESS_SURFACE_UP] == NULL)
     {
         std::cout << "Failed to load up image!" << std::endl;
         success = false;
     }
 
-    gKeyPressSurfaces[KEY_PRESS_SURFACE_DOWN] = loadSurface("./down.bmp");
+    gKeyPressSurfaces[KEY_PRESS_SURFACE_DOWN] = loadSurface("down");
     if (gKeyPressSurfaces[KEY_PRESS_SURFACE_DOWN] == NULL)
     {
         std::cout << "Failed to load down image!" << std::endl;
         success = false;
     }
 
-    gKeyPressSurfaces[KEY_PRESS_SURFACE_LEFT] = loadSurface("./left.bmp");
+    gKeyPressSurfaces[KEY_PRESS_SURFACE_LEFT] = loadSurface("left");
     if (gKeyPressSurfaces[KEY_PRESS_SURFACE_LEFT] == NULL)
     {
         std::cout << "Failed to load left image!" << std::endl;
         success = false;
     }
 
-    gKeyPressSurfaces[KEY_PRESS_SURFACE_RIGHT] = loadSurface("./right.bmp");
+    gKeyPressSurfaces[KEY_PRESS_SURFACE_RIGHT] = loadSurface("right");
     if (gKeyPressSurfaces[KEY_PRESS_SURFACE_RIGHT] == NULL)
     {
         std::cout << "Failed to load right image!" << std::endl;
@@ -97,9 +106,10 @@ void close()
 {
     for (int i = 0; i < KEY_PRESS_SURFACE_TOTAL; i++)
     {
-        SDL_FreeSurface(gScreenSurface);
+        SDL_FreeSurface(gKeyPressSurfaces[i]);
         gKeyPressSurfaces[i] = NULL;
     }
+    gArrowPack.free();
 
     SDL_DestroyWindow(gWindow);
     gWindow = NULL;
@@ -107,27 +117,17 @@ void close()
     SDL_Quit();
 }
 
-SDL_Surface *loadSurface(std::string path)
+SDL_Surface *loadSurface(std::string name)
 {
-    SDL_Surface *optimizedSurface = NULL;
-    SDL_Surface *loadedSurface = SDL_LoadBMP(path.c_str());
-
-    if (loadedSurface == NULL)
-    {
-        std::cout << "Image could not initialized!" << std::endl;
-    }
-    else
+    // The pack holds pre-decoded 32-bit pixels, so the surface is a view into
+    // the mapped file with nothing left to decode or convert.
+    SDL_Surface *surface = gArrowPack.createSurface(name);
+    if (surface == NULL)
     {
-        optimizedSurface = SDL_ConvertSurface(loadedSurface, gScreenSurface->format, 0);
-        if (optimizedSurface == NULL)
-        {
-            std::cout << "Unable to optimize image " << path.c_str() << "! SDL error: " << SDL_GetError() << std::endl;
-        }
-
-        SDL_FreeSurface(loadedSurface);
+        std::cout << "Image " << name << " is missing from the arrow pack!" << std::endl;
     }
 
-    return optimizedSurface;
+    return surface;
 }
 
 int main(int argc, char const *argv[])
@@ -180,7 +180,7 @@ int main(int argc, char const *argv[])
                         }
                     }
                 }
-                SDL_BlitSurface(gCurrentSurface, NULL, gScreenSurface, NULL);
+                softBlitSurface(gCurrentSurface, NULL, gScreenSurface, NULL);
 
                 SDL_UpdateWindowSurface(gWindow);
             }
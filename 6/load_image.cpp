@@ -3,9 +3,12 @@
 #include <stdio.h>
 #include <string>
 #include <iostream>
+#include "../common/dirty_rects.h"
+#include "../common/soft_blit.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
+const int IDLE_WAIT_MS = 100;
 
 bool init();
 bool loadMedia();
@@ -16,6 +19,8 @@ SDL_Window *gWindow = NULL;
 SDL_Surface *gScreenSurface = NULL;
 SDL_Surface *gPNGSurface = NULL;
 
+DirtyRects gDirty(SCREEN_WIDTH, SCREEN_HEIGHT);
+
 bool init()
 {
     bool success = true;
@@ -61,7 +66,7 @@ SDL_Surface *loadSurface(std::string path)
     }
     else
     {
-        optimizedSurface = SDL_ConvertSurface(loadedSurface, gScreenSurface->format, 0);
+        optimizedSurface = softConvertSurface(loadedSurface, gScreenSurface->format->format);
         if (optimizedSurface == NULL)
         {
             std::cout << "Screen could not optimized!" << std::endl;
@@ -116,6 +121,8 @@ int main(int argc, char const *argv[])
 
             SDL_Event e;
 
+            gDirty.addAll();
+
             while (!quit)
             {
                 while (SDL_PollEvent(&e) != 0)
@@ -124,10 +131,29 @@ int main(int argc, char const *argv[])
                     {
                         quit = true;
                     }
+                    else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_EXPOSED)
+                    {
+                        gDirty.addAll();
+                    }
+                }
+
+                // The image never changes, so only exposed parts are blitted
+                // and pushed to the screen.
+                if (gDirty.isEmpty())
+                {
+                    SDL_WaitEventTimeout(NULL, IDLE_WAIT_MS);
+                    continue;
+                }
+
+                const std::vector<SDL_Rect> &rects = gDirty.getRects();
+                for (size_t i = 0; i < rects.size(); ++i)
+                {
+                    SDL_Rect region = rects[i];
+                    softBlitSurface(gPNGSurface, &rects[i], gScreenSurface, &region);
                 }
-                SDL_BlitSurface(gPNGSurface, NULL, gScreenSurface, NULL);
 
-                SDL_UpdateWindowSurface(gWindow);
+                updateWindowSurfaceRects(gWindow, gDirty);
+                gDirty.clear();
             }
         }
     }
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <string>
 #include <cmath>
+#include "../common/event_dispatcher.h"
+#include "../common/primitive_batch.h"
+#include "../common/vector_shapes.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
@@ -113,38 +116,77 @@ int main(int argc, char const *argv[])
         {
             bool quit = false;
 
-            SDL_Event e;
+            EventDispatcher events;
+            events.subscribe(SDL_QUIT, [&](const SDL_Event &e) { quit = true; });
+
+            PrimitiveBatch primitives;
+
+            // Vector shapes over the primitives: a rounded panel, a ring with
+            // a thick arc on it and a curve through the middle. They never
+            // change, so they are tessellated on the first frame only.
+            VectorRenderer vectors;
+
+            VectorPath panel;
+            SDL_FRect panelRect = {20.0f, 20.0f, 160.0f, 90.0f};
+            panel.roundedRect(panelRect, 16.0f);
+            VectorStyle panelStyle;
+            panelStyle.fill = {0x30, 0x30, 0x40, 0xC0};
+            panelStyle.stroke = {0x00, 0x00, 0x00, 0xFF};
+            panelStyle.strokeWidth = 2.0f;
+
+            VectorPath ring;
+            ring.circle(SCREEN_WIDTH - 80.0f, 80.0f, 50.0f);
+            VectorStyle ringStyle;
+            ringStyle.fill = {0xFF, 0xFF, 0xFF, 0xFF};
+            ringStyle.stroke = {0x80, 0x80, 0x80, 0xFF};
+            ringStyle.strokeWidth = 1.5f;
+
+            VectorPath arc;
+            arc.arc(SCREEN_WIDTH - 80.0f, 80.0f, 40.0f, -(float)M_PI / 2.0f, (float)M_PI);
+            VectorStyle arcStyle;
+            arcStyle.stroke = {0xFF, 0x80, 0x00, 0xFF};
+            arcStyle.strokeWidth = 10.0f;
+
+            VectorPath curve;
+            curve.moveTo(40.0f, SCREEN_HEIGHT - 60.0f);
+            curve.cubicTo(SCREEN_WIDTH / 3.0f, SCREEN_HEIGHT - 200.0f, SCREEN_WIDTH * 2 / 3.0f, SCREEN_HEIGHT + 80.0f, SCREEN_WIDTH - 40.0f, SCREEN_HEIGHT - 60.0f);
+            VectorStyle curveStyle;
+            curveStyle.stroke = {0x80, 0x00, 0xC0, 0xFF};
+            curveStyle.strokeWidth = 4.0f;
 
             while (!quit)
             {
-                if (SDL_PollEvent(&e) != 0)
-                {
-                    if (e.type == SDL_QUIT)
-                    {
-                        quit = true;
-                    }
-                }
+                events.dispatch();
 
                 SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
                 SDL_RenderClear(gRenderer);
 
-                SDL_Rect fillRect = {SCREEN_WIDTH / 4, SCREEN_HEIGHT / 4, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2};
-                SDL_SetRenderDrawColor(gRenderer, 0xFF, 0x00, 0x00, 0xFF);
-                SDL_RenderFillRect(gRenderer, &fillRect);
+                // Shapes draw in the order given; the dots go out last.
+                SDL_FRect fillRect = {SCREEN_WIDTH / 4.0f, SCREEN_HEIGHT / 4.0f, SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f};
+                primitives.setColor(0xFF, 0x00, 0x00);
+                primitives.fillRect(fillRect);
 
-                SDL_Rect outlineRect = {SCREEN_WIDTH / 6, SCREEN_HEIGHT / 6, SCREEN_WIDTH * 2 / 3, SCREEN_HEIGHT * 2 / 3};
-                SDL_SetRenderDrawColor(gRenderer, 0x00, 0xFF, 0x00, 0xFF);
-                SDL_RenderDrawRect(gRenderer, &outlineRect);
+                SDL_FRect outlineRect = {SCREEN_WIDTH / 6.0f, SCREEN_HEIGHT / 6.0f, SCREEN_WIDTH * 2 / 3.0f, SCREEN_HEIGHT * 2 / 3.0f};
+                primitives.setColor(0x00, 0xFF, 0x00);
+                primitives.drawRect(outlineRect);
 
-                SDL_SetRenderDrawColor(gRenderer, 0x00, 0x00, 0xFF, 0xFF);
-                SDL_RenderDrawLine(gRenderer, 0, SCREEN_HEIGHT / 2, SCREEN_WIDTH, SCREEN_HEIGHT / 2);
+                primitives.setColor(0x00, 0x00, 0xFF);
+                primitives.line(0, SCREEN_HEIGHT / 2, SCREEN_WIDTH, SCREEN_HEIGHT / 2);
 
-                SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0x00, 0xFF);
+                primitives.setColor(0xFF, 0xFF, 0x00);
                 for (int i = 0; i < SCREEN_HEIGHT; i += 4)
                 {
-                    SDL_RenderDrawPoint(gRenderer, SCREEN_WIDTH / 2, i);
+                    primitives.point(SCREEN_WIDTH / 2, i);
                 }
 
+                primitives.flush(gRenderer);
+
+                vectors.draw(panel, panelStyle);
+                vectors.draw(ring, ringStyle);
+                vectors.draw(arc, arcStyle);
+                vectors.draw(curve, curveStyle);
+                vectors.flush(gRenderer);
+
                 SDL_RenderPresent(gRenderer);
             }
         }
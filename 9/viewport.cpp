@@ -2,12 +2,19 @@
 #include "SDL2/SDL_image.h"
 #include <string>
 #include <iostream>
+#include "../common/dirty_rects.h"
+#include "../common/view_renderer.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
+const int IDLE_WAIT_MS = 100;
+const float PAN_STEP = 16.0f;
 
 bool init();
 bool loadMedia();
+void setupViews();
+void recordView(int view, const Camera &camera, RenderQueue &queue);
+void drawViewports();
 void close();
 
 SDL_Texture *loadTexture(std::string path);
@@ -15,6 +22,17 @@ SDL_Window *gWindow = NULL;
 SDL_Renderer *gRenderer = NULL;
 SDL_Texture *gTexture = NULL;
 
+// Only the bottom view moves, so after the first frame just that view is
+// re-recorded and redrawn while it pans; the canvas redraws everything on
+// expose or a lost render target.
+RetainedCanvas gCanvas;
+
+// Two overview panes on top and a panning view along the bottom, all
+// looking at the same world: the image at its own size.
+ViewRenderer gViews;
+int gBottomView = 0;
+SDL_Rect gWorldBounds = {0, 0, 0, 0};
+
 bool init()
 {
     bool success = true;
@@ -71,8 +89,48 @@ bool loadMedia()
     return success;
 }
 
+void setupViews()
+{
+    SDL_QueryTexture(gTexture, NULL, NULL, &gWorldBounds.w, &gWorldBounds.h);
+
+    SDL_Rect topLeftViewport = {0, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2};
+    SDL_Rect topRightViewport = {SCREEN_WIDTH / 2, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2};
+    SDL_Rect bottomViewport = {0, SCREEN_HEIGHT / 2, SCREEN_WIDTH, SCREEN_HEIGHT / 2};
+
+    int topLeft = gViews.addView(topLeftViewport);
+    int topRight = gViews.addView(topRightViewport);
+    gBottomView = gViews.addView(bottomViewport);
+
+    for (int i = 0; i < gViews.getViewCount(); ++i)
+    {
+        gViews.getCamera(i).setPosition(gWorldBounds.w / 2.0f, gWorldBounds.h / 2.0f);
+    }
+
+    // Fit the whole image into the top panes
+    gViews.getCamera(topLeft).setZoom((float)topLeftViewport.w / gWorldBounds.w);
+    gViews.getCamera(topRight).setZoom((float)topRightViewport.w / gWorldBounds.w);
+
+    gViews.start();
+}
+
+void recordView(int view, const Camera &camera, RenderQueue &queue)
+{
+    if (camera.isVisible(gWorldBounds))
+    {
+        queue.copy(gTexture, NULL, camera.worldToScreen(gWorldBounds));
+    }
+}
+
+void drawViewports()
+{
+    gViews.submit(gRenderer, &gCanvas);
+}
+
 void close()
 {
+    gViews.stop();
+    gCanvas.free();
+
     SDL_DestroyTexture(gTexture);
     gTexture = NULL;
 
@@ -128,6 +186,12 @@ int main(int argc, char const *argv[])
 
             SDL_Event e;
 
+            gCanvas.create(gRenderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+            setupViews();
+
+            // Views are only recorded again when a camera moves.
+            bool changed = true;
+
             while (!quit)
             {
                 while (SDL_PollEvent(&e) != 0)
@@ -136,38 +200,50 @@ int main(int argc, char const *argv[])
                     {
                         quit = true;
                     }
+                    else if (e.type == SDL_KEYDOWN)
+                    {
+                        Camera &camera = gViews.getCamera(gBottomView);
+                        switch (e.key.keysym.sym)
+                        {
+                        case SDLK_LEFT:
+                            camera.move(-PAN_STEP, 0.0f);
+                            changed = true;
+                            break;
+                        case SDLK_RIGHT:
+                            camera.move(PAN_STEP, 0.0f);
+                            changed = true;
+                            break;
+                        case SDLK_UP:
+                            camera.move(0.0f, -PAN_STEP);
+                            changed = true;
+                            break;
+                        case SDLK_DOWN:
+                            camera.move(0.0f, PAN_STEP);
+                            changed = true;
+                            break;
+                        }
+
+                        if (changed)
+                        {
+                            gViews.invalidate(gBottomView);
+                            gCanvas.invalidate(gViews.getViewport(gBottomView));
+                        }
+                    }
+
+                    gCanvas.handleEvent(e);
                 }
 
-                SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
-                SDL_RenderClear(gRenderer);
-                SDL_Rect topLeftViewport;
-                topLeftViewport.x = 0;
-                topLeftViewport.y = 0;
-                topLeftViewport.w = SCREEN_WIDTH / 2;
-                topLeftViewport.h = SCREEN_HEIGHT / 2;
-                SDL_RenderSetViewport(gRenderer, &topLeftViewport);
-
-                SDL_RenderCopy(gRenderer, gTexture, NULL, NULL);
-
-                SDL_Rect topRightViewport;
-                topRightViewport.x = SCREEN_WIDTH / 2;
-                topRightViewport.y = 0;
-                topRightViewport.w = SCREEN_WIDTH / 2;
-                topRightViewport.h = SCREEN_HEIGHT / 2;
-                SDL_RenderSetViewport(gRenderer, &topRightViewport);
-
-                SDL_RenderCopy(gRenderer, gTexture, NULL, NULL);
-
-                SDL_Rect bottomViewPort;
-                bottomViewPort.x = 0;
-                bottomViewPort.y = SCREEN_HEIGHT / 2;
-                bottomViewPort.w = SCREEN_WIDTH;
-                bottomViewPort.h = SCREEN_HEIGHT / 2;
-                SDL_RenderSetViewport(gRenderer, &bottomViewPort);
-
-                SDL_RenderCopy(gRenderer, gTexture, NULL, NULL);
-
-                SDL_RenderPresent(gRenderer);
+                if (changed)
+                {
+                    gViews.record(recordView);
+                    changed = false;
+                }
+
+                // Unchanged frame: sleep until something happens instead.
+                if (!gCanvas.render(drawViewports))
+                {
+                    SDL_WaitEventTimeout(NULL, IDLE_WAIT_MS);
+                }
             }
         }
     }
@@ -0,0 +1,119 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "../common/camera.h"
+#include "../common/spatial_hash.h"
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int WORLD_WIDTH = SCREEN_WIDTH * 32;
+const int WORLD_HEIGHT = SCREEN_HEIGHT * 32;
+const int FRAMES = 1000;
+
+const int OBJECT_COUNTS[] = {10000, 100000};
+const int CELL_SIZES[] = {128, 256, 512};
+
+// Lesson 20 sized sprites scattered over the world
+std::vector<SDL_Rect> createObjects(int count)
+{
+    std::vector<SDL_Rect> objects;
+    srand(1);
+
+    for (int i = 0; i < count; ++i)
+    {
+        SDL_Rect bounds = {rand() % WORLD_WIDTH, rand() % WORLD_HEIGHT, 100, 100};
+        objects.push_back(bounds);
+    }
+
+    return objects;
+}
+
+// A camera wandering across the world, zooming in and out
+std::vector<Camera> createCameras()
+{
+    std::vector<Camera> cameras(FRAMES);
+    srand(2);
+
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        cameras[i].setViewSize(SCREEN_WIDTH, SCREEN_HEIGHT);
+        cameras[i].setPosition((float)(rand() % WORLD_WIDTH), (float)(rand() % WORLD_HEIGHT));
+        cameras[i].setZoom(0.5f + (rand() % 100) / 50.0f);
+    }
+
+    return cameras;
+}
+
+double elapsedMs(Uint64 start)
+{
+    return (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void printResult(int objects, const char *implementation, int cellSize, double ms, long visible, bool matchesLinear)
+{
+    std::cout << "{\"objects\":" << objects
+              << ",\"impl\":\"" << implementation << "\"";
+    if (cellSize > 0)
+    {
+        std::cout << ",\"cell\":" << cellSize;
+    }
+    std::cout << ",\"ms\":" << ms
+              << ",\"us_per_frame\":" << ms * 1000.0 / FRAMES
+              << ",\"visible_per_frame\":" << visible / FRAMES;
+    if (cellSize > 0)
+    {
+        std::cout << ",\"matches_linear\":" << (matchesLinear ? "true" : "false");
+    }
+    std::cout << "}" << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    std::vector<Camera> cameras = createCameras();
+
+    for (size_t c = 0; c < sizeof(OBJECT_COUNTS) / sizeof(OBJECT_COUNTS[0]); ++c)
+    {
+        std::vector<SDL_Rect> objects = createObjects(OBJECT_COUNTS[c]);
+        std::vector<int> expected(FRAMES);
+
+        // Testing every object against the camera each frame
+        long visible = 0;
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            SDL_Rect view = cameras[f].getVisibleBounds();
+            int count = 0;
+            for (size_t i = 0; i < objects.size(); ++i)
+            {
+                count += SDL_HasIntersection(&objects[i], &view) ? 1 : 0;
+            }
+            expected[f] = count;
+            visible += count;
+        }
+        printResult(OBJECT_COUNTS[c], "linear", 0, elapsedMs(start), visible, true);
+
+        for (size_t s = 0; s < sizeof(CELL_SIZES) / sizeof(CELL_SIZES[0]); ++s)
+        {
+            SpatialHash hash(CELL_SIZES[s]);
+            for (size_t i = 0; i < objects.size(); ++i)
+            {
+                hash.add(objects[i]);
+            }
+
+            std::vector<int> results;
+            bool matches = true;
+            visible = 0;
+            start = SDL_GetPerformanceCounter();
+            for (int f = 0; f < FRAMES; ++f)
+            {
+                hash.query(cameras[f].getVisibleBounds(), results);
+                matches = (int)results.size() == expected[f] && matches;
+                visible += results.size();
+            }
+            printResult(OBJECT_COUNTS[c], "hash", CELL_SIZES[s], elapsedMs(start), visible, matches);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "../common/hit_grid.h"
+
+const int SCREEN_WIDTH = 1920;
+const int SCREEN_HEIGHT = 1080;
+const int QUERIES = 20000;
+
+const int WIDGET_COUNTS[] = {100, 1000, 10000};
+const int CELL_SIZES[] = {32, 64, 128};
+
+// What Button::handleEvent amounted to: test every widget, last one wins.
+int linearHitTest(const std::vector<SDL_Rect> &widgets, int x, int y)
+{
+    int hit = -1;
+    for (size_t i = 0; i < widgets.size(); ++i)
+    {
+        const SDL_Rect &bounds = widgets[i];
+        if (x >= bounds.x && y >= bounds.y && x < bounds.x + bounds.w && y < bounds.y + bounds.h)
+        {
+            hit = (int)i;
+        }
+    }
+    return hit;
+}
+
+// Tool UI sized widgets: mostly small buttons and fields, a few panels.
+std::vector<SDL_Rect> createWidgets(int count)
+{
+    std::vector<SDL_Rect> widgets;
+    srand(1);
+
+    for (int i = 0; i < count; ++i)
+    {
+        SDL_Rect bounds;
+        bool panel = rand() % 50 == 0;
+        bounds.w = panel ? 200 + rand() % 400 : 16 + rand() % 100;
+        bounds.h = panel ? 150 + rand() % 300 : 16 + rand() % 24;
+        bounds.x = rand() % (SCREEN_WIDTH - bounds.w);
+        bounds.y = rand() % (SCREEN_HEIGHT - bounds.h);
+        widgets.push_back(bounds);
+    }
+
+    return widgets;
+}
+
+double elapsedMs(Uint64 start)
+{
+    return (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void printResult(int widgets, const char *implementation, int cellSize, double ms, bool matchesLinear)
+{
+    std::cout << "{\"widgets\":" << widgets
+              << ",\"impl\":\"" << implementation << "\"";
+    if (cellSize > 0)
+    {
+        std::cout << ",\"cell\":" << cellSize;
+    }
+    std::cout << ",\"ms\":" << ms
+              << ",\"ns_per_query\":" << ms * 1000000.0 / QUERIES;
+    if (cellSize > 0)
+    {
+        std::cout << ",\"matches_linear\":" << (matchesLinear ? "true" : "false");
+    }
+    std::cout << "}" << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    std::vector<SDL_Point> points(QUERIES);
+    srand(2);
+    for (int i = 0; i < QUERIES; ++i)
+    {
+        points[i].x = rand() % SCREEN_WIDTH;
+        points[i].y = rand() % SCREEN_HEIGHT;
+    }
+
+    for (size_t c = 0; c < sizeof(WIDGET_COUNTS) / sizeof(WIDGET_COUNTS[0]); ++c)
+    {
+        std::vector<SDL_Rect> widgets = createWidgets(WIDGET_COUNTS[c]);
+        std::vector<int> expected(QUERIES);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int i = 0; i < QUERIES; ++i)
+        {
+            expected[i] = linearHitTest(widgets, points[i].x, points[i].y);
+        }
+        printResult(WIDGET_COUNTS[c], "linear", 0, elapsedMs(start), true);
+
+        for (size_t s = 0; s < sizeof(CELL_SIZES) / sizeof(CELL_SIZES[0]); ++s)
+        {
+            HitGrid grid(SCREEN_WIDTH, SCREEN_HEIGHT, CELL_SIZES[s]);
+            for (size_t i = 0; i < widgets.size(); ++i)
+            {
+                grid.add(widgets[i]);
+            }
+
+            bool matches = true;
+            start = SDL_GetPerformanceCounter();
+            for (int i = 0; i < QUERIES; ++i)
+            {
+                matches = grid.hitTest(points[i].x, points[i].y) == expected[i] && matches;
+            }
+            printResult(WIDGET_COUNTS[c], "grid", CELL_SIZES[s], elapsedMs(start), matches);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,467 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include "../common/animation.h"
+#include "../common/glyph_cache.h"
+#include "../common/ltexture.h"
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+
+struct Scene
+{
+    const char *name;
+    bool (*load)();
+    int (*render)(int frame);
+    void (*unload)();
+};
+
+bool init();
+void close();
+
+SDL_Surface *gTargetSurface = NULL;
+SDL_Renderer *gRenderer = NULL;
+std::string gAssetRoot = "..";
+
+LTexture gViewportTexture;
+LTexture gDotsTexture;
+AnimationSet gDotSheet;
+LTexture gArrowTexture;
+LTexture gTextTexture;
+LTexture gCounterTexture;
+TTF_Font *gFont = NULL;
+GlyphCache gGlyphs;
+TextLayout gCounterLayout;
+
+std::atomic<long> gAllocations(0);
+
+SDL_malloc_func gSDLMalloc = NULL;
+SDL_calloc_func gSDLCalloc = NULL;
+SDL_realloc_func gSDLRealloc = NULL;
+SDL_free_func gSDLFree = NULL;
+
+void *operator new(size_t size)
+{
+    ++gAllocations;
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+static void *countingMalloc(size_t size)
+{
+    ++gAllocations;
+    return gSDLMalloc(size);
+}
+
+static void *countingCalloc(size_t count, size_t size)
+{
+    ++gAllocations;
+    return gSDLCalloc(count, size);
+}
+
+static void *countingRealloc(void *memory, size_t size)
+{
+    ++gAllocations;
+    return gSDLRealloc(memory, size);
+}
+
+static void countingFree(void *memory)
+{
+    gSDLFree(memory);
+}
+
+int clearFrame()
+{
+    SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    SDL_RenderClear(gRenderer);
+    return 1;
+}
+
+bool loadNothing()
+{
+    return true;
+}
+
+void unloadNothing()
+{
+}
+
+int renderGeometry(int frame)
+{
+    int drawCalls = clearFrame();
+
+    SDL_Rect fillRect = {SCREEN_WIDTH / 4, SCREEN_HEIGHT / 4, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2};
+    SDL_SetRenderDrawColor(gRenderer, 0xFF, 0x00, 0x00, 0xFF);
+    SDL_RenderFillRect(gRenderer, &fillRect);
+    ++drawCalls;
+
+    SDL_Rect outlineRect = {SCREEN_WIDTH / 6, SCREEN_HEIGHT / 6, SCREEN_WIDTH * 2 / 3, SCREEN_HEIGHT * 2 / 3};
+    SDL_SetRenderDrawColor(gRenderer, 0x00, 0xFF, 0x00, 0xFF);
+    SDL_RenderDrawRect(gRenderer, &outlineRect);
+    ++drawCalls;
+
+    SDL_SetRenderDrawColor(gRenderer, 0x00, 0x00, 0xFF, 0xFF);
+    SDL_RenderDrawLine(gRenderer, 0, SCREEN_HEIGHT / 2, SCREEN_WIDTH, SCREEN_HEIGHT / 2);
+    ++drawCalls;
+
+    SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0x00, 0xFF);
+    for (int i = 0; i < SCREEN_HEIGHT; i += 4)
+    {
+        SDL_RenderDrawPoint(gRenderer, SCREEN_WIDTH / 2, i);
+        ++drawCalls;
+    }
+
+    return drawCalls;
+}
+
+bool loadViewport()
+{
+    return gViewportTexture.loadFromFile(gRenderer, gAssetRoot + "/9/viewport.png");
+}
+
+int renderViewport(int frame)
+{
+    int drawCalls = clearFrame();
+
+    SDL_Rect viewports[3] = {
+        {0, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2},
+        {SCREEN_WIDTH / 2, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2},
+        {0, SCREEN_HEIGHT / 2, SCREEN_WIDTH, SCREEN_HEIGHT / 2}};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        SDL_RenderSetViewport(gRenderer, &viewports[i]);
+
+        SDL_Rect fill = {0, 0, viewports[i].w, viewports[i].h};
+        gViewportTexture.render(fill);
+        ++drawCalls;
+    }
+
+    SDL_RenderSetViewport(gRenderer, NULL);
+    return drawCalls;
+}
+
+void unloadViewport()
+{
+    gViewportTexture.free();
+}
+
+bool loadSpriteSheets()
+{
+    gDotSheet.clear();
+    gDotSheet.addGrid(100, 100, 2, 2);
+
+    return gDotsTexture.loadFromFile(gRenderer, gAssetRoot + "/11/dots.png");
+}
+
+int renderSpriteSheets(int frame)
+{
+    int drawCalls = clearFrame();
+
+    SDL_Point positions[4] = {
+        {0, 0},
+        {SCREEN_WIDTH - 100, 0},
+        {0, SCREEN_HEIGHT - 100},
+        {SCREEN_WIDTH - 100, SCREEN_HEIGHT - 100}};
+
+    for (int i = 0; i < 4; ++i)
+    {
+        gDotsTexture.render(positions[i].x, positions[i].y, &gDotSheet.getFrame(i));
+        ++drawCalls;
+    }
+
+    return drawCalls;
+}
+
+void unloadSpriteSheets()
+{
+    gDotsTexture.free();
+}
+
+bool loadRotation()
+{
+    return gArrowTexture.loadFromFile(gRenderer, gAssetRoot + "/15/arrow.png");
+}
+
+int renderRotation(int frame)
+{
+    int drawCalls = clearFrame();
+
+    SDL_RendererFlip flip = (SDL_RendererFlip)((frame / 60) % 3);
+    gArrowTexture.render((SCREEN_WIDTH - gArrowTexture.getWidth()) / 2, (SCREEN_HEIGHT - gArrowTexture.getHeight()) / 2, NULL, (frame * 6) % 360, NULL, flip);
+    ++drawCalls;
+
+    return drawCalls;
+}
+
+void unloadRotation()
+{
+    gArrowTexture.free();
+}
+
+bool loadText()
+{
+    gFont = TTF_OpenFont((gAssetRoot + "/16/lazy.ttf").c_str(), 28);
+    if (gFont == NULL)
+    {
+        std::cout << "Unable to open font! SDL_ttf error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_Color textColor = {0, 0, 0, 0xFF};
+    if (!gTextTexture.loadFromRenderedText(gRenderer, gFont, "The quick brown fox jumps over the lazy dog", textColor))
+    {
+        return false;
+    }
+
+    return gGlyphs.load(gRenderer, gAssetRoot + "/16/lazy.ttf", 20);
+}
+
+int renderText(int frame)
+{
+    int drawCalls = clearFrame();
+
+    gTextTexture.render((SCREEN_WIDTH - gTextTexture.getWidth()) / 2, (SCREEN_HEIGHT - gTextTexture.getHeight()) / 2);
+    ++drawCalls;
+
+    return drawCalls;
+}
+
+int renderTextRerendered(int frame)
+{
+    int drawCalls = clearFrame();
+
+    SDL_Color textColor = {0, 0, 0, 0xFF};
+    std::string counter = "Frame: " + std::to_string(frame);
+
+    // What lesson 16 would do for changing text: a new surface and texture
+    // every frame. A failed render leaves the frame without a counter.
+    if (gCounterTexture.loadFromRenderedText(gRenderer, gFont, counter, textColor))
+    {
+        gCounterTexture.render(10, 10);
+        ++drawCalls;
+    }
+
+    return drawCalls;
+}
+
+int renderTextGlyphCache(int frame)
+{
+    int drawCalls = clearFrame();
+
+    SDL_Color textColor = {0, 0, 0, 0xFF};
+    gCounterLayout.setText(&gGlyphs, "Frame: " + std::to_string(frame), textColor);
+    gCounterLayout.render(gRenderer, 10, 10);
+    ++drawCalls;
+
+    return drawCalls;
+}
+
+void unloadText()
+{
+    gTextTexture.free();
+    gCounterTexture.free();
+    gGlyphs.free();
+
+    if (gFont != NULL)
+    {
+        TTF_CloseFont(gFont);
+        gFont = NULL;
+    }
+}
+
+const Scene SCENES[] = {
+    {"geometry", loadNothing, renderGeometry, unloadNothing},
+    {"viewport", loadViewport, renderViewport, unloadViewport},
+    {"sprite_sheets", loadSpriteSheets, renderSpriteSheets, unloadSpriteSheets},
+    {"rotation", loadRotation, renderRotation, unloadRotation},
+    {"text", loadText, renderText, unloadText},
+    {"text_rerendered", loadText, renderTextRerendered, unloadText},
+    {"text_glyph_cache", loadText, renderTextGlyphCache, unloadText}};
+
+const int SCENE_TOTAL = sizeof(SCENES) / sizeof(SCENES[0]);
+
+bool init()
+{
+    bool success = true;
+
+    SDL_GetMemoryFunctions(&gSDLMalloc, &gSDLCalloc, &gSDLRealloc, &gSDLFree);
+    SDL_SetMemoryFunctions(countingMalloc, countingCalloc, countingRealloc, countingFree);
+
+    // Set as a hint rather than forced, so SDL_VIDEODRIVER still wins.
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cout << "SDL could not initialized! SDL error: " << SDL_GetError() << std::endl;
+        success = false;
+    }
+    else
+    {
+        gTargetSurface = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (gTargetSurface == NULL)
+        {
+            std::cout << "Target surface could not be created! SDL error: " << SDL_GetError() << std::endl;
+            success = false;
+        }
+        else
+        {
+            gRenderer = SDL_CreateSoftwareRenderer(gTargetSurface);
+            if (gRenderer == NULL)
+            {
+                std::cout << "Software renderer could not be created! SDL error: " << SDL_GetError() << std::endl;
+                success = false;
+            }
+            else
+            {
+                int imgFlags = IMG_INIT_PNG;
+                if (!(IMG_Init(imgFlags) & imgFlags))
+                {
+                    std::cout << "SDL_image could not initialized" << std::endl;
+                    success = false;
+                }
+
+                if (TTF_Init() == -1)
+                {
+                    std::cout << "TTF could not initialized" << std::endl;
+                    success = false;
+                }
+            }
+        }
+    }
+
+    return success;
+}
+
+void close()
+{
+    SDL_DestroyRenderer(gRenderer);
+    gRenderer = NULL;
+
+    if (gTargetSurface != NULL)
+    {
+        SDL_FreeSurface(gTargetSurface);
+        gTargetSurface = NULL;
+    }
+
+    TTF_Quit();
+    IMG_Quit();
+    SDL_Quit();
+}
+
+bool runScene(const Scene &scene, int frames)
+{
+    if (!scene.load())
+    {
+        std::cout << "{\"scene\":\"" << scene.name << "\",\"error\":\"load failed\"}" << std::endl;
+        scene.unload();
+        return false;
+    }
+
+    // One untimed frame so first-use allocations do not skew the numbers.
+    scene.render(0);
+    SDL_RenderPresent(gRenderer);
+
+    long drawCalls = 0;
+    long allocationsBefore = gAllocations;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int frame = 1; frame <= frames; ++frame)
+    {
+        drawCalls += scene.render(frame);
+        SDL_RenderPresent(gRenderer);
+    }
+
+    Uint64 end = SDL_GetPerformanceCounter();
+    long allocations = gAllocations - allocationsBefore;
+
+    scene.unload();
+
+    double totalMs = (end - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    double msPerFrame = totalMs / frames;
+
+    std::cout << "{\"scene\":\"" << scene.name << "\""
+              << ",\"renderer\":\"software\""
+              << ",\"frames\":" << frames
+              << ",\"fps\":" << (msPerFrame > 0.0 ? 1000.0 / msPerFrame : 0.0)
+              << ",\"ms_per_frame\":" << msPerFrame
+              << ",\"draw_calls_per_frame\":" << (double)drawCalls / frames
+              << ",\"allocations_per_frame\":" << (double)allocations / frames
+              << "}" << std::endl;
+
+    return true;
+}
+
+int main(int argc, char const *argv[])
+{
+    int frames = 500;
+    std::string only;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+        else if (strcmp(argv[i], "--assets") == 0 && i + 1 < argc)
+        {
+            gAssetRoot = argv[++i];
+        }
+    }
+
+    if (frames < 1)
+    {
+        frames = 1;
+    }
+
+    int failures = 0;
+
+    if (!init())
+    {
+        std::cout << "SDL could not initialized" << std::endl;
+        failures = 1;
+    }
+    else
+    {
+        for (int i = 0; i < SCENE_TOTAL; ++i)
+        {
+            if (!only.empty() && only != SCENES[i].name)
+            {
+                continue;
+            }
+
+            if (!runScene(SCENES[i], frames))
+            {
+                ++failures;
+            }
+        }
+    }
+
+    close();
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../common/primitive_batch.h"
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int OVERLAY_COLORS = 8;
+
+enum BenchShape
+{
+    SHAPE_POINT,
+    SHAPE_LINE,
+    SHAPE_FILL_RECT,
+    SHAPE_DRAW_RECT
+};
+
+struct BenchPrimitive
+{
+    BenchShape shape;
+    int x1;
+    int y1;
+    int x2;
+    int y2;
+    SDL_Color color;
+};
+
+bool init(bool software);
+void close();
+
+SDL_Window *gWindow = NULL;
+SDL_Renderer *gRenderer = NULL;
+
+std::vector<BenchPrimitive> gPrimitives;
+
+bool init(bool software)
+{
+    bool success = true;
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cout << "SDL could not initialized! SDL error: " << SDL_GetError() << std::endl;
+        success = false;
+    }
+    else
+    {
+        gWindow = SDL_CreateWindow("SDL", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_HIDDEN);
+        if (gWindow == NULL)
+        {
+            std::cout << "Window could not be created! SDL error: " << SDL_GetError() << std::endl;
+            success = false;
+        }
+        else
+        {
+            Uint32 flags = software ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+            gRenderer = SDL_CreateRenderer(gWindow, -1, flags);
+            if (gRenderer == NULL)
+            {
+                std::cout << "Renderer could not be created! SDL error: " << SDL_GetError() << std::endl;
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+void close()
+{
+    SDL_DestroyRenderer(gRenderer);
+    SDL_DestroyWindow(gWindow);
+
+    gRenderer = NULL;
+    gWindow = NULL;
+
+    SDL_Quit();
+}
+
+// A debug overlay: mostly points, then short lines and small boxes, in a
+// handful of colors.
+void createPrimitives(int count)
+{
+    srand(1);
+
+    SDL_Color palette[OVERLAY_COLORS];
+    for (int i = 0; i < OVERLAY_COLORS; ++i)
+    {
+        palette[i].r = rand() % 256;
+        palette[i].g = rand() % 256;
+        palette[i].b = rand() % 256;
+        palette[i].a = 0xFF;
+    }
+
+    gPrimitives.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        BenchPrimitive &primitive = gPrimitives[i];
+        int kind = rand() % 10;
+        primitive.shape = kind < 5 ? SHAPE_POINT : kind < 8 ? SHAPE_LINE : kind < 9 ? SHAPE_FILL_RECT : SHAPE_DRAW_RECT;
+        primitive.x1 = rand() % SCREEN_WIDTH;
+        primitive.y1 = rand() % SCREEN_HEIGHT;
+        primitive.x2 = primitive.x1 + rand() % 32 - 16;
+        primitive.y2 = primitive.y1 + rand() % 32 - 16;
+        primitive.color = palette[rand() % OVERLAY_COLORS];
+    }
+}
+
+int renderImmediate()
+{
+    int drawCalls = 0;
+
+    for (size_t i = 0; i < gPrimitives.size(); ++i)
+    {
+        const BenchPrimitive &primitive = gPrimitives[i];
+        SDL_Rect rect = {SDL_min(primitive.x1, primitive.x2), SDL_min(primitive.y1, primitive.y2),
+                         abs(primitive.x2 - primitive.x1) + 1, abs(primitive.y2 - primitive.y1) + 1};
+
+        SDL_SetRenderDrawColor(gRenderer, primitive.color.r, primitive.color.g, primitive.color.b, primitive.color.a);
+        switch (primitive.shape)
+        {
+        case SHAPE_POINT:
+            SDL_RenderDrawPoint(gRenderer, primitive.x1, primitive.y1);
+            break;
+        case SHAPE_LINE:
+            SDL_RenderDrawLine(gRenderer, primitive.x1, primitive.y1, primitive.x2, primitive.y2);
+            break;
+        case SHAPE_FILL_RECT:
+            SDL_RenderFillRect(gRenderer, &rect);
+            break;
+        case SHAPE_DRAW_RECT:
+            SDL_RenderDrawRect(gRenderer, &rect);
+            break;
+        }
+        ++drawCalls;
+    }
+
+    return drawCalls;
+}
+
+int renderBatched(PrimitiveBatch &batch)
+{
+    for (size_t i = 0; i < gPrimitives.size(); ++i)
+    {
+        const BenchPrimitive &primitive = gPrimitives[i];
+        SDL_FRect rect = {(float)SDL_min(primitive.x1, primitive.x2), (float)SDL_min(primitive.y1, primitive.y2),
+                          (float)abs(primitive.x2 - primitive.x1) + 1, (float)abs(primitive.y2 - primitive.y1) + 1};
+
+        batch.setColor(primitive.color.r, primitive.color.g, primitive.color.b, primitive.color.a);
+        switch (primitive.shape)
+        {
+        case SHAPE_POINT:
+            batch.point(primitive.x1, primitive.y1);
+            break;
+        case SHAPE_LINE:
+            batch.line(primitive.x1, primitive.y1, primitive.x2, primitive.y2);
+            break;
+        case SHAPE_FILL_RECT:
+            batch.fillRect(rect);
+            break;
+        case SHAPE_DRAW_RECT:
+            batch.drawRect(rect);
+            break;
+        }
+    }
+
+    return batch.flush(gRenderer);
+}
+
+void runPath(std::string name, int frames, bool batched)
+{
+    PrimitiveBatch batch;
+    long drawCalls = 0;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        SDL_SetRenderDrawColor(gRenderer, 0x00, 0x00, 0x00, 0xFF);
+        SDL_RenderClear(gRenderer);
+
+        if (batched)
+        {
+            drawCalls += renderBatched(batch);
+        }
+        else
+        {
+            drawCalls += renderImmediate();
+        }
+
+        SDL_RenderPresent(gRenderer);
+    }
+
+    Uint64 end = SDL_GetPerformanceCounter();
+    double totalMs = (end - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+    std::cout << name << " primitives=" << gPrimitives.size() << " frames=" << frames
+              << " ms_per_frame=" << totalMs / frames
+              << " draw_calls_per_frame=" << (double)drawCalls / frames << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    int primitiveCount = 100000;
+    int frames = 100;
+    bool software = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--primitives") == 0 && i + 1 < argc)
+        {
+            primitiveCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--software") == 0)
+        {
+            software = true;
+        }
+    }
+
+    if (!init(software))
+    {
+        std::cout << "SDL could not initialized" << std::endl;
+    }
+    else
+    {
+        createPrimitives(primitiveCount);
+
+        runPath("immediate", frames, false);
+        runPath("primitive_batch", frames, true);
+    }
+
+    close();
+
+    return 0;
+}
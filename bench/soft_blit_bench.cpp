@@ -0,0 +1,279 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "../common/soft_blit.h"
+
+const int SURFACE_WIDTH = 640;
+const int SURFACE_HEIGHT = 480;
+
+enum BlitOperation
+{
+    BLIT_CONVERT,
+    BLIT_COPY,
+    BLIT_KEYED,
+    BLIT_BLEND,
+    BLIT_BLEND_MODULATED
+};
+
+struct BlitCase
+{
+    const char *name;
+    BlitOperation operation;
+    Uint32 sourceFormat;
+};
+
+const BlitCase CASES[] = {
+    {"convert_rgb24", BLIT_CONVERT, SDL_PIXELFORMAT_RGB24},
+    {"convert_bgr24", BLIT_CONVERT, SDL_PIXELFORMAT_BGR24},
+    {"convert_rgba32", BLIT_CONVERT, SDL_PIXELFORMAT_RGBA32},
+    {"blit_copy", BLIT_COPY, SDL_PIXELFORMAT_ARGB8888},
+    {"blit_keyed", BLIT_KEYED, SDL_PIXELFORMAT_ARGB8888},
+    {"blit_blend", BLIT_BLEND, SDL_PIXELFORMAT_ARGB8888},
+    {"blit_blend_modulated", BLIT_BLEND_MODULATED, SDL_PIXELFORMAT_ARGB8888}};
+
+const PixelKernelSet KERNEL_SETS[] = {PIXEL_KERNELS_SCALAR, PIXEL_KERNELS_SSE41, PIXEL_KERNELS_AVX2, PIXEL_KERNELS_NEON};
+
+// Same key the lessons use for their sprite sheets.
+const Uint32 KEY_COLOR = 0x0000FFFF;
+
+// Fills the source like a sprite sheet: runs of keyed, transparent, opaque
+// and translucent pixels rather than pure noise.
+SDL_Surface *createSource(Uint32 format)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, SURFACE_WIDTH, SURFACE_HEIGHT, 32, format);
+    if (surface == NULL)
+    {
+        return NULL;
+    }
+
+    int bytesPerPixel = surface->format->BytesPerPixel;
+    srand(1);
+
+    for (int y = 0; y < surface->h; ++y)
+    {
+        Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+        int run = 0;
+        int kind = 0;
+
+        for (int x = 0; x < surface->w; ++x)
+        {
+            if (run == 0)
+            {
+                run = 4 + rand() % 28;
+                kind = rand() % 4;
+            }
+            --run;
+
+            Uint32 pixel = (Uint32)rand() << 8 ^ (Uint32)rand();
+            if (kind == 0)
+            {
+                pixel = KEY_COLOR;
+            }
+            else if (kind == 1)
+            {
+                pixel &= 0x00FFFFFF;
+            }
+            else if (kind == 2)
+            {
+                pixel |= 0xFF000000;
+            }
+
+            if (bytesPerPixel == 4)
+            {
+                ((Uint32 *)row)[x] = pixel;
+            }
+            else
+            {
+                memcpy(row + x * bytesPerPixel, &pixel, bytesPerPixel);
+            }
+        }
+    }
+
+    return surface;
+}
+
+void prepareSource(SDL_Surface *source, BlitOperation operation)
+{
+    SDL_SetColorKey(source, operation == BLIT_KEYED ? SDL_TRUE : SDL_FALSE, KEY_COLOR);
+    SDL_SetSurfaceBlendMode(source, operation == BLIT_BLEND || operation == BLIT_BLEND_MODULATED ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+
+    if (operation == BLIT_BLEND_MODULATED)
+    {
+        SDL_SetSurfaceColorMod(source, 0xFF, 0x80, 0x40);
+        SDL_SetSurfaceAlphaMod(source, 0xC0);
+    }
+    else
+    {
+        SDL_SetSurfaceColorMod(source, 0xFF, 0xFF, 0xFF);
+        SDL_SetSurfaceAlphaMod(source, 0xFF);
+    }
+}
+
+// Runs one iteration and leaves its output in target (converted surfaces
+// are copied there so results can be compared between implementations).
+void runOnce(const BlitCase &blitCase, SDL_Surface *source, SDL_Surface *target, bool useSDL)
+{
+    if (blitCase.operation == BLIT_CONVERT)
+    {
+        SDL_Surface *converted = NULL;
+        if (useSDL)
+        {
+            converted = SDL_ConvertSurfaceFormat(source, target->format->format, 0);
+        }
+        else
+        {
+            converted = softConvertSurface(source, target->format->format);
+        }
+
+        if (converted != NULL)
+        {
+            for (int y = 0; y < converted->h; ++y)
+            {
+                memcpy((Uint8 *)target->pixels + y * target->pitch, (Uint8 *)converted->pixels + y * converted->pitch, converted->w * 4);
+            }
+            SDL_FreeSurface(converted);
+        }
+    }
+    else
+    {
+        // Restore the background so blending always starts from the same
+        // destination.
+        SDL_FillRect(target, NULL, 0xFF336699);
+
+        if (useSDL)
+        {
+            SDL_BlitSurface(source, NULL, target, NULL);
+        }
+        else
+        {
+            softBlitSurface(source, NULL, target, NULL);
+        }
+    }
+}
+
+double timeCase(const BlitCase &blitCase, SDL_Surface *source, SDL_Surface *target, bool useSDL, int iterations)
+{
+    runOnce(blitCase, source, target, useSDL);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int i = 0; i < iterations; ++i)
+    {
+        runOnce(blitCase, source, target, useSDL);
+    }
+    Uint64 end = SDL_GetPerformanceCounter();
+
+    return (end - start) * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+bool sameOutput(SDL_Surface *a, SDL_Surface *b)
+{
+    for (int y = 0; y < a->h; ++y)
+    {
+        const Uint32 *rowA = (const Uint32 *)((Uint8 *)a->pixels + y * a->pitch);
+        const Uint32 *rowB = (const Uint32 *)((Uint8 *)b->pixels + y * b->pitch);
+        for (int x = 0; x < a->w; ++x)
+        {
+            if ((rowA[x] & 0x00FFFFFF) != (rowB[x] & 0x00FFFFFF))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void printResult(const BlitCase &blitCase, const char *implementation, double msPerIteration, bool matchesScalar)
+{
+    double megapixels = (double)SURFACE_WIDTH * SURFACE_HEIGHT / 1000000.0;
+
+    std::cout << "{\"case\":\"" << blitCase.name << "\""
+              << ",\"impl\":\"" << implementation << "\""
+              << ",\"ms\":" << msPerIteration
+              << ",\"mpix_per_s\":" << (msPerIteration > 0.0 ? megapixels * 1000.0 / msPerIteration : 0.0);
+    if (strcmp(implementation, "sdl") != 0)
+    {
+        std::cout << ",\"matches_scalar\":" << (matchesScalar ? "true" : "false");
+    }
+    std::cout << "}" << std::endl;
+}
+
+bool runCase(const BlitCase &blitCase, Uint32 targetFormat, int iterations)
+{
+    SDL_Surface *source = createSource(blitCase.sourceFormat);
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, SURFACE_WIDTH, SURFACE_HEIGHT, 32, targetFormat);
+    SDL_Surface *reference = SDL_CreateRGBSurfaceWithFormat(0, SURFACE_WIDTH, SURFACE_HEIGHT, 32, targetFormat);
+    bool success = source != NULL && target != NULL && reference != NULL;
+
+    if (!success)
+    {
+        std::cout << "Surfaces could not be created! SDL error: " << SDL_GetError() << std::endl;
+    }
+    else
+    {
+        prepareSource(source, blitCase.operation);
+
+        printResult(blitCase, "sdl", timeCase(blitCase, source, target, true, iterations), false);
+
+        setPixelKernels(PIXEL_KERNELS_SCALAR);
+        runOnce(blitCase, source, reference, false);
+
+        for (size_t i = 0; i < sizeof(KERNEL_SETS) / sizeof(KERNEL_SETS[0]); ++i)
+        {
+            if (!setPixelKernels(KERNEL_SETS[i]))
+            {
+                continue;
+            }
+
+            double ms = timeCase(blitCase, source, target, false, iterations);
+            printResult(blitCase, getPixelKernels().name, ms, sameOutput(target, reference));
+        }
+
+        setPixelKernels(PIXEL_KERNELS_AUTO);
+    }
+
+    SDL_FreeSurface(source);
+    SDL_FreeSurface(target);
+    SDL_FreeSurface(reference);
+
+    return success;
+}
+
+int main(int argc, char const *argv[])
+{
+    int iterations = 200;
+    std::string only;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--case") == 0 && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+    }
+
+    if (SDL_Init(0) < 0)
+    {
+        std::cout << "SDL could not initialized! SDL error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    // XRGB8888 is what the window surface uses on most desktops.
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i)
+    {
+        if (only.empty() || only == CASES[i].name)
+        {
+            runCase(CASES[i], SDL_PIXELFORMAT_RGB888, iterations);
+        }
+    }
+
+    SDL_Quit();
+
+    return 0;
+}
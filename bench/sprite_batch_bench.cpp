@@ -0,0 +1,263 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../common/sprite_batch.h"
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+const int DOT_CLIPS = 4;
+
+struct BenchSprite
+{
+    int x;
+    int y;
+    int clip;
+    double angle;
+    SDL_RendererFlip flip;
+    Uint8 red;
+    Uint8 green;
+    Uint8 blue;
+    Uint8 alpha;
+};
+
+bool init(bool software);
+bool loadMedia();
+void close();
+
+SDL_Window *gWindow = NULL;
+SDL_Renderer *gRenderer = NULL;
+SDL_Texture *gDotsTexture = NULL;
+
+SDL_Rect gSpriteClips[DOT_CLIPS];
+std::vector<BenchSprite> gSprites;
+
+bool init(bool software)
+{
+    bool success = true;
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cout << "SDL could not initialized! SDL error: " << SDL_GetError() << std::endl;
+        success = false;
+    }
+    else
+    {
+        gWindow = SDL_CreateWindow("SDL", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_HIDDEN);
+        if (gWindow == NULL)
+        {
+            std::cout << "Window could not be created! SDL error: " << SDL_GetError() << std::endl;
+            success = false;
+        }
+        else
+        {
+            Uint32 flags = software ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+            gRenderer = SDL_CreateRenderer(gWindow, -1, flags);
+            if (gRenderer == NULL)
+            {
+                std::cout << "Renderer could not be created! SDL error: " << SDL_GetError() << std::endl;
+                success = false;
+            }
+            else
+            {
+                int imgFlags = IMG_INIT_PNG;
+                if (!(IMG_Init(imgFlags) & imgFlags))
+                {
+                    std::cout << "SDL_image could not initialized" << std::endl;
+                    success = false;
+                }
+            }
+        }
+    }
+
+    return success;
+}
+
+bool loadMedia()
+{
+    bool success = true;
+
+    SDL_Surface *loadedSurface = IMG_Load("../11/dots.png");
+    if (loadedSurface == NULL)
+    {
+        std::cout << "Unable to load dots sprite sheet" << std::endl;
+        success = false;
+    }
+    else
+    {
+        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
+        gDotsTexture = SDL_CreateTextureFromSurface(gRenderer, loadedSurface);
+        if (gDotsTexture == NULL)
+        {
+            std::cout << "Unable to create dots texture" << std::endl;
+            success = false;
+        }
+
+        SDL_FreeSurface(loadedSurface);
+    }
+
+    for (int i = 0; i < DOT_CLIPS; ++i)
+    {
+        gSpriteClips[i].x = (i % 2) * 100;
+        gSpriteClips[i].y = (i / 2) * 100;
+        gSpriteClips[i].w = 100;
+        gSpriteClips[i].h = 100;
+    }
+
+    return success;
+}
+
+void close()
+{
+    if (gDotsTexture != NULL)
+    {
+        SDL_DestroyTexture(gDotsTexture);
+        gDotsTexture = NULL;
+    }
+
+    SDL_DestroyRenderer(gRenderer);
+    SDL_DestroyWindow(gWindow);
+
+    gRenderer = NULL;
+    gWindow = NULL;
+
+    IMG_Quit();
+    SDL_Quit();
+}
+
+void createSprites(int count)
+{
+    srand(1);
+
+    gSprites.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        BenchSprite &sprite = gSprites[i];
+        sprite.x = rand() % SCREEN_WIDTH - 50;
+        sprite.y = rand() % SCREEN_HEIGHT - 50;
+        sprite.clip = rand() % DOT_CLIPS;
+        sprite.angle = (rand() % 4 == 0) ? rand() % 360 : 0.0;
+        sprite.flip = (SDL_RendererFlip)(rand() % 3);
+        sprite.red = rand() % 256;
+        sprite.green = rand() % 256;
+        sprite.blue = rand() % 256;
+        sprite.alpha = 128 + rand() % 128;
+    }
+}
+
+int renderPerSprite()
+{
+    int drawCalls = 0;
+
+    for (size_t i = 0; i < gSprites.size(); ++i)
+    {
+        const BenchSprite &sprite = gSprites[i];
+        SDL_Rect *clip = &gSpriteClips[sprite.clip];
+        SDL_Rect renderQuad = {sprite.x, sprite.y, clip->w, clip->h};
+
+        SDL_SetTextureColorMod(gDotsTexture, sprite.red, sprite.green, sprite.blue);
+        SDL_SetTextureAlphaMod(gDotsTexture, sprite.alpha);
+        SDL_RenderCopyEx(gRenderer, gDotsTexture, clip, &renderQuad, sprite.angle, NULL, sprite.flip);
+        ++drawCalls;
+    }
+
+    SDL_SetTextureColorMod(gDotsTexture, 0xFF, 0xFF, 0xFF);
+    SDL_SetTextureAlphaMod(gDotsTexture, 0xFF);
+
+    return drawCalls;
+}
+
+int renderBatched(SpriteBatch &batch)
+{
+    for (size_t i = 0; i < gSprites.size(); ++i)
+    {
+        const BenchSprite &sprite = gSprites[i];
+
+        batch.setColor(sprite.red, sprite.green, sprite.blue);
+        batch.setAlpha(sprite.alpha);
+        batch.draw(gDotsTexture, sprite.x, sprite.y, &gSpriteClips[sprite.clip], sprite.angle, NULL, sprite.flip);
+    }
+
+    return batch.flush(gRenderer);
+}
+
+void runPath(std::string name, int frames, bool batched)
+{
+    SpriteBatch batch;
+    long drawCalls = 0;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        SDL_SetRenderDrawColor(gRenderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        SDL_RenderClear(gRenderer);
+
+        if (batched)
+        {
+            drawCalls += renderBatched(batch);
+        }
+        else
+        {
+            drawCalls += renderPerSprite();
+        }
+
+        SDL_RenderPresent(gRenderer);
+    }
+
+    Uint64 end = SDL_GetPerformanceCounter();
+    double totalMs = (end - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+    std::cout << name << " sprites=" << gSprites.size() << " frames=" << frames
+              << " ms_per_frame=" << totalMs / frames
+              << " draw_calls_per_frame=" << (double)drawCalls / frames << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    int spriteCount = 10000;
+    int frames = 200;
+    bool software = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--sprites") == 0 && i + 1 < argc)
+        {
+            spriteCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--software") == 0)
+        {
+            software = true;
+        }
+    }
+
+    if (!init(software))
+    {
+        std::cout << "SDL could not initialized" << std::endl;
+    }
+    else
+    {
+        if (!loadMedia())
+        {
+            std::cout << "Failed to load media" << std::endl;
+        }
+        else
+        {
+            createSprites(spriteCount);
+
+            runPath("per_sprite", frames, false);
+            runPath("sprite_batch", frames, true);
+        }
+    }
+
+    close();
+
+    return 0;
+}
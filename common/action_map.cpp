@@ -0,0 +1,261 @@
+#include "action_map.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "profiler.h"
+
+ActionMap::ActionMap()
+{
+}
+
+ActionMap::~ActionMap()
+{
+    for (size_t i = 0; i < mControllers.size(); ++i)
+    {
+        SDL_GameControllerClose(mControllers[i]);
+    }
+}
+
+bool ActionMap::loadFromFile(std::string path)
+{
+    PROFILE_SCOPE("ActionMap::loadFromFile");
+
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cout << "Unable to open controls " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    bool success = true;
+
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name) || name[0] == '#')
+        {
+            continue;
+        }
+
+        int action = addAction(name);
+        std::string input;
+        while (fields >> input)
+        {
+            if (!bind(action, input))
+            {
+                std::cout << path << ":" << lineNumber << ": unknown input '" << input << "'" << std::endl;
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+int ActionMap::addAction(std::string name)
+{
+    int action = findAction(name);
+    if (action < 0)
+    {
+        mNames.push_back(name);
+        mMasks.push_back(InputBits());
+        action = (int)mNames.size() - 1;
+    }
+    return action;
+}
+
+int ActionMap::findAction(std::string name) const
+{
+    for (size_t i = 0; i < mNames.size(); ++i)
+    {
+        if (mNames[i] == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool ActionMap::bind(int action, std::string input)
+{
+    size_t colon = input.find(':');
+    if (colon == std::string::npos)
+    {
+        return false;
+    }
+
+    std::string device = input.substr(0, colon);
+    std::string name = input.substr(colon + 1);
+
+    if (device == "key")
+    {
+        std::replace(name.begin(), name.end(), '_', ' ');
+        SDL_Scancode scancode = SDL_GetScancodeFromName(name.c_str());
+        if (scancode == SDL_SCANCODE_UNKNOWN)
+        {
+            return false;
+        }
+        bindKey(action, scancode);
+        return true;
+    }
+
+    if (device == "mouse")
+    {
+        const char *BUTTON_NAMES[] = {"left", "middle", "right", "x1", "x2"};
+        for (int i = 0; i < 5; ++i)
+        {
+            if (name == BUTTON_NAMES[i])
+            {
+                bindMouseButton(action, (Uint8)(SDL_BUTTON_LEFT + i));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (device == "pad")
+    {
+        SDL_GameControllerButton button = SDL_GameControllerGetButtonFromString(name.c_str());
+        if (button == SDL_CONTROLLER_BUTTON_INVALID)
+        {
+            return false;
+        }
+        bindControllerButton(action, button);
+        return true;
+    }
+
+    return false;
+}
+
+void ActionMap::bindKey(int action, SDL_Scancode scancode)
+{
+    mMasks[action].set(scancode);
+}
+
+void ActionMap::bindMouseButton(int action, Uint8 button)
+{
+    mMasks[action].set(ACTION_INPUT_MOUSE + (button & 7));
+}
+
+void ActionMap::bindControllerButton(int action, SDL_GameControllerButton button)
+{
+    mMasks[action].set(ACTION_INPUT_CONTROLLER + button);
+}
+
+void ActionMap::clear()
+{
+    mNames.clear();
+    mMasks.clear();
+}
+
+void ActionMap::subscribe(EventDispatcher &dispatcher)
+{
+    const Uint32 TYPES[] = {SDL_KEYDOWN, SDL_KEYUP, SDL_MOUSEBUTTONDOWN, SDL_MOUSEBUTTONUP, SDL_CONTROLLERBUTTONDOWN,
+                            SDL_CONTROLLERBUTTONUP, SDL_CONTROLLERDEVICEADDED, SDL_CONTROLLERDEVICEREMOVED, SDL_WINDOWEVENT};
+
+    for (size_t i = 0; i < sizeof(TYPES) / sizeof(TYPES[0]); ++i)
+    {
+        dispatcher.subscribe(TYPES[i], [this](const SDL_Event &e) { handleEvent(e); });
+    }
+}
+
+void ActionMap::newFrame()
+{
+    mPrevious = mHeld;
+    mPressed.reset();
+    mReleased.reset();
+}
+
+void ActionMap::setInput(int input, bool down)
+{
+    if (down && !mHeld[input])
+    {
+        mPressed.set(input);
+    }
+    else if (!down && mHeld[input])
+    {
+        mReleased.set(input);
+    }
+    mHeld[input] = down;
+}
+
+// Keys let go while another window has focus never send their key up.
+void ActionMap::releaseAll()
+{
+    mReleased |= mHeld;
+    mHeld.reset();
+}
+
+void ActionMap::handleEvent(const SDL_Event &e)
+{
+    switch (e.type)
+    {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        if (!e.key.repeat && e.key.keysym.scancode >= 0 && e.key.keysym.scancode < SDL_NUM_SCANCODES)
+        {
+            setInput(e.key.keysym.scancode, e.type == SDL_KEYDOWN);
+        }
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        setInput(ACTION_INPUT_MOUSE + (e.button.button & 7), e.type == SDL_MOUSEBUTTONDOWN);
+        break;
+    case SDL_CONTROLLERBUTTONDOWN:
+    case SDL_CONTROLLERBUTTONUP:
+        if (e.cbutton.button < SDL_CONTROLLER_BUTTON_MAX)
+        {
+            setInput(ACTION_INPUT_CONTROLLER + e.cbutton.button, e.type == SDL_CONTROLLERBUTTONDOWN);
+        }
+        break;
+    case SDL_CONTROLLERDEVICEADDED:
+    {
+        SDL_GameController *controller = SDL_GameControllerOpen(e.cdevice.which);
+        if (controller != NULL)
+        {
+            mControllers.push_back(controller);
+        }
+        break;
+    }
+    case SDL_CONTROLLERDEVICEREMOVED:
+    {
+        SDL_GameController *controller = SDL_GameControllerFromInstanceID(e.cdevice.which);
+        std::vector<SDL_GameController *>::iterator it = std::find(mControllers.begin(), mControllers.end(), controller);
+        if (it != mControllers.end())
+        {
+            SDL_GameControllerClose(controller);
+            mControllers.erase(it);
+        }
+        break;
+    }
+    case SDL_WINDOWEVENT:
+        if (e.window.event == SDL_WINDOWEVENT_FOCUS_LOST)
+        {
+            releaseAll();
+        }
+        break;
+    }
+}
+
+bool ActionMap::isHeld(int action) const
+{
+    return (mHeld & mMasks[action]).any();
+}
+
+bool ActionMap::isPressed(int action) const
+{
+    // Pressing a second binding of an action already held is not a press.
+    return (mPressed & mMasks[action]).any() && !(mPrevious & mMasks[action]).any();
+}
+
+bool ActionMap::isReleased(int action) const
+{
+    // Letting go of one binding while another is down is not a release.
+    return (mReleased & mMasks[action]).any() && !isHeld(action);
+}
@@ -0,0 +1,81 @@
+#ifndef ACTION_MAP_H
+#define ACTION_MAP_H
+
+#include <SDL2/SDL.h>
+#include <bitset>
+#include <string>
+#include <vector>
+#include "event_dispatcher.h"
+
+// Every bindable input gets one bit: keyboard scancodes, then mouse
+// buttons, then game controller buttons.
+const int ACTION_INPUT_MOUSE = SDL_NUM_SCANCODES;
+const int ACTION_INPUT_CONTROLLER = ACTION_INPUT_MOUSE + 8;
+const int ACTION_INPUT_COUNT = ACTION_INPUT_CONTROLLER + SDL_CONTROLLER_BUTTON_MAX;
+
+typedef std::bitset<ACTION_INPUT_COUNT> InputBits;
+
+// Named actions bound to any number of inputs. Input state is kept as
+// bitsets updated from events, and each action is a mask over them, so a
+// query is a few word-wide ANDs whatever the number of bindings.
+//
+// Bindings load from a config file, one action per line:
+//
+//   # action  inputs...
+//   jump      key:Space  key:W  mouse:left  pad:a
+//
+// Key names are SDL scancode names with '_' for spaces (key:Left_Shift),
+// pad names are SDL controller button names (pad:dpup).
+class ActionMap
+{
+public:
+    ActionMap();
+    ~ActionMap();
+
+    bool loadFromFile(std::string path);
+
+    // Returns the existing id if the action is already known
+    int addAction(std::string name);
+    int findAction(std::string name) const;
+
+    // Parses one input like "key:Up"
+    bool bind(int action, std::string input);
+    void bindKey(int action, SDL_Scancode scancode);
+    void bindMouseButton(int action, Uint8 button);
+    void bindControllerButton(int action, SDL_GameControllerButton button);
+
+    void clear();
+
+    // Routes input events from the dispatcher to handleEvent()
+    void subscribe(EventDispatcher &dispatcher);
+
+    // Starts a frame; call before dispatching its events.
+    void newFrame();
+    void handleEvent(const SDL_Event &e);
+
+    // Held is the current state. Pressed and released compare against the
+    // state at newFrame() plus the edges seen since, so a tap shorter than a
+    // frame is still pressed once.
+    bool isHeld(int action) const;
+    bool isPressed(int action) const;
+    bool isReleased(int action) const;
+
+private:
+    ActionMap(const ActionMap &);
+    ActionMap &operator=(const ActionMap &);
+
+    void setInput(int input, bool down);
+    void releaseAll();
+
+    std::vector<std::string> mNames;
+    std::vector<InputBits> mMasks;
+
+    InputBits mHeld;
+    InputBits mPrevious;
+    InputBits mPressed;
+    InputBits mReleased;
+
+    std::vector<SDL_GameController *> mControllers;
+};
+
+#endif
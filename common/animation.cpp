@@ -0,0 +1,546 @@
+#include "animation.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "profiler.h"
+
+AnimationSet::AnimationSet()
+{
+}
+
+bool AnimationSet::loadFromFile(std::string path)
+{
+    PROFILE_SCOPE("AnimationSet::loadFromFile");
+
+    clear();
+
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cout << "Unable to open animation file " << path << std::endl;
+        return false;
+    }
+
+    std::string animName;
+    AnimationMode animMode = ANIMATION_LOOP;
+    float animSeconds = 0.0f;
+    bool pending = false;
+
+    std::string line;
+    int lineNumber = 0;
+    bool success = true;
+
+    while (success && std::getline(in, line))
+    {
+        ++lineNumber;
+
+        std::istringstream fields(line);
+        std::string command;
+        if (!(fields >> command) || command[0] == '#')
+        {
+            continue;
+        }
+
+        bool valid = true;
+        if (command == "grid")
+        {
+            int cellWidth, cellHeight, columns, rows;
+            int x = 0;
+            int y = 0;
+            valid = (bool)(fields >> cellWidth >> cellHeight >> columns >> rows) && cellWidth > 0 && cellHeight > 0 && columns > 0 && rows > 0;
+            if (valid && fields >> x)
+            {
+                valid = (bool)(fields >> y);
+            }
+            if (valid)
+            {
+                addGrid(cellWidth, cellHeight, columns, rows, x, y);
+            }
+        }
+        else if (command == "frame")
+        {
+            SDL_Rect clip;
+            valid = (bool)(fields >> clip.x >> clip.y >> clip.w >> clip.h) && clip.w > 0 && clip.h > 0;
+            if (valid)
+            {
+                addFrame(clip);
+            }
+        }
+        else if (command == "anim")
+        {
+            std::string mode;
+            float milliseconds;
+            valid = (bool)(fields >> animName >> mode >> milliseconds) && milliseconds > 0.0f;
+            if (mode == "loop")
+            {
+                animMode = ANIMATION_LOOP;
+            }
+            else if (mode == "pingpong")
+            {
+                animMode = ANIMATION_PING_PONG;
+            }
+            else if (mode == "once")
+            {
+                animMode = ANIMATION_ONCE;
+            }
+            else
+            {
+                valid = false;
+            }
+            animSeconds = milliseconds / 1000.0f;
+            pending = valid;
+        }
+        else if (command == "frames" && pending)
+        {
+            std::vector<int> frames;
+            std::vector<float> durations;
+            std::string step;
+            while (valid && fields >> step)
+            {
+                // <index> or <index>:<ms>
+                size_t colon = step.find(':');
+                char *end = NULL;
+                long index = strtol(step.c_str(), &end, 10);
+                valid = end != step.c_str() && index >= 0 && index < getFrameCount();
+
+                float seconds = 0.0f;
+                if (valid && colon != std::string::npos)
+                {
+                    seconds = strtof(step.c_str() + colon + 1, &end) / 1000.0f;
+                    valid = *end == '\0' && seconds > 0.0f;
+                }
+                else if (valid)
+                {
+                    valid = *end == '\0';
+                }
+
+                frames.push_back((int)index);
+                durations.push_back(seconds);
+            }
+
+            valid = valid && !frames.empty() && addAnimation(animName, animMode, frames, animSeconds, durations) >= 0;
+            pending = false;
+        }
+        else if (command == "event" && !mAnimations.empty())
+        {
+            int step;
+            std::string event;
+            valid = (bool)(fields >> step >> event) && step >= 0 && step < (int)mSources.back().frames.size();
+            if (valid)
+            {
+                addEvent((int)mAnimations.size() - 1, step, event);
+            }
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            std::cout << path << ":" << lineNumber << ": cannot parse '" << line << "'" << std::endl;
+            success = false;
+        }
+    }
+
+    if (success && pending)
+    {
+        std::cout << path << ": animation " << animName << " has no frames" << std::endl;
+        success = false;
+    }
+
+    if (!success)
+    {
+        clear();
+    }
+
+    return success;
+}
+
+void AnimationSet::addGrid(int cellWidth, int cellHeight, int columns, int rows, int x, int y)
+{
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            SDL_Rect clip = {x + column * cellWidth, y + row * cellHeight, cellWidth, cellHeight};
+            mFrames.push_back(clip);
+        }
+    }
+}
+
+int AnimationSet::addFrame(SDL_Rect clip)
+{
+    mFrames.push_back(clip);
+    return (int)mFrames.size() - 1;
+}
+
+int AnimationSet::addAnimation(std::string name, AnimationMode mode, const std::vector<int> &frames, float frameSeconds, const std::vector<float> &durations)
+{
+    if (frames.empty() || !(frameSeconds > 0.0f) || !std::isfinite(frameSeconds))
+    {
+        std::cout << "Animation " << name << " needs frames and a frame time" << std::endl;
+        return -1;
+    }
+
+    Source source;
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        if (frames[i] < 0 || frames[i] >= getFrameCount())
+        {
+            std::cout << "Animation " << name << " uses missing frame " << frames[i] << std::endl;
+            return -1;
+        }
+
+        source.frames.push_back(frames[i]);
+        source.durations.push_back(i < durations.size() && durations[i] > 0.0f && std::isfinite(durations[i]) ? durations[i] : frameSeconds);
+    }
+
+    Animation animation;
+    animation.name = name;
+    animation.mode = mode;
+
+    mAnimations.push_back(animation);
+    mSources.push_back(source);
+    buildAnimation((int)mAnimations.size() - 1);
+
+    return (int)mAnimations.size() - 1;
+}
+
+void AnimationSet::addEvent(int animation, int step, std::string event)
+{
+    if (animation < 0 || animation >= (int)mAnimations.size())
+    {
+        return;
+    }
+
+    int id = findEvent(event);
+    if (id < 0)
+    {
+        id = (int)mEventNames.size();
+        mEventNames.push_back(event);
+    }
+
+    mSources[animation].events.push_back(std::make_pair(step, id));
+    buildAnimation(animation);
+}
+
+void AnimationSet::buildAnimation(int index)
+{
+    Animation &animation = mAnimations[index];
+    const Source &source = mSources[index];
+    int count = (int)source.frames.size();
+
+    std::vector<int> order;
+    for (int i = 0; i < count; ++i)
+    {
+        order.push_back(i);
+    }
+    if (animation.mode == ANIMATION_PING_PONG)
+    {
+        for (int i = count - 2; i > 0; --i)
+        {
+            order.push_back(i);
+        }
+    }
+
+    animation.frames.clear();
+    animation.stepEnds.clear();
+    animation.stepEventStart.clear();
+    animation.stepEvents.clear();
+    animation.length = 0.0f;
+
+    bool uniform = true;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        int step = order[i];
+
+        animation.frames.push_back(source.frames[step]);
+        animation.length += source.durations[step];
+        animation.stepEnds.push_back(animation.length);
+        uniform = uniform && source.durations[step] == source.durations[0];
+
+        animation.stepEventStart.push_back((int)animation.stepEvents.size());
+        for (size_t j = 0; j < source.events.size(); ++j)
+        {
+            if (source.events[j].first == step)
+            {
+                animation.stepEvents.push_back(source.events[j].second);
+            }
+        }
+    }
+    animation.stepEventStart.push_back((int)animation.stepEvents.size());
+
+    animation.stepRate = uniform ? 1.0f / source.durations[0] : 0.0f;
+}
+
+void AnimationSet::clear()
+{
+    mFrames.clear();
+    mAnimations.clear();
+    mSources.clear();
+    mEventNames.clear();
+}
+
+int AnimationSet::findAnimation(std::string name) const
+{
+    for (size_t i = 0; i < mAnimations.size(); ++i)
+    {
+        if (mAnimations[i].name == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int AnimationSet::findEvent(std::string name) const
+{
+    for (size_t i = 0; i < mEventNames.size(); ++i)
+    {
+        if (mEventNames[i] == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+const Animation &AnimationSet::getAnimation(int index) const
+{
+    return mAnimations[index];
+}
+
+const SDL_Rect &AnimationSet::getFrame(int index) const
+{
+    return mFrames[index];
+}
+
+const std::string &AnimationSet::getEventName(int id) const
+{
+    return mEventNames[id];
+}
+
+int AnimationSet::getAnimationCount() const
+{
+    return (int)mAnimations.size();
+}
+
+int AnimationSet::getFrameCount() const
+{
+    return (int)mFrames.size();
+}
+
+AnimationPool::AnimationPool(const AnimationSet *set)
+{
+    mSet = set;
+}
+
+void AnimationPool::setAnimationSet(const AnimationSet *set)
+{
+    clear();
+    mSet = set;
+}
+
+void AnimationPool::reserve(int count)
+{
+    mAnimation.reserve(count);
+    mTime.reserve(count);
+    mSpeed.reserve(count);
+    mStep.reserve(count);
+    mFrame.reserve(count);
+}
+
+void AnimationPool::clear()
+{
+    mAnimation.clear();
+    mTime.clear();
+    mSpeed.clear();
+    mStep.clear();
+    mFrame.clear();
+    mEvents.clear();
+}
+
+bool AnimationPool::hasAnimation(int animation) const
+{
+    return mSet != NULL && animation >= 0 && animation < mSet->getAnimationCount();
+}
+
+bool AnimationPool::hasInstance(int instance) const
+{
+    return instance >= 0 && instance < (int)mAnimation.size();
+}
+
+int AnimationPool::spawn(int animation, float speed, float startSeconds)
+{
+    if (!hasAnimation(animation))
+    {
+        std::cout << "Unable to spawn missing animation " << animation << std::endl;
+        return -1;
+    }
+
+    mAnimation.push_back(0);
+    mTime.push_back(0.0f);
+    mSpeed.push_back(0.0f);
+    mStep.push_back(0);
+    mFrame.push_back(0);
+
+    int instance = (int)mAnimation.size() - 1;
+    play(instance, animation, startSeconds);
+    setSpeed(instance, speed);
+
+    return instance;
+}
+
+void AnimationPool::play(int instance, int animation, float startSeconds)
+{
+    if (!hasInstance(instance) || !hasAnimation(animation))
+    {
+        std::cout << "Unable to play animation " << animation << " on instance " << instance << std::endl;
+        return;
+    }
+
+    const Animation &timeline = mSet->getAnimation(animation);
+
+    // A zero-length timeline holds at its start instead of wrapping to NaN
+    float time = SDL_max(startSeconds, 0.0f);
+    if (timeline.mode == ANIMATION_ONCE || timeline.length <= 0.0f)
+    {
+        time = SDL_min(time, timeline.length);
+    }
+    else
+    {
+        time = fmodf(time, timeline.length);
+    }
+
+    mAnimation[instance] = animation;
+    mTime[instance] = time;
+    mStep[instance] = stepAt(timeline, time);
+    mFrame[instance] = timeline.frames[mStep[instance]];
+}
+
+void AnimationPool::setSpeed(int instance, float speed)
+{
+    if (!hasInstance(instance))
+    {
+        return;
+    }
+
+    // Timelines only run forwards; ping-pong is already unrolled.
+    mSpeed[instance] = SDL_max(speed, 0.0f);
+}
+
+int AnimationPool::stepAt(const Animation &animation, float time) const
+{
+    int last = (int)animation.frames.size() - 1;
+    int step;
+    if (animation.stepRate > 0.0f)
+    {
+        step = (int)(time * animation.stepRate);
+    }
+    else
+    {
+        step = (int)(std::upper_bound(animation.stepEnds.begin(), animation.stepEnds.end(), time) - animation.stepEnds.begin());
+    }
+    return SDL_min(step, last);
+}
+
+void AnimationPool::collectEvents(int instance, const Animation &animation, int fromStep, int toStep, int wraps)
+{
+    int count = (int)animation.frames.size();
+
+    // A long hitch fires each event at most once rather than once per lap.
+    int crossed = SDL_min(wraps * count + toStep - fromStep, count);
+    for (int i = 1; i <= crossed; ++i)
+    {
+        int step = (fromStep + i) % count;
+        for (int j = animation.stepEventStart[step]; j < animation.stepEventStart[step + 1]; ++j)
+        {
+            AnimationEventHit hit = {instance, animation.stepEvents[j]};
+            mEvents.push_back(hit);
+        }
+    }
+}
+
+void AnimationPool::update(double dt)
+{
+    PROFILE_SCOPE("AnimationPool::update");
+
+    mEvents.clear();
+    if (mSet == NULL)
+    {
+        return;
+    }
+
+    float delta = (float)dt;
+    int count = (int)mAnimation.size();
+
+    for (int i = 0; i < count; ++i)
+    {
+        const Animation &animation = mSet->getAnimation(mAnimation[i]);
+
+        float time = mTime[i] + delta * mSpeed[i];
+        int wraps = 0;
+        if (time >= animation.length)
+        {
+            if (animation.mode == ANIMATION_ONCE || animation.length <= 0.0f)
+            {
+                time = animation.length;
+            }
+            else
+            {
+                wraps = (int)(time / animation.length);
+                time -= wraps * animation.length;
+            }
+        }
+
+        int step = stepAt(animation, time);
+        if (!animation.stepEvents.empty() && (step != mStep[i] || wraps > 0))
+        {
+            collectEvents(i, animation, mStep[i], step, wraps);
+        }
+
+        mTime[i] = time;
+        mStep[i] = step;
+        mFrame[i] = animation.frames[step];
+    }
+}
+
+int AnimationPool::getCount() const
+{
+    return (int)mAnimation.size();
+}
+
+int AnimationPool::getAnimation(int instance) const
+{
+    return hasInstance(instance) ? mAnimation[instance] : -1;
+}
+
+int AnimationPool::getFrame(int instance) const
+{
+    return hasInstance(instance) ? mFrame[instance] : -1;
+}
+
+const SDL_Rect *AnimationPool::getClip(int instance) const
+{
+    return hasInstance(instance) ? &mSet->getFrame(mFrame[instance]) : NULL;
+}
+
+bool AnimationPool::isFinished(int instance) const
+{
+    if (!hasInstance(instance))
+    {
+        return false;
+    }
+
+    const Animation &animation = mSet->getAnimation(mAnimation[instance]);
+    return animation.mode == ANIMATION_ONCE && mTime[instance] >= animation.length;
+}
+
+const std::vector<AnimationEventHit> &AnimationPool::getEvents() const
+{
+    return mEvents;
+}
@@ -0,0 +1,142 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+enum AnimationMode
+{
+    ANIMATION_LOOP,
+    ANIMATION_PING_PONG,
+    ANIMATION_ONCE
+};
+
+// One timeline. Ping-pong timelines are unrolled when they are added
+// (0 1 2 3 becomes 0 1 2 3 2 1), so playback only ever loops or clamps.
+struct Animation
+{
+    std::string name;
+    AnimationMode mode;
+
+    std::vector<int> frames;
+    std::vector<float> stepEnds;
+    float length;
+
+    // Set when every step lasts the same time, so the step is one multiply.
+    float stepRate;
+
+    // Event ids fired when a step starts, stepEventStart[step] to
+    // stepEventStart[step + 1] in stepEvents.
+    std::vector<int> stepEventStart;
+    std::vector<int> stepEvents;
+};
+
+// Frames and timelines shared by every instance, loaded from a .anim file:
+//
+//   # comment
+//   grid <cellW> <cellH> <columns> <rows> [<x> <y>]   frames, row by row
+//   frame <x> <y> <w> <h>                            one more frame
+//   anim <name> <loop|pingpong|once> <ms per frame>  start a timeline
+//   frames <index>[:<ms>] ...                        its steps
+//   event <step> <name>                              fire name at a step
+//
+// Frames are numbered in the order they are declared.
+class AnimationSet
+{
+public:
+    AnimationSet();
+
+    bool loadFromFile(std::string path);
+
+    void addGrid(int cellWidth, int cellHeight, int columns, int rows, int x = 0, int y = 0);
+    int addFrame(SDL_Rect clip);
+
+    // Durations are in seconds; steps without their own use frameSeconds.
+    int addAnimation(std::string name, AnimationMode mode, const std::vector<int> &frames, float frameSeconds, const std::vector<float> &durations = std::vector<float>());
+    void addEvent(int animation, int step, std::string event);
+
+    void clear();
+
+    int findAnimation(std::string name) const;
+    int findEvent(std::string name) const;
+
+    const Animation &getAnimation(int index) const;
+    const SDL_Rect &getFrame(int index) const;
+    const std::string &getEventName(int id) const;
+
+    int getAnimationCount() const;
+    int getFrameCount() const;
+
+private:
+    // A timeline as declared, before ping-pong unrolling
+    struct Source
+    {
+        std::vector<int> frames;
+        std::vector<float> durations;
+        std::vector<std::pair<int, int> > events;
+    };
+
+    void buildAnimation(int index);
+
+    std::vector<SDL_Rect> mFrames;
+    std::vector<Animation> mAnimations;
+    std::vector<Source> mSources;
+    std::vector<std::string> mEventNames;
+};
+
+struct AnimationEventHit
+{
+    int instance;
+    int event;
+};
+
+// Playback state for many instances of one AnimationSet, stored as parallel
+// arrays so update() is a tight loop over plain numbers.
+class AnimationPool
+{
+public:
+    AnimationPool(const AnimationSet *set = NULL);
+
+    void setAnimationSet(const AnimationSet *set);
+
+    void reserve(int count);
+    void clear();
+
+    // Returns the new instance index, or -1 if animation is not in the set
+    int spawn(int animation, float speed = 1.0f, float startSeconds = 0.0f);
+
+    void play(int instance, int animation, float startSeconds = 0.0f);
+    void setSpeed(int instance, float speed);
+
+    void update(double dt);
+
+    // Invalid instances give -1, NULL or false
+    int getCount() const;
+    int getAnimation(int instance) const;
+    int getFrame(int instance) const;
+    const SDL_Rect *getClip(int instance) const;
+    bool isFinished(int instance) const;
+
+    // Events crossed during the last update
+    const std::vector<AnimationEventHit> &getEvents() const;
+
+private:
+    bool hasAnimation(int animation) const;
+    bool hasInstance(int instance) const;
+
+    int stepAt(const Animation &animation, float time) const;
+    void collectEvents(int instance, const Animation &animation, int fromStep, int toStep, int wraps);
+
+    const AnimationSet *mSet;
+
+    std::vector<int> mAnimation;
+    std::vector<float> mTime;
+    std::vector<float> mSpeed;
+    std::vector<int> mStep;
+    std::vector<int> mFrame;
+
+    std::vector<AnimationEventHit> mEvents;
+};
+
+#endif
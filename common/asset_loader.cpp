@@ -0,0 +1,360 @@
+#include "asset_loader.h"
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include "profiler.h"
+
+ImageRequest::ImageRequest()
+{
+    colorKey = true;
+    upload = true;
+    surface = NULL;
+    texture = NULL;
+    width = 0;
+    height = 0;
+    state = ASSET_PENDING;
+}
+
+ImageRequest::~ImageRequest()
+{
+    if (texture != NULL)
+    {
+        SDL_DestroyTexture(texture);
+    }
+    if (surface != NULL)
+    {
+        SDL_FreeSurface(surface);
+    }
+}
+
+bool ImageRequest::isReady() const
+{
+    return state == ASSET_READY;
+}
+
+bool ImageRequest::isFailed() const
+{
+    return state == ASSET_FAILED;
+}
+
+FontRequest::FontRequest()
+{
+    pointSize = 0;
+    font = NULL;
+    state = ASSET_PENDING;
+}
+
+FontRequest::~FontRequest()
+{
+    if (font != NULL)
+    {
+        TTF_CloseFont(font);
+    }
+}
+
+bool FontRequest::isReady() const
+{
+    return state == ASSET_READY;
+}
+
+bool FontRequest::isFailed() const
+{
+    return state == ASSET_FAILED;
+}
+
+AssetLoader::AssetLoader()
+{
+    mStopping = false;
+    mOutstanding = 0;
+}
+
+AssetLoader::~AssetLoader()
+{
+    stop();
+}
+
+bool AssetLoader::start(int workerCount)
+{
+    if (!mWorkers.empty())
+    {
+        return true;
+    }
+
+    if (workerCount <= 0)
+    {
+        workerCount = SDL_GetCPUCount() - 1;
+        if (workerCount < 1)
+        {
+            workerCount = 1;
+        }
+    }
+
+    mStopping = false;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        mWorkers.push_back(std::thread(&AssetLoader::workerLoop, this));
+    }
+
+    return true;
+}
+
+void AssetLoader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mJobMutex);
+        mStopping = true;
+    }
+    mJobReady.notify_all();
+
+    for (size_t i = 0; i < mWorkers.size(); ++i)
+    {
+        mWorkers[i].join();
+    }
+    mWorkers.clear();
+
+    // Nothing will pick these up any more; fail them so pollers stop waiting.
+    for (size_t i = 0; i < mJobs.size(); ++i)
+    {
+        if (mJobs[i].image)
+        {
+            mJobs[i].image->state = ASSET_FAILED;
+        }
+        if (mJobs[i].font)
+        {
+            mJobs[i].font->state = ASSET_FAILED;
+        }
+    }
+    mJobs.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(mUploadMutex);
+        for (size_t i = 0; i < mUploads.size(); ++i)
+        {
+            mUploads[i]->state = ASSET_FAILED;
+        }
+        mUploads.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mDoneMutex);
+        mOutstanding = 0;
+    }
+    mDone.notify_all();
+}
+
+void AssetLoader::enqueue(const Job &job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mJobMutex);
+
+        // No worker will run it, and counting it would keep finish() waiting
+        if (mStopping)
+        {
+            if (job.image)
+            {
+                job.image->state = ASSET_FAILED;
+            }
+            if (job.font)
+            {
+                job.font->state = ASSET_FAILED;
+            }
+            return;
+        }
+
+        ++mOutstanding;
+        mJobs.push_back(job);
+    }
+    mJobReady.notify_one();
+}
+
+ImageHandle AssetLoader::loadImage(std::string path, bool colorKey, bool upload)
+{
+    ImageHandle image = std::make_shared<ImageRequest>();
+    image->path = path;
+    image->colorKey = colorKey;
+    image->upload = upload;
+
+    Job job;
+    job.image = image;
+    enqueue(job);
+
+    return image;
+}
+
+FontHandle AssetLoader::loadFont(std::string path, int pointSize)
+{
+    FontHandle font = std::make_shared<FontRequest>();
+    font->path = path;
+    font->pointSize = pointSize;
+
+    Job job;
+    job.font = font;
+    enqueue(job);
+
+    return font;
+}
+
+void AssetLoader::workerLoop()
+{
+    PROFILE_THREAD("asset loader");
+
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mJobMutex);
+            while (!mStopping && mJobs.empty())
+            {
+                mJobReady.wait(lock);
+            }
+
+            if (mStopping)
+            {
+                return;
+            }
+
+            job = mJobs.front();
+            mJobs.pop_front();
+        }
+
+        if (job.image)
+        {
+            decodeImage(job.image);
+        }
+        else if (job.font)
+        {
+            decodeFont(job.font);
+        }
+    }
+}
+
+void AssetLoader::decodeImage(ImageHandle image)
+{
+    PROFILE_SCOPE("AssetLoader::decodeImage");
+
+    SDL_Surface *loadedSurface = IMG_Load(image->path.c_str());
+    if (loadedSurface == NULL)
+    {
+        std::cout << "Unable to load image " << image->path << "! SDL_image error: " << IMG_GetError() << std::endl;
+        image->state = ASSET_FAILED;
+    }
+    else
+    {
+        if (image->colorKey)
+        {
+            SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
+        }
+
+        image->surface = loadedSurface;
+        image->width = loadedSurface->w;
+        image->height = loadedSurface->h;
+        image->state = image->upload ? ASSET_DECODED : ASSET_READY;
+    }
+
+    if (image->state == ASSET_DECODED)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mUploadMutex);
+            mUploads.push_back(image);
+        }
+        mDone.notify_all();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mDoneMutex);
+    --mOutstanding;
+    mDone.notify_all();
+}
+
+void AssetLoader::decodeFont(FontHandle font)
+{
+    PROFILE_SCOPE("AssetLoader::decodeFont");
+
+    // FreeType shares one library object between fonts, so opening is
+    // serialized; it still keeps the work off the main thread.
+    {
+        std::lock_guard<std::mutex> lock(mFontMutex);
+        font->font = TTF_OpenFont(font->path.c_str(), font->pointSize);
+    }
+
+    if (font->font == NULL)
+    {
+        std::cout << "Unable to open font " << font->path << "! SDL_ttf error: " << SDL_GetError() << std::endl;
+        font->state = ASSET_FAILED;
+    }
+    else
+    {
+        font->state = ASSET_READY;
+    }
+
+    std::lock_guard<std::mutex> lock(mDoneMutex);
+    --mOutstanding;
+    mDone.notify_all();
+}
+
+int AssetLoader::uploadPending(SDL_Renderer *renderer, double budgetMs)
+{
+    PROFILE_SCOPE("AssetLoader::uploadPending");
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 budget = (Uint64)(budgetMs * SDL_GetPerformanceFrequency() / 1000.0);
+    int uploaded = 0;
+
+    while (true)
+    {
+        ImageHandle image;
+        {
+            std::lock_guard<std::mutex> lock(mUploadMutex);
+            if (mUploads.empty())
+            {
+                break;
+            }
+            image = mUploads.front();
+            mUploads.pop_front();
+        }
+
+        image->texture = SDL_CreateTextureFromSurface(renderer, image->surface);
+        SDL_FreeSurface(image->surface);
+        image->surface = NULL;
+
+        if (image->texture == NULL)
+        {
+            std::cout << "Unable to create texture from " << image->path << "! SDL error: " << SDL_GetError() << std::endl;
+            image->state = ASSET_FAILED;
+        }
+        else
+        {
+            image->state = ASSET_READY;
+        }
+
+        ++uploaded;
+        {
+            std::lock_guard<std::mutex> lock(mDoneMutex);
+            --mOutstanding;
+            mDone.notify_all();
+        }
+
+        if (SDL_GetPerformanceCounter() - start >= budget)
+        {
+            break;
+        }
+    }
+
+    return uploaded;
+}
+
+void AssetLoader::finish(SDL_Renderer *renderer)
+{
+    while (!isIdle())
+    {
+        if (uploadPending(renderer, 1000.0) == 0)
+        {
+            std::unique_lock<std::mutex> lock(mDoneMutex);
+            mDone.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+}
+
+bool AssetLoader::isIdle()
+{
+    return mOutstanding == 0;
+}
@@ -0,0 +1,118 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum AssetState
+{
+    ASSET_PENDING,
+    ASSET_DECODED,
+    ASSET_READY,
+    ASSET_FAILED
+};
+
+// Images are decoded on a worker and, when upload is requested, turned into
+// a texture on the main thread. The request owns whatever it holds, so the
+// last handle must be released on the main thread before the renderer dies.
+struct ImageRequest
+{
+    ImageRequest();
+    ~ImageRequest();
+
+    bool isReady() const;
+    bool isFailed() const;
+
+    std::string path;
+    bool colorKey;
+    bool upload;
+
+    SDL_Surface *surface;
+    SDL_Texture *texture;
+    int width;
+    int height;
+
+    std::atomic<int> state;
+};
+
+struct FontRequest
+{
+    FontRequest();
+    ~FontRequest();
+
+    bool isReady() const;
+    bool isFailed() const;
+
+    std::string path;
+    int pointSize;
+
+    TTF_Font *font;
+
+    std::atomic<int> state;
+};
+
+typedef std::shared_ptr<ImageRequest> ImageHandle;
+typedef std::shared_ptr<FontRequest> FontHandle;
+
+class AssetLoader
+{
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    bool start(int workerCount = 0);
+
+    // Requests not decoded or uploaded yet are marked failed, as are any
+    // made after this until the next start().
+    void stop();
+
+    ImageHandle loadImage(std::string path, bool colorKey = true, bool upload = true);
+    FontHandle loadFont(std::string path, int pointSize);
+
+    int uploadPending(SDL_Renderer *renderer, double budgetMs);
+
+    void finish(SDL_Renderer *renderer);
+
+    bool isIdle();
+
+private:
+    AssetLoader(const AssetLoader &);
+    AssetLoader &operator=(const AssetLoader &);
+
+    struct Job
+    {
+        ImageHandle image;
+        FontHandle font;
+    };
+
+    void workerLoop();
+    void decodeImage(ImageHandle image);
+    void decodeFont(FontHandle font);
+    void enqueue(const Job &job);
+
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mJobMutex;
+    std::condition_variable mJobReady;
+    std::deque<Job> mJobs;
+    bool mStopping;
+
+    std::mutex mUploadMutex;
+    std::deque<ImageHandle> mUploads;
+
+    std::mutex mDoneMutex;
+    std::condition_variable mDone;
+    std::atomic<int> mOutstanding;
+
+    std::mutex mFontMutex;
+};
+
+#endif
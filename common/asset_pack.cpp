@@ -0,0 +1,318 @@
+#include "asset_pack.h"
+#include <cstring>
+#include <iostream>
+#include "profiler.h"
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack::AssetPack()
+{
+    mData = NULL;
+    mSize = 0;
+    mHeader = NULL;
+    mPageTable = NULL;
+}
+
+AssetPack::~AssetPack()
+{
+    free();
+}
+
+bool AssetPack::open(std::string path)
+{
+    PROFILE_SCOPE("AssetPack::open");
+
+    free();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cout << "Unable to open asset pack " << path << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        // Private and writable so surfaces handed out by createSurface() can
+        // be written to without touching the file.
+        void *mapping = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            mData = (Uint8 *)mapping;
+            mSize = info.st_size;
+            madvise(mapping, mSize, MADV_WILLNEED);
+        }
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (in)
+    {
+        mBuffer.resize((size_t)in.tellg());
+        in.seekg(0);
+        if (in.read((char *)mBuffer.data(), mBuffer.size()))
+        {
+            mData = mBuffer.data();
+            mSize = mBuffer.size();
+        }
+    }
+#endif
+
+    if (mData == NULL)
+    {
+        std::cout << "Unable to map asset pack " << path << std::endl;
+        return false;
+    }
+
+    if (!validate())
+    {
+        std::cout << "Asset pack " << path << " is corrupt or from another version" << std::endl;
+        free();
+        return false;
+    }
+
+    return true;
+}
+
+bool AssetPack::validate()
+{
+    if (mSize < sizeof(AssetPackHeader))
+    {
+        return false;
+    }
+
+    mHeader = (const AssetPackHeader *)mData;
+    if (mHeader->magic != ASSET_PACK_MAGIC || mHeader->version != ASSET_PACK_VERSION ||
+        mHeader->pixelFormat != SDL_PIXELFORMAT_ARGB8888)
+    {
+        return false;
+    }
+
+    size_t tablesSize = sizeof(AssetPackHeader) + (size_t)mHeader->pageCount * sizeof(AssetPackPage) +
+                        (size_t)mHeader->spriteCount * sizeof(AssetPackSprite) +
+                        (size_t)mHeader->clipCount * sizeof(AssetPackClip) + mHeader->stringBytes;
+    if (tablesSize > mSize)
+    {
+        return false;
+    }
+
+    mPageTable = (const AssetPackPage *)(mHeader + 1);
+    const AssetPackSprite *sprites = (const AssetPackSprite *)(mPageTable + mHeader->pageCount);
+    const AssetPackClip *clips = (const AssetPackClip *)(sprites + mHeader->spriteCount);
+    const char *strings = (const char *)(clips + mHeader->clipCount);
+
+    for (Uint32 i = 0; i < mHeader->pageCount; ++i)
+    {
+        const AssetPackPage &page = mPageTable[i];
+        if (page.width == 0 || page.height == 0 || (Uint64)page.pitch < (Uint64)page.width * 4 ||
+            page.offset > mSize || (Uint64)page.pitch * page.height > mSize - page.offset)
+        {
+            return false;
+        }
+    }
+
+    mClips.resize(mHeader->clipCount);
+    for (Uint32 i = 0; i < mHeader->clipCount; ++i)
+    {
+        SDL_Rect clip = {clips[i].x, clips[i].y, clips[i].w, clips[i].h};
+        mClips[i] = clip;
+    }
+
+    for (Uint32 i = 0; i < mHeader->spriteCount; ++i)
+    {
+        const AssetPackSprite &sprite = sprites[i];
+        if (sprite.page >= mHeader->pageCount || sprite.nameOffset >= mHeader->stringBytes ||
+            (Uint64)sprite.firstClip + sprite.clipCount > mHeader->clipCount)
+        {
+            return false;
+        }
+
+        const AssetPackPage &page = mPageTable[sprite.page];
+        if (sprite.x < 0 || sprite.y < 0 || sprite.w <= 0 || sprite.h <= 0 ||
+            (Uint64)sprite.x + sprite.w > page.width || (Uint64)sprite.y + sprite.h > page.height)
+        {
+            return false;
+        }
+
+        const char *name = strings + sprite.nameOffset;
+        size_t nameLength = strnlen(name, mHeader->stringBytes - sprite.nameOffset);
+        if (nameLength == mHeader->stringBytes - sprite.nameOffset)
+        {
+            return false;
+        }
+
+        Entry entry;
+        entry.sprite.texture = NULL;
+        entry.sprite.clip.x = sprite.x;
+        entry.sprite.clip.y = sprite.y;
+        entry.sprite.clip.w = sprite.w;
+        entry.sprite.clip.h = sprite.h;
+        entry.sprite.page = sprite.page;
+        entry.firstClip = sprite.firstClip;
+        entry.clipCount = sprite.clipCount;
+        entry.flags = sprite.flags;
+
+        mEntries[std::string(name, nameLength)] = entry;
+    }
+
+    return true;
+}
+
+bool AssetPack::upload(SDL_Renderer *renderer)
+{
+    PROFILE_SCOPE("AssetPack::upload");
+
+    if (mHeader == NULL)
+    {
+        return false;
+    }
+
+    // Uploading again, e.g. for a new renderer, replaces the old pages
+    freePages();
+
+    for (Uint32 i = 0; i < mHeader->pageCount; ++i)
+    {
+        const AssetPackPage &page = mPageTable[i];
+
+        SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, page.width, page.height);
+        if (texture == NULL)
+        {
+            std::cout << "Unable to create asset pack page! SDL error: " << SDL_GetError() << std::endl;
+            freePages();
+            return false;
+        }
+
+        // The mapped pixels are already in the texture format, so this is
+        // the only copy between the file and the GPU.
+        if (SDL_UpdateTexture(texture, NULL, mData + page.offset, page.pitch) < 0)
+        {
+            std::cout << "Unable to upload asset pack page! SDL error: " << SDL_GetError() << std::endl;
+            SDL_DestroyTexture(texture);
+            freePages();
+            return false;
+        }
+
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        mPages.push_back(texture);
+    }
+
+    for (std::map<std::string, Entry>::iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+    {
+        it->second.sprite.texture = mPages[it->second.sprite.page];
+    }
+
+    return true;
+}
+
+void AssetPack::freePages()
+{
+    for (size_t i = 0; i < mPages.size(); ++i)
+    {
+        SDL_DestroyTexture(mPages[i]);
+    }
+    mPages.clear();
+
+    for (std::map<std::string, Entry>::iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+    {
+        it->second.sprite.texture = NULL;
+    }
+}
+
+void AssetPack::free()
+{
+    freePages();
+    mClips.clear();
+    mEntries.clear();
+
+#ifndef _WIN32
+    if (mData != NULL)
+    {
+        munmap(mData, mSize);
+    }
+#endif
+    mBuffer.clear();
+
+    mData = NULL;
+    mSize = 0;
+    mHeader = NULL;
+    mPageTable = NULL;
+}
+
+AssetPack::Entry *AssetPack::find(std::string name)
+{
+    std::map<std::string, Entry>::iterator it = mEntries.find(name);
+    if (it == mEntries.end())
+    {
+        return NULL;
+    }
+    return &it->second;
+}
+
+AtlasSprite *AssetPack::getSprite(std::string name)
+{
+    Entry *entry = find(name);
+    return entry != NULL ? &entry->sprite : NULL;
+}
+
+int AssetPack::getClipCount(std::string name)
+{
+    Entry *entry = find(name);
+    return entry != NULL ? entry->clipCount : 0;
+}
+
+SDL_Rect *AssetPack::getClips(std::string name)
+{
+    Entry *entry = find(name);
+    if (entry == NULL || entry->clipCount == 0)
+    {
+        return NULL;
+    }
+    return &mClips[entry->firstClip];
+}
+
+SDL_Surface *AssetPack::createSurface(std::string name)
+{
+    Entry *entry = find(name);
+    if (entry == NULL)
+    {
+        return NULL;
+    }
+
+    const AssetPackPage &page = mPageTable[entry->sprite.page];
+    const SDL_Rect &clip = entry->sprite.clip;
+    Uint8 *pixels = mData + page.offset + clip.y * page.pitch + clip.x * 4;
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(pixels, clip.w, clip.h, 32, page.pitch, SDL_PIXELFORMAT_ARGB8888);
+    if (surface == NULL)
+    {
+        std::cout << "Unable to create surface for " << name << "! SDL error: " << SDL_GetError() << std::endl;
+        return NULL;
+    }
+
+    SDL_SetSurfaceBlendMode(surface, entry->flags & ASSET_PACK_SPRITE_OPAQUE ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+
+    return surface;
+}
+
+int AssetPack::getPageCount()
+{
+    return (int)mPages.size();
+}
+
+SDL_Texture *AssetPack::getPage(int index)
+{
+    if (index < 0 || index >= (int)mPages.size())
+    {
+        return NULL;
+    }
+    return mPages[index];
+}
@@ -0,0 +1,130 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <SDL2/SDL.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "texture_atlas.h"
+
+// On-disk layout written by tools/asset_packer. Everything is native byte
+// order; page pixels are ARGB8888 and start on an ASSET_PACK_ALIGNMENT
+// boundary so they can be handed to SDL straight from the mapping.
+//
+//   AssetPackHeader
+//   AssetPackPage[pageCount]
+//   AssetPackSprite[spriteCount]
+//   AssetPackClip[clipCount]
+//   char strings[stringBytes]
+//   page pixels
+const Uint32 ASSET_PACK_MAGIC = 0x4B50534D;
+const Uint32 ASSET_PACK_VERSION = 1;
+const Uint32 ASSET_PACK_ALIGNMENT = 4096;
+
+// Every pixel is opaque, so surface blits can skip blending.
+const Uint32 ASSET_PACK_SPRITE_OPAQUE = 1;
+
+struct AssetPackHeader
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 pixelFormat;
+    Uint32 pageCount;
+    Uint32 spriteCount;
+    Uint32 clipCount;
+    Uint32 stringBytes;
+    Uint32 reserved;
+};
+
+struct AssetPackPage
+{
+    Uint32 width;
+    Uint32 height;
+    Uint32 pitch;
+    Uint32 reserved;
+    Uint64 offset;
+};
+
+struct AssetPackSprite
+{
+    Uint32 nameOffset;
+    Uint32 page;
+    Sint32 x;
+    Sint32 y;
+    Sint32 w;
+    Sint32 h;
+    Uint32 firstClip;
+    Uint32 clipCount;
+    Uint32 flags;
+    Uint32 reserved;
+};
+
+// Sub-rectangles relative to their sprite, e.g. animation frames.
+struct AssetPackClip
+{
+    Sint32 x;
+    Sint32 y;
+    Sint32 w;
+    Sint32 h;
+};
+
+// Read side of a pack: one mapping, one texture upload per page and no
+// decoding at startup.
+class AssetPack
+{
+public:
+    AssetPack();
+    ~AssetPack();
+
+    // Maps the file and validates its tables
+    bool open(std::string path);
+
+    // Creates one static texture per page from the mapped pixels, replacing
+    // any from an earlier call. On failure no pages are left.
+    bool upload(SDL_Renderer *renderer);
+
+    // Destroys the textures and unmaps the file
+    void free();
+
+    AtlasSprite *getSprite(std::string name);
+
+    // Clips of a sprite, relative to the sprite's top left corner
+    int getClipCount(std::string name);
+    SDL_Rect *getClips(std::string name);
+
+    // Surface that points into the mapping for software blits; the caller
+    // frees it, and it is only valid while the pack stays open.
+    SDL_Surface *createSurface(std::string name);
+
+    int getPageCount();
+    SDL_Texture *getPage(int index);
+
+private:
+    AssetPack(const AssetPack &);
+    AssetPack &operator=(const AssetPack &);
+
+    struct Entry
+    {
+        AtlasSprite sprite;
+        Uint32 firstClip;
+        Uint32 clipCount;
+        Uint32 flags;
+    };
+
+    bool validate();
+    void freePages();
+    Entry *find(std::string name);
+
+    Uint8 *mData;
+    size_t mSize;
+    std::vector<Uint8> mBuffer;
+
+    const AssetPackHeader *mHeader;
+    const AssetPackPage *mPageTable;
+
+    std::vector<SDL_Texture *> mPages;
+    std::vector<SDL_Rect> mClips;
+    std::map<std::string, Entry> mEntries;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "camera.h"
+#include <cmath>
+
+const float MIN_ZOOM = 1.0f / 64.0f;
+
+Camera::Camera()
+{
+    mX = 0.0f;
+    mY = 0.0f;
+    mZoom = 1.0f;
+    mViewWidth = 0;
+    mViewHeight = 0;
+}
+
+void Camera::setViewSize(int width, int height)
+{
+    mViewWidth = width;
+    mViewHeight = height;
+}
+
+void Camera::setPosition(float x, float y)
+{
+    mX = x;
+    mY = y;
+}
+
+void Camera::move(float dx, float dy)
+{
+    mX += dx;
+    mY += dy;
+}
+
+void Camera::setZoom(float zoom)
+{
+    mZoom = zoom < MIN_ZOOM ? MIN_ZOOM : zoom;
+}
+
+float Camera::getX() const
+{
+    return mX;
+}
+
+float Camera::getY() const
+{
+    return mY;
+}
+
+float Camera::getZoom() const
+{
+    return mZoom;
+}
+
+int Camera::getViewWidth() const
+{
+    return mViewWidth;
+}
+
+int Camera::getViewHeight() const
+{
+    return mViewHeight;
+}
+
+SDL_FRect Camera::getWorldRect() const
+{
+    SDL_FRect rect;
+    rect.w = mViewWidth / mZoom;
+    rect.h = mViewHeight / mZoom;
+    rect.x = mX - rect.w / 2.0f;
+    rect.y = mY - rect.h / 2.0f;
+    return rect;
+}
+
+SDL_Rect Camera::getVisibleBounds() const
+{
+    SDL_FRect view = getWorldRect();
+
+    SDL_Rect bounds;
+    bounds.x = (int)floorf(view.x);
+    bounds.y = (int)floorf(view.y);
+    bounds.w = (int)ceilf(view.x + view.w) - bounds.x;
+    bounds.h = (int)ceilf(view.y + view.h) - bounds.y;
+    return bounds;
+}
+
+bool Camera::isVisible(const SDL_Rect &bounds) const
+{
+    SDL_FRect view = getWorldRect();
+    return bounds.x < view.x + view.w && bounds.x + bounds.w > view.x &&
+           bounds.y < view.y + view.h && bounds.y + bounds.h > view.y;
+}
+
+SDL_FPoint Camera::worldToScreen(float x, float y) const
+{
+    SDL_FPoint point;
+    point.x = (x - mX) * mZoom + mViewWidth / 2.0f;
+    point.y = (y - mY) * mZoom + mViewHeight / 2.0f;
+    return point;
+}
+
+SDL_FPoint Camera::screenToWorld(float x, float y) const
+{
+    SDL_FPoint point;
+    point.x = (x - mViewWidth / 2.0f) / mZoom + mX;
+    point.y = (y - mViewHeight / 2.0f) / mZoom + mY;
+    return point;
+}
+
+SDL_Rect Camera::worldToScreen(const SDL_Rect &bounds) const
+{
+    SDL_FPoint topLeft = worldToScreen((float)bounds.x, (float)bounds.y);
+    SDL_FPoint bottomRight = worldToScreen((float)(bounds.x + bounds.w), (float)(bounds.y + bounds.h));
+
+    SDL_Rect rect;
+    rect.x = (int)floorf(topLeft.x + 0.5f);
+    rect.y = (int)floorf(topLeft.y + 0.5f);
+    rect.w = (int)floorf(bottomRight.x + 0.5f) - rect.x;
+    rect.h = (int)floorf(bottomRight.y + 0.5f) - rect.y;
+    return rect;
+}
@@ -0,0 +1,49 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <SDL2/SDL.h>
+
+// 2D camera over a world measured in pixels at zoom 1. The position is the
+// world point shown at the center of the view.
+class Camera
+{
+public:
+    Camera();
+
+    void setViewSize(int width, int height);
+    void setPosition(float x, float y);
+    void move(float dx, float dy);
+
+    // Clamped to a small positive minimum
+    void setZoom(float zoom);
+
+    float getX() const;
+    float getY() const;
+    float getZoom() const;
+    int getViewWidth() const;
+    int getViewHeight() const;
+
+    // World area currently in view
+    SDL_FRect getWorldRect() const;
+
+    // The same area rounded out to whole pixels, for spatial queries
+    SDL_Rect getVisibleBounds() const;
+
+    bool isVisible(const SDL_Rect &bounds) const;
+
+    // Screen coordinates are relative to the view's top left.
+    SDL_FPoint worldToScreen(float x, float y) const;
+    SDL_FPoint screenToWorld(float x, float y) const;
+
+    // Edges are rounded separately so neighbouring rects stay seamless.
+    SDL_Rect worldToScreen(const SDL_Rect &bounds) const;
+
+private:
+    float mX;
+    float mY;
+    float mZoom;
+    int mViewWidth;
+    int mViewHeight;
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "cell_grid.h"
+
+CellGrid::CellGrid()
+{
+    reset(64);
+}
+
+void CellGrid::reset(int cellSize, int columns, int rows)
+{
+    mCellSize = SDL_max(cellSize, 1);
+    mColumns = columns > 0 && rows > 0 ? columns : 0;
+    mRows = mColumns > 0 ? rows : 0;
+
+    mDenseCells.clear();
+    mDenseCells.resize(mColumns * mRows);
+    mHashedCells.clear();
+
+    mBounds.clear();
+    mActive.clear();
+    mFreeIds.clear();
+    mCount = 0;
+}
+
+Uint64 CellGrid::cellKey(int x, int y)
+{
+    return ((Uint64)(Uint32)x << 32) | (Uint32)y;
+}
+
+// Rounds toward negative infinity, so cells left of and above the origin
+// do not collapse into cell 0.
+static int cellOf(int value, int cellSize)
+{
+    return value >= 0 ? value / cellSize : -((-value + cellSize - 1) / cellSize);
+}
+
+void CellGrid::cellRange(const SDL_Rect &bounds, int *x0, int *y0, int *x1, int *y1) const
+{
+    *x0 = cellOf(bounds.x, mCellSize);
+    *y0 = cellOf(bounds.y, mCellSize);
+    *x1 = cellOf(bounds.x + bounds.w - 1, mCellSize);
+    *y1 = cellOf(bounds.y + bounds.h - 1, mCellSize);
+
+    if (mColumns > 0)
+    {
+        *x0 = SDL_min(SDL_max(*x0, 0), mColumns - 1);
+        *y0 = SDL_min(SDL_max(*y0, 0), mRows - 1);
+        *x1 = SDL_min(SDL_max(*x1, 0), mColumns - 1);
+        *y1 = SDL_min(SDL_max(*y1, 0), mRows - 1);
+    }
+}
+
+std::vector<int> *CellGrid::findCell(int x, int y, bool create)
+{
+    if (mColumns > 0)
+    {
+        return &mDenseCells[y * mColumns + x];
+    }
+
+    if (create)
+    {
+        return &mHashedCells[cellKey(x, y)];
+    }
+
+    std::unordered_map<Uint64, std::vector<int> >::iterator it = mHashedCells.find(cellKey(x, y));
+    return it != mHashedCells.end() ? &it->second : NULL;
+}
+
+const std::vector<int> *CellGrid::getCell(int x, int y) const
+{
+    if (mColumns > 0)
+    {
+        if (x < 0 || y < 0 || x >= mColumns || y >= mRows)
+        {
+            return NULL;
+        }
+        return &mDenseCells[y * mColumns + x];
+    }
+
+    std::unordered_map<Uint64, std::vector<int> >::const_iterator it = mHashedCells.find(cellKey(x, y));
+    return it != mHashedCells.end() ? &it->second : NULL;
+}
+
+void CellGrid::insertCells(int id)
+{
+    const SDL_Rect &bounds = mBounds[id];
+    if (bounds.w <= 0 || bounds.h <= 0)
+    {
+        return;
+    }
+
+    int x0, y0, x1, y1;
+    cellRange(bounds, &x0, &y0, &x1, &y1);
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            findCell(x, y, true)->push_back(id);
+        }
+    }
+}
+
+void CellGrid::removeCells(int id)
+{
+    const SDL_Rect &bounds = mBounds[id];
+    if (bounds.w <= 0 || bounds.h <= 0)
+    {
+        return;
+    }
+
+    int x0, y0, x1, y1;
+    cellRange(bounds, &x0, &y0, &x1, &y1);
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            std::vector<int> *cell = findCell(x, y, false);
+            if (cell == NULL)
+            {
+                continue;
+            }
+
+            // Cells are unordered, so swap the last entry into the hole.
+            for (size_t i = 0; i < cell->size(); ++i)
+            {
+                if ((*cell)[i] == id)
+                {
+                    (*cell)[i] = cell->back();
+                    cell->pop_back();
+                    break;
+                }
+            }
+
+            if (cell->empty() && mColumns == 0)
+            {
+                mHashedCells.erase(cellKey(x, y));
+            }
+        }
+    }
+}
+
+int CellGrid::add(const SDL_Rect &bounds)
+{
+    int id;
+    if (!mFreeIds.empty())
+    {
+        id = mFreeIds.back();
+        mFreeIds.pop_back();
+    }
+    else
+    {
+        id = (int)mBounds.size();
+        mBounds.push_back(bounds);
+        mActive.push_back(0);
+    }
+
+    mBounds[id] = bounds;
+    mActive[id] = 1;
+    ++mCount;
+
+    insertCells(id);
+
+    return id;
+}
+
+bool CellGrid::remove(int id)
+{
+    if (!isActive(id))
+    {
+        return false;
+    }
+
+    removeCells(id);
+    mActive[id] = 0;
+    mFreeIds.push_back(id);
+    --mCount;
+
+    return true;
+}
+
+void CellGrid::move(int id, const SDL_Rect &bounds)
+{
+    int oldX0, oldY0, oldX1, oldY1;
+    int newX0, newY0, newX1, newY1;
+    cellRange(mBounds[id], &oldX0, &oldY0, &oldX1, &oldY1);
+    cellRange(bounds, &newX0, &newY0, &newX1, &newY1);
+
+    // Most moves stay within the same cells.
+    bool sameCells = oldX0 == newX0 && oldY0 == newY0 && oldX1 == newX1 && oldY1 == newY1;
+    bool wasEmpty = mBounds[id].w <= 0 || mBounds[id].h <= 0;
+    bool isEmpty = bounds.w <= 0 || bounds.h <= 0;
+    if (sameCells && wasEmpty == isEmpty)
+    {
+        mBounds[id] = bounds;
+        return;
+    }
+
+    removeCells(id);
+    mBounds[id] = bounds;
+    insertCells(id);
+}
+
+bool CellGrid::isActive(int id) const
+{
+    return id >= 0 && id < (int)mActive.size() && mActive[id];
+}
+
+const SDL_Rect &CellGrid::getBounds(int id) const
+{
+    return mBounds[id];
+}
+
+int CellGrid::getIdCount() const
+{
+    return (int)mBounds.size();
+}
+
+int CellGrid::getCount() const
+{
+    return mCount;
+}
+
+int CellGrid::getCellCount() const
+{
+    return mColumns > 0 ? (int)mDenseCells.size() : (int)mHashedCells.size();
+}
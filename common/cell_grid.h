@@ -0,0 +1,63 @@
+#ifndef CELL_GRID_H
+#define CELL_GRID_H
+
+#include <SDL2/SDL.h>
+#include <unordered_map>
+#include <vector>
+
+// Rects bucketed into square cells, each listed in every cell it overlaps.
+// A bounded grid keeps a dense array of columns * rows cells and clamps
+// anything outside onto its border cells; an unbounded one hashes cells by
+// coordinate and only keeps the occupied ones. HitGrid and SpatialHash keep
+// their per-id data alongside the ids handed out here.
+class CellGrid
+{
+public:
+    CellGrid();
+
+    // Drops every rect. Columns or rows of 0 make the grid unbounded.
+    void reset(int cellSize, int columns = 0, int rows = 0);
+
+    // Returns the id; ids of removed rects are reused.
+    int add(const SDL_Rect &bounds);
+
+    // False if the id is not in use
+    bool remove(int id);
+    void move(int id, const SDL_Rect &bounds);
+
+    // Cells covering the rect, inclusive, clamped when bounded
+    void cellRange(const SDL_Rect &bounds, int *x0, int *y0, int *x1, int *y1) const;
+
+    // Ids in a cell in no particular order, or NULL if it holds none
+    const std::vector<int> *getCell(int x, int y) const;
+
+    bool isActive(int id) const;
+    const SDL_Rect &getBounds(int id) const;
+
+    // One past the highest id handed out, for sizing per-id data
+    int getIdCount() const;
+    int getCount() const;
+    int getCellCount() const;
+
+private:
+    static Uint64 cellKey(int x, int y);
+
+    std::vector<int> *findCell(int x, int y, bool create);
+    void insertCells(int id);
+    void removeCells(int id);
+
+    int mCellSize;
+    int mColumns;
+    int mRows;
+    std::vector<std::vector<int> > mDenseCells;
+    std::unordered_map<Uint64, std::vector<int> > mHashedCells;
+
+    // Per rect, indexed by id
+    std::vector<SDL_Rect> mBounds;
+    std::vector<Uint8> mActive;
+
+    std::vector<int> mFreeIds;
+    int mCount;
+};
+
+#endif
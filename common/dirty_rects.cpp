@@ -0,0 +1,322 @@
+#include "dirty_rects.h"
+#include <iostream>
+#include "profiler.h"
+
+DirtyRects::DirtyRects(int width, int height)
+{
+    reset(width, height);
+}
+
+void DirtyRects::reset(int width, int height)
+{
+    mScreen.x = 0;
+    mScreen.y = 0;
+    mScreen.w = width;
+    mScreen.h = height;
+    mRects.clear();
+    mFull = false;
+}
+
+static bool nearby(const SDL_Rect &a, const SDL_Rect &b)
+{
+    SDL_Rect grown = {a.x - DirtyRects::MERGE_DISTANCE, a.y - DirtyRects::MERGE_DISTANCE,
+                      a.w + 2 * DirtyRects::MERGE_DISTANCE, a.h + 2 * DirtyRects::MERGE_DISTANCE};
+    return SDL_HasIntersection(&grown, &b);
+}
+
+void DirtyRects::add(SDL_Rect rect)
+{
+    SDL_Rect clipped;
+    if (mFull || !SDL_IntersectRect(&rect, &mScreen, &clipped))
+    {
+        return;
+    }
+
+    // Keep folding until the new rect touches nothing else.
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < mRects.size(); ++i)
+        {
+            if (nearby(mRects[i], clipped))
+            {
+                SDL_UnionRect(&mRects[i], &clipped, &clipped);
+                mRects[i] = mRects.back();
+                mRects.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+    mRects.push_back(clipped);
+
+    if (mRects.size() > MAX_RECTS)
+    {
+        SDL_Rect bounds = getBounds();
+        mRects.clear();
+        mRects.push_back(bounds);
+    }
+
+    // Past three quarters of the screen, one big pass beats several.
+    Sint64 area = 0;
+    for (size_t i = 0; i < mRects.size(); ++i)
+    {
+        area += (Sint64)mRects[i].w * mRects[i].h;
+    }
+    if (area * 4 > (Sint64)mScreen.w * mScreen.h * 3)
+    {
+        addAll();
+    }
+}
+
+void DirtyRects::addAll()
+{
+    mRects.clear();
+    mRects.push_back(mScreen);
+    mFull = true;
+}
+
+void DirtyRects::clear()
+{
+    mRects.clear();
+    mFull = false;
+}
+
+bool DirtyRects::isEmpty() const
+{
+    return mRects.empty();
+}
+
+bool DirtyRects::isFull() const
+{
+    return mFull;
+}
+
+bool DirtyRects::intersects(const SDL_Rect &rect) const
+{
+    for (size_t i = 0; i < mRects.size(); ++i)
+    {
+        if (SDL_HasIntersection(&mRects[i], &rect))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<SDL_Rect> &DirtyRects::getRects() const
+{
+    return mRects;
+}
+
+SDL_Rect DirtyRects::getBounds() const
+{
+    SDL_Rect bounds = {0, 0, 0, 0};
+    for (size_t i = 0; i < mRects.size(); ++i)
+    {
+        if (i == 0)
+        {
+            bounds = mRects[i];
+        }
+        else
+        {
+            SDL_UnionRect(&bounds, &mRects[i], &bounds);
+        }
+    }
+    return bounds;
+}
+
+bool updateWindowSurfaceRects(SDL_Window *window, const DirtyRects &dirty)
+{
+    PROFILE_SCOPE("updateWindowSurfaceRects");
+
+    if (dirty.isEmpty())
+    {
+        return true;
+    }
+
+    const std::vector<SDL_Rect> &rects = dirty.getRects();
+    if (SDL_UpdateWindowSurfaceRects(window, rects.data(), (int)rects.size()) < 0)
+    {
+        std::cout << "Unable to update window surface! SDL error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+RetainedCanvas::RetainedCanvas()
+{
+    mRenderer = NULL;
+    mCanvas = NULL;
+    mWidth = 0;
+    mHeight = 0;
+    mRegion.x = 0;
+    mRegion.y = 0;
+    mRegion.w = 0;
+    mRegion.h = 0;
+    mNeedsPresent = false;
+    mClearColor.r = 0xFF;
+    mClearColor.g = 0xFF;
+    mClearColor.b = 0xFF;
+    mClearColor.a = 0xFF;
+}
+
+RetainedCanvas::~RetainedCanvas()
+{
+    free();
+}
+
+bool RetainedCanvas::create(SDL_Renderer *renderer, int width, int height)
+{
+    free();
+
+    mRenderer = renderer;
+    mWidth = width;
+    mHeight = height;
+    mDirty.reset(width, height);
+    mDirty.addAll();
+
+    // Without render targets every changed frame is drawn in full, which
+    // still saves the unchanged ones.
+    if (SDL_RenderTargetSupported(renderer))
+    {
+        mCanvas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (mCanvas == NULL)
+        {
+            std::cout << "Unable to create canvas, redrawing in full! SDL error: " << SDL_GetError() << std::endl;
+        }
+    }
+
+    return mCanvas != NULL;
+}
+
+void RetainedCanvas::free()
+{
+    if (mCanvas != NULL)
+    {
+        SDL_DestroyTexture(mCanvas);
+        mCanvas = NULL;
+    }
+    mRenderer = NULL;
+}
+
+void RetainedCanvas::setClearColor(SDL_Color color)
+{
+    mClearColor = color;
+    invalidateAll();
+}
+
+void RetainedCanvas::invalidate(const SDL_Rect &rect)
+{
+    mDirty.add(rect);
+}
+
+void RetainedCanvas::invalidateAll()
+{
+    mDirty.addAll();
+}
+
+void RetainedCanvas::handleEvent(const SDL_Event &e)
+{
+    if (e.type == SDL_WINDOWEVENT && (e.window.event == SDL_WINDOWEVENT_EXPOSED || e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED))
+    {
+        // The canvas still holds the frame; it only has to be shown again.
+        mNeedsPresent = true;
+    }
+    else if (e.type == SDL_RENDER_TARGETS_RESET)
+    {
+        invalidateAll();
+    }
+    else if (e.type == SDL_RENDER_DEVICE_RESET && mRenderer != NULL)
+    {
+        create(mRenderer, mWidth, mHeight);
+    }
+}
+
+bool RetainedCanvas::render(std::function<void()> draw)
+{
+    PROFILE_SCOPE("RetainedCanvas::render");
+
+    if (mRenderer == NULL || (mDirty.isEmpty() && !mNeedsPresent))
+    {
+        return false;
+    }
+
+    if (mCanvas != NULL)
+    {
+        SDL_SetRenderTarget(mRenderer, mCanvas);
+
+        const std::vector<SDL_Rect> &rects = mDirty.getRects();
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            mRegion = rects[i];
+            setViewport(NULL);
+
+            // SDL_RenderClear ignores the clip, so regions are filled instead.
+            SDL_SetRenderDrawColor(mRenderer, mClearColor.r, mClearColor.g, mClearColor.b, mClearColor.a);
+            SDL_RenderFillRect(mRenderer, NULL);
+
+            draw();
+        }
+
+        SDL_RenderSetClipRect(mRenderer, NULL);
+        SDL_RenderSetViewport(mRenderer, NULL);
+        SDL_SetRenderTarget(mRenderer, NULL);
+        SDL_RenderCopy(mRenderer, mCanvas, NULL, NULL);
+    }
+    else
+    {
+        mRegion.x = 0;
+        mRegion.y = 0;
+        mRegion.w = mWidth;
+        mRegion.h = mHeight;
+
+        SDL_SetRenderDrawColor(mRenderer, mClearColor.r, mClearColor.g, mClearColor.b, mClearColor.a);
+        SDL_RenderClear(mRenderer);
+        draw();
+        SDL_RenderSetClipRect(mRenderer, NULL);
+        SDL_RenderSetViewport(mRenderer, NULL);
+    }
+
+    SDL_RenderPresent(mRenderer);
+
+    mDirty.clear();
+    mNeedsPresent = false;
+
+    return true;
+}
+
+bool RetainedCanvas::setViewport(const SDL_Rect *viewport)
+{
+    if (viewport == NULL)
+    {
+        SDL_RenderSetViewport(mRenderer, NULL);
+        SDL_RenderSetClipRect(mRenderer, &mRegion);
+        return true;
+    }
+
+    SDL_Rect visible;
+    if (!SDL_IntersectRect(viewport, &mRegion, &visible))
+    {
+        return false;
+    }
+
+    // The clip is relative to the viewport.
+    SDL_RenderSetViewport(mRenderer, viewport);
+    visible.x -= viewport->x;
+    visible.y -= viewport->y;
+    SDL_RenderSetClipRect(mRenderer, &visible);
+
+    return true;
+}
+
+const SDL_Rect &RetainedCanvas::getRegion() const
+{
+    return mRegion;
+}
+
+const DirtyRects &RetainedCanvas::getDirty() const
+{
+    return mDirty;
+}
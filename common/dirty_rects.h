@@ -0,0 +1,90 @@
+#ifndef DIRTY_RECTS_H
+#define DIRTY_RECTS_H
+
+#include <SDL2/SDL.h>
+#include <functional>
+#include <vector>
+
+// Screen regions changed since the last present. Overlapping or nearly
+// touching rects are merged as they are added; once there are too many, or
+// they cover most of the screen, the whole screen is marked instead.
+class DirtyRects
+{
+public:
+    static const int MAX_RECTS = 32;
+    static const int MERGE_DISTANCE = 8;
+
+    DirtyRects(int width = 640, int height = 480);
+
+    void reset(int width, int height);
+
+    void add(SDL_Rect rect);
+    void addAll();
+    void clear();
+
+    bool isEmpty() const;
+    bool isFull() const;
+    bool intersects(const SDL_Rect &rect) const;
+
+    const std::vector<SDL_Rect> &getRects() const;
+    SDL_Rect getBounds() const;
+
+private:
+    SDL_Rect mScreen;
+    std::vector<SDL_Rect> mRects;
+    bool mFull;
+};
+
+// Pushes only the dirty parts of a window surface to the screen.
+bool updateWindowSurfaceRects(SDL_Window *window, const DirtyRects &dirty);
+
+// Retained frame for the renderer path. The scene lives in a target
+// texture and only dirty regions are redrawn into it, one clipped pass per
+// region. Frames where nothing changed are not drawn or presented at all.
+class RetainedCanvas
+{
+public:
+    RetainedCanvas();
+    ~RetainedCanvas();
+
+    bool create(SDL_Renderer *renderer, int width, int height);
+    void free();
+
+    // Each region is filled with this before it is redrawn, since
+    // SDL_RenderClear would ignore the clip. Defaults to white.
+    void setClearColor(SDL_Color color);
+
+    void invalidate(const SDL_Rect &rect);
+    void invalidateAll();
+
+    // Handles expose, resize and lost render targets
+    void handleEvent(const SDL_Event &e);
+
+    // Calls draw once per dirty region, then presents. Returns false and
+    // presents nothing when the frame is unchanged.
+    bool render(std::function<void()> draw);
+
+    // Use instead of SDL_RenderSetViewport inside draw: keeps the clip on
+    // the current region. Returns false when the viewport misses it.
+    bool setViewport(const SDL_Rect *viewport);
+
+    // Region being redrawn, in screen coordinates
+    const SDL_Rect &getRegion() const;
+    const DirtyRects &getDirty() const;
+
+private:
+    RetainedCanvas(const RetainedCanvas &);
+    RetainedCanvas &operator=(const RetainedCanvas &);
+
+    SDL_Renderer *mRenderer;
+    SDL_Texture *mCanvas;
+    int mWidth;
+    int mHeight;
+
+    DirtyRects mDirty;
+    SDL_Rect mRegion;
+    SDL_Color mClearColor;
+    bool mNeedsPresent;
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include "event_dispatcher.h"
+#include "profiler.h"
+
+EventDispatcher::EventDispatcher()
+{
+    mCoalesceMotion = true;
+    mDispatching = false;
+    mPendingRemoval = false;
+    mNextId = 0;
+}
+
+int EventDispatcher::subscribe(Uint32 type, EventHandler handler)
+{
+    Subscriber subscriber;
+    subscriber.id = mNextId++;
+    subscriber.active = true;
+    subscriber.handler = handler;
+
+    if (mDispatching)
+    {
+        mPendingAdds.push_back(std::make_pair(type, subscriber));
+    }
+    else
+    {
+        mSubscribers[type].push_back(subscriber);
+    }
+
+    return subscriber.id;
+}
+
+void EventDispatcher::unsubscribe(int id)
+{
+    // Only marked here, since a handler may be unsubscribing itself.
+    for (std::map<Uint32, std::vector<Subscriber> >::iterator it = mSubscribers.begin(); it != mSubscribers.end(); ++it)
+    {
+        for (size_t i = 0; i < it->second.size(); ++i)
+        {
+            if (it->second[i].id == id)
+            {
+                it->second[i].active = false;
+                mPendingRemoval = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < mPendingAdds.size(); ++i)
+    {
+        if (mPendingAdds[i].second.id == id)
+        {
+            mPendingAdds.erase(mPendingAdds.begin() + i);
+            break;
+        }
+    }
+
+    if (!mDispatching)
+    {
+        applyPendingChanges();
+    }
+}
+
+void EventDispatcher::applyPendingChanges()
+{
+    if (mPendingRemoval)
+    {
+        for (std::map<Uint32, std::vector<Subscriber> >::iterator it = mSubscribers.begin(); it != mSubscribers.end(); ++it)
+        {
+            std::vector<Subscriber> &subscribers = it->second;
+            size_t kept = 0;
+            for (size_t i = 0; i < subscribers.size(); ++i)
+            {
+                if (subscribers[i].active)
+                {
+                    subscribers[kept++] = subscribers[i];
+                }
+            }
+            subscribers.resize(kept);
+        }
+        mPendingRemoval = false;
+    }
+
+    for (size_t i = 0; i < mPendingAdds.size(); ++i)
+    {
+        mSubscribers[mPendingAdds[i].first].push_back(mPendingAdds[i].second);
+    }
+    mPendingAdds.clear();
+}
+
+void EventDispatcher::setCoalesceMotion(bool coalesce)
+{
+    mCoalesceMotion = coalesce;
+}
+
+void EventDispatcher::setSource(EventSource source)
+{
+    mSource = source;
+}
+
+void EventDispatcher::setObserver(EventObserver observer)
+{
+    mObserver = observer;
+}
+
+// Folds motion into the previous event when nothing else happened in
+// between, so clicks still see the position they happened at.
+bool EventDispatcher::coalesce(const SDL_Event &event)
+{
+    if (!mCoalesceMotion || mEvents.empty())
+    {
+        return false;
+    }
+
+    SDL_Event &last = mEvents.back();
+    if (last.type != event.type)
+    {
+        return false;
+    }
+
+    if (event.type == SDL_MOUSEMOTION && last.motion.which == event.motion.which && last.motion.windowID == event.motion.windowID)
+    {
+        int xrel = last.motion.xrel + event.motion.xrel;
+        int yrel = last.motion.yrel + event.motion.yrel;
+        last = event;
+        last.motion.xrel = xrel;
+        last.motion.yrel = yrel;
+        return true;
+    }
+
+    if (event.type == SDL_FINGERMOTION && last.tfinger.touchId == event.tfinger.touchId && last.tfinger.fingerId == event.tfinger.fingerId)
+    {
+        float dx = last.tfinger.dx + event.tfinger.dx;
+        float dy = last.tfinger.dy + event.tfinger.dy;
+        last = event;
+        last.tfinger.dx = dx;
+        last.tfinger.dy = dy;
+        return true;
+    }
+
+    return false;
+}
+
+int EventDispatcher::dispatch()
+{
+    PROFILE_SCOPE("EventDispatcher::dispatch");
+
+    mPulled.clear();
+    mEvents.clear();
+
+    {
+        PROFILE_SCOPE("EventDispatcher::pull");
+
+        SDL_PumpEvents();
+
+        if (mSource)
+        {
+            SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+            mSource(mPulled);
+        }
+        else
+        {
+            SDL_Event batch[BATCH_SIZE];
+            int count;
+            do
+            {
+                count = SDL_PeepEvents(batch, BATCH_SIZE, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+                mPulled.insert(mPulled.end(), batch, batch + SDL_max(count, 0));
+            } while (count == BATCH_SIZE);
+        }
+    }
+
+    if (mObserver)
+    {
+        mObserver(mPulled);
+    }
+
+    for (size_t i = 0; i < mPulled.size(); ++i)
+    {
+        if (!coalesce(mPulled[i]))
+        {
+            mEvents.push_back(mPulled[i]);
+        }
+    }
+
+    mDispatching = true;
+    for (size_t i = 0; i < mEvents.size(); ++i)
+    {
+        std::map<Uint32, std::vector<Subscriber> >::iterator it = mSubscribers.find(mEvents[i].type);
+        if (it == mSubscribers.end())
+        {
+            continue;
+        }
+
+        std::vector<Subscriber> &subscribers = it->second;
+        for (size_t j = 0; j < subscribers.size(); ++j)
+        {
+            if (subscribers[j].active)
+            {
+                subscribers[j].handler(mEvents[i]);
+            }
+        }
+    }
+    mDispatching = false;
+
+    applyPendingChanges();
+
+    return (int)mEvents.size();
+}
+
+int EventDispatcher::getPulledCount() const
+{
+    return (int)mPulled.size();
+}
+
+int EventDispatcher::getCoalescedCount() const
+{
+    return (int)(mPulled.size() - mEvents.size());
+}
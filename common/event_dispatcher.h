@@ -0,0 +1,74 @@
+#ifndef EVENT_DISPATCHER_H
+#define EVENT_DISPATCHER_H
+
+#include <SDL2/SDL.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+typedef std::function<void(const SDL_Event &)> EventHandler;
+
+// Fills the frame's events in place of the SDL queue, e.g. for replays.
+typedef std::function<void(std::vector<SDL_Event> &)> EventSource;
+
+// Sees every event pulled for a frame, before coalescing.
+typedef std::function<void(const std::vector<SDL_Event> &)> EventObserver;
+
+// Drains the SDL queue in batches once per frame and hands each event only
+// to the handlers subscribed to its type. Runs of mouse or finger motion are
+// merged into one event carrying the latest position and the summed
+// relative motion, so a 1000 Hz mouse costs one dispatch per frame.
+class EventDispatcher
+{
+public:
+    static const int BATCH_SIZE = 64;
+
+    EventDispatcher();
+
+    // Returns an id for unsubscribe(); safe to call from inside a handler.
+    int subscribe(Uint32 type, EventHandler handler);
+    void unsubscribe(int id);
+
+    void setCoalesceMotion(bool coalesce);
+
+    // With a source set, the SDL queue is still pumped but its events are
+    // dropped. Pass NULL to go back to live input.
+    void setSource(EventSource source);
+    void setObserver(EventObserver observer);
+
+    // Pulls everything queued and dispatches it; returns the number of
+    // events dispatched after coalescing.
+    int dispatch();
+
+    // Events pulled and dropped by coalescing in the last dispatch()
+    int getPulledCount() const;
+    int getCoalescedCount() const;
+
+private:
+    struct Subscriber
+    {
+        int id;
+        bool active;
+        EventHandler handler;
+    };
+
+    bool coalesce(const SDL_Event &event);
+    void applyPendingChanges();
+
+    std::map<Uint32, std::vector<Subscriber> > mSubscribers;
+
+    // Subscriptions made by handlers wait until dispatch() finishes.
+    std::vector<std::pair<Uint32, Subscriber> > mPendingAdds;
+    std::vector<SDL_Event> mPulled;
+    std::vector<SDL_Event> mEvents;
+
+    EventSource mSource;
+    EventObserver mObserver;
+
+    bool mCoalesceMotion;
+    bool mDispatching;
+    bool mPendingRemoval;
+    int mNextId;
+};
+
+#endif
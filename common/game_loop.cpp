@@ -0,0 +1,196 @@
+#include "game_loop.h"
+#include <iostream>
+#include <thread>
+#include "profiler.h"
+
+const double SPIN_THRESHOLD_MS = 2.0;
+
+FrameTimings::FrameTimings()
+{
+    eventsMs = 0.0;
+    updateMs = 0.0;
+    renderMs = 0.0;
+    presentMs = 0.0;
+    sleepMs = 0.0;
+    frameMs = 0.0;
+    updates = 0;
+}
+
+GameLoop::GameLoop()
+{
+    mTimestep = 1.0 / 60.0;
+    mFrameCap = 0;
+    mMaxUpdates = DEFAULT_MAX_UPDATES;
+    mQuit = false;
+    mFrequency = SDL_GetPerformanceFrequency();
+    mFrames = 0;
+}
+
+void GameLoop::setTimestep(double seconds)
+{
+    // A zero step would never drain the accumulator.
+    if (!(seconds * mFrequency >= 1.0))
+    {
+        std::cout << "Ignoring timestep of " << seconds << " s, it must be positive" << std::endl;
+        return;
+    }
+    mTimestep = seconds;
+}
+
+void GameLoop::setFrameCap(int framesPerSecond)
+{
+    if (framesPerSecond < 0)
+    {
+        std::cout << "Ignoring frame cap of " << framesPerSecond << ", use 0 for uncapped" << std::endl;
+        return;
+    }
+    mFrameCap = framesPerSecond;
+}
+
+void GameLoop::setMaxUpdates(int maxUpdates)
+{
+    if (maxUpdates < 1)
+    {
+        std::cout << "Ignoring max updates of " << maxUpdates << ", at least one is needed" << std::endl;
+        return;
+    }
+    mMaxUpdates = maxUpdates;
+}
+
+void GameLoop::quit()
+{
+    mQuit = true;
+}
+
+double GameLoop::elapsedMs(Uint64 start, Uint64 end)
+{
+    return (end - start) * 1000.0 / mFrequency;
+}
+
+void GameLoop::sleepUntil(Uint64 target)
+{
+    // SDL_Delay can overshoot by a scheduler tick, so it only covers the bulk
+    // of the wait and the last couple of milliseconds yield instead.
+    while (true)
+    {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now >= target)
+        {
+            break;
+        }
+
+        double remainingMs = elapsedMs(now, target);
+        if (remainingMs > SPIN_THRESHOLD_MS)
+        {
+            SDL_Delay((Uint32)(remainingMs - SPIN_THRESHOLD_MS));
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void GameLoop::run(std::function<void()> events, std::function<void(double)> update, std::function<void(double)> render, std::function<void()> present)
+{
+    Uint64 step = (Uint64)(mTimestep * mFrequency);
+    Uint64 previous = SDL_GetPerformanceCounter();
+    Uint64 accumulator = 0;
+
+    mQuit = false;
+
+    while (!mQuit)
+    {
+        Uint64 frameStart = SDL_GetPerformanceCounter();
+        accumulator += frameStart - previous;
+        previous = frameStart;
+
+        if (accumulator > step * mMaxUpdates)
+        {
+            accumulator = step * mMaxUpdates;
+        }
+
+        PROFILE_FRAME();
+
+        {
+            PROFILE_SCOPE("GameLoop::events");
+            events();
+        }
+        Uint64 eventsEnd = SDL_GetPerformanceCounter();
+
+        int updates = 0;
+        while (accumulator >= step && !mQuit)
+        {
+            PROFILE_SCOPE("GameLoop::update");
+            update(mTimestep);
+            accumulator -= step;
+            ++updates;
+        }
+        Uint64 updateEnd = SDL_GetPerformanceCounter();
+
+        {
+            PROFILE_SCOPE("GameLoop::render");
+            render((double)accumulator / step);
+        }
+        Uint64 renderEnd = SDL_GetPerformanceCounter();
+
+        {
+            PROFILE_SCOPE("GameLoop::present");
+            present();
+        }
+        Uint64 presentEnd = SDL_GetPerformanceCounter();
+
+        if (mFrameCap > 0)
+        {
+            sleepUntil(frameStart + mFrequency / mFrameCap);
+        }
+        Uint64 frameEnd = SDL_GetPerformanceCounter();
+
+        mTimings.eventsMs = elapsedMs(frameStart, eventsEnd);
+        mTimings.updateMs = elapsedMs(eventsEnd, updateEnd);
+        mTimings.renderMs = elapsedMs(updateEnd, renderEnd);
+        mTimings.presentMs = elapsedMs(renderEnd, presentEnd);
+        mTimings.sleepMs = elapsedMs(presentEnd, frameEnd);
+        mTimings.frameMs = elapsedMs(frameStart, frameEnd);
+        mTimings.updates = updates;
+
+        mTotals.eventsMs += mTimings.eventsMs;
+        mTotals.updateMs += mTimings.updateMs;
+        mTotals.renderMs += mTimings.renderMs;
+        mTotals.presentMs += mTimings.presentMs;
+        mTotals.sleepMs += mTimings.sleepMs;
+        mTotals.frameMs += mTimings.frameMs;
+        mTotals.updates += updates;
+        ++mFrames;
+    }
+}
+
+const FrameTimings &GameLoop::getTimings()
+{
+    return mTimings;
+}
+
+FrameTimings GameLoop::getAverageTimings()
+{
+    FrameTimings average;
+    if (mFrames == 0)
+    {
+        return average;
+    }
+
+    average.eventsMs = mTotals.eventsMs / mFrames;
+    average.updateMs = mTotals.updateMs / mFrames;
+    average.renderMs = mTotals.renderMs / mFrames;
+    average.presentMs = mTotals.presentMs / mFrames;
+    average.sleepMs = mTotals.sleepMs / mFrames;
+    average.frameMs = mTotals.frameMs / mFrames;
+    average.updates = mTotals.updates / mFrames;
+
+    return average;
+}
+
+void GameLoop::resetAverageTimings()
+{
+    mTotals = FrameTimings();
+    mFrames = 0;
+}
@@ -0,0 +1,59 @@
+#ifndef GAME_LOOP_H
+#define GAME_LOOP_H
+
+#include <SDL2/SDL.h>
+#include <functional>
+
+struct FrameTimings
+{
+    FrameTimings();
+
+    double eventsMs;
+    double updateMs;
+    double renderMs;
+    double presentMs;
+    double sleepMs;
+    double frameMs;
+    int updates;
+};
+
+// Runs update at a fixed timestep from an accumulator and hands render the
+// fraction of a step left over, so drawing can interpolate between states.
+class GameLoop
+{
+public:
+    static const int DEFAULT_MAX_UPDATES = 5;
+
+    GameLoop();
+
+    // Out of range values are reported and ignored. A frame cap of 0 runs
+    // uncapped.
+    void setTimestep(double seconds);
+    void setFrameCap(int framesPerSecond);
+    void setMaxUpdates(int maxUpdates);
+
+    void run(std::function<void()> events, std::function<void(double)> update, std::function<void(double)> render, std::function<void()> present);
+
+    void quit();
+
+    const FrameTimings &getTimings();
+    FrameTimings getAverageTimings();
+    void resetAverageTimings();
+
+private:
+    double elapsedMs(Uint64 start, Uint64 end);
+    void sleepUntil(Uint64 target);
+
+    double mTimestep;
+    int mFrameCap;
+    int mMaxUpdates;
+    bool mQuit;
+
+    Uint64 mFrequency;
+
+    FrameTimings mTimings;
+    FrameTimings mTotals;
+    int mFrames;
+};
+
+#endif
@@ -0,0 +1,451 @@
+#include "glyph_cache.h"
+#include <iostream>
+#include "profiler.h"
+
+const int FIRST_PRINTABLE = 32;
+const int LAST_PRINTABLE = 126;
+const int ASCII_GLYPHS = 128;
+const int GLYPH_PADDING = 1;
+
+// Glyphs are 16-bit, so characters outside the BMP, like malformed bytes,
+// come back as a single '?' for the whole sequence.
+static Uint16 nextCodepoint(const std::string &text, size_t *index)
+{
+    unsigned char lead = text[*index];
+    ++*index;
+
+    if (lead < 0x80)
+    {
+        return lead;
+    }
+
+    int extra = 0;
+    Uint32 codepoint = 0;
+
+    if ((lead & 0xE0) == 0xC0)
+    {
+        extra = 1;
+        codepoint = lead & 0x1F;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+        extra = 2;
+        codepoint = lead & 0x0F;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+        extra = 3;
+        codepoint = lead & 0x07;
+    }
+    else
+    {
+        // A stray continuation byte or an invalid lead; skip the rest of it
+        while (*index < text.size() && (text[*index] & 0xC0) == 0x80)
+        {
+            ++*index;
+        }
+        return '?';
+    }
+
+    for (int i = 0; i < extra; ++i)
+    {
+        if (*index >= text.size() || (text[*index] & 0xC0) != 0x80)
+        {
+            return '?';
+        }
+        codepoint = (codepoint << 6) | (text[*index] & 0x3F);
+        ++*index;
+    }
+
+    return codepoint > 0xFFFF ? '?' : (Uint16)codepoint;
+}
+
+GlyphCache::GlyphCache()
+{
+    mFont = NULL;
+    mTexture = NULL;
+    mLineSkip = 0;
+}
+
+GlyphCache::~GlyphCache()
+{
+    free();
+}
+
+bool GlyphCache::load(SDL_Renderer *renderer, std::string path, int pointSize, int style)
+{
+    free();
+
+    mFont = TTF_OpenFont(path.c_str(), pointSize);
+    if (mFont == NULL)
+    {
+        std::cout << "Unable to open font " << path << "! SDL_ttf error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    TTF_SetFontStyle(mFont, style);
+    mLineSkip = TTF_FontLineSkip(mFont);
+
+    mTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, PAGE_SIZE, PAGE_SIZE);
+    if (mTexture == NULL)
+    {
+        std::cout << "Unable to create glyph page! SDL error: " << SDL_GetError() << std::endl;
+        free();
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+
+    std::vector<Uint32> clearPixels(PAGE_SIZE * PAGE_SIZE, 0);
+    SDL_UpdateTexture(mTexture, NULL, &clearPixels[0], PAGE_SIZE * sizeof(Uint32));
+
+    mPacker.reset(PAGE_SIZE, PAGE_SIZE);
+    mAsciiGlyphs.assign(ASCII_GLYPHS, Glyph());
+    mAsciiLoaded.assign(ASCII_GLYPHS, false);
+
+    if (!createMissingGlyph())
+    {
+        std::cout << "Unable to create missing glyph box" << std::endl;
+        free();
+        return false;
+    }
+
+    for (int ch = FIRST_PRINTABLE; ch <= LAST_PRINTABLE; ++ch)
+    {
+        getGlyph(ch);
+    }
+
+    return true;
+}
+
+void GlyphCache::free()
+{
+    if (mTexture != NULL)
+    {
+        SDL_DestroyTexture(mTexture);
+        mTexture = NULL;
+    }
+
+    if (mFont != NULL)
+    {
+        TTF_CloseFont(mFont);
+        mFont = NULL;
+    }
+
+    mAsciiGlyphs.clear();
+    mAsciiLoaded.clear();
+    mGlyphs.clear();
+}
+
+// An outlined box from the top of the line down to the baseline
+bool GlyphCache::createMissingGlyph()
+{
+    int height = SDL_max(TTF_FontAscent(mFont), 3);
+    int width = SDL_max(height / 2, 3);
+
+    SDL_Rect slot;
+    if (!mPacker.insert(width + GLYPH_PADDING, height + GLYPH_PADDING, &slot))
+    {
+        return false;
+    }
+
+    std::vector<Uint32> pixels(width * height, 0);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (x == 0 || y == 0 || x == width - 1 || y == height - 1)
+            {
+                pixels[y * width + x] = 0xFFFFFFFF;
+            }
+        }
+    }
+
+    mMissingGlyph.clip.x = slot.x;
+    mMissingGlyph.clip.y = slot.y;
+    mMissingGlyph.clip.w = width;
+    mMissingGlyph.clip.h = height;
+    mMissingGlyph.offsetX = 1;
+    mMissingGlyph.offsetY = 0;
+    mMissingGlyph.advance = width + 2;
+
+    SDL_UpdateTexture(mTexture, &mMissingGlyph.clip, &pixels[0], width * sizeof(Uint32));
+    return true;
+}
+
+bool GlyphCache::rasterize(Uint16 ch, Glyph *glyph)
+{
+    PROFILE_SCOPE("GlyphCache::rasterize");
+
+    int minX, maxX, minY, maxY, advance;
+    if (TTF_GlyphMetrics(mFont, ch, &minX, &maxX, &minY, &maxY, &advance) != 0)
+    {
+        return false;
+    }
+
+    // TTF_RenderGlyph surfaces span the full line height with the pen at
+    // the left edge, so every glyph quad starts at the pen position.
+    glyph->advance = advance;
+    glyph->offsetX = 0;
+    glyph->offsetY = 0;
+    glyph->clip.x = 0;
+    glyph->clip.y = 0;
+    glyph->clip.w = 0;
+    glyph->clip.h = 0;
+
+    if (maxX <= minX || maxY <= minY)
+    {
+        return true;
+    }
+
+    SDL_Color white = {0xFF, 0xFF, 0xFF, 0xFF};
+    SDL_Surface *rendered = TTF_RenderGlyph_Blended(mFont, ch, white);
+    if (rendered == NULL)
+    {
+        return false;
+    }
+
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(rendered);
+    if (converted == NULL)
+    {
+        return false;
+    }
+
+    SDL_Rect slot;
+    bool success = mPacker.insert(converted->w + GLYPH_PADDING, converted->h + GLYPH_PADDING, &slot);
+    if (!success)
+    {
+        std::cout << "Glyph page is full, drawing a box for " << ch << std::endl;
+    }
+    else
+    {
+        glyph->clip.x = slot.x;
+        glyph->clip.y = slot.y;
+        glyph->clip.w = converted->w;
+        glyph->clip.h = converted->h;
+
+        SDL_UpdateTexture(mTexture, &glyph->clip, converted->pixels, converted->pitch);
+    }
+
+    SDL_FreeSurface(converted);
+    return success;
+}
+
+const Glyph *GlyphCache::getGlyph(Uint16 ch)
+{
+    if (mFont == NULL)
+    {
+        return NULL;
+    }
+
+    if (ch < ASCII_GLYPHS)
+    {
+        if (!mAsciiLoaded[ch])
+        {
+            if (!rasterize(ch, &mAsciiGlyphs[ch]))
+            {
+                mAsciiGlyphs[ch] = mMissingGlyph;
+            }
+            mAsciiLoaded[ch] = true;
+        }
+        return &mAsciiGlyphs[ch];
+    }
+
+    std::map<Uint16, Glyph>::iterator it = mGlyphs.find(ch);
+    if (it != mGlyphs.end())
+    {
+        return &it->second;
+    }
+
+    Glyph glyph;
+    if (!rasterize(ch, &glyph))
+    {
+        glyph = mMissingGlyph;
+    }
+
+    return &(mGlyphs[ch] = glyph);
+}
+
+int GlyphCache::getKerning(Uint16 previous, Uint16 ch)
+{
+    if (mFont == NULL || previous == 0)
+    {
+        return 0;
+    }
+    return TTF_GetFontKerningSizeGlyphs(mFont, previous, ch);
+}
+
+SDL_Texture *GlyphCache::getTexture()
+{
+    return mTexture;
+}
+
+int GlyphCache::getLineSkip()
+{
+    return mLineSkip;
+}
+
+TextLayout::TextLayout()
+{
+    mCache = NULL;
+    mColor.r = 0;
+    mColor.g = 0;
+    mColor.b = 0;
+    mColor.a = 0xFF;
+    mOriginX = 0.0f;
+    mOriginY = 0.0f;
+    mWidth = 0;
+    mHeight = 0;
+}
+
+void TextLayout::setText(GlyphCache *cache, std::string text, SDL_Color color)
+{
+    if (cache == mCache && text == mText && color.r == mColor.r && color.g == mColor.g && color.b == mColor.b && color.a == mColor.a)
+    {
+        return;
+    }
+
+    mCache = cache;
+    mText = text;
+    mColor = color;
+
+    build();
+}
+
+void TextLayout::addQuad(const Glyph *glyph, int penX, int penY)
+{
+    float pageSize = GlyphCache::PAGE_SIZE;
+    float left = penX + glyph->offsetX;
+    float top = penY + glyph->offsetY;
+    float right = left + glyph->clip.w;
+    float bottom = top + glyph->clip.h;
+
+    float u0 = glyph->clip.x / pageSize;
+    float v0 = glyph->clip.y / pageSize;
+    float u1 = (glyph->clip.x + glyph->clip.w) / pageSize;
+    float v1 = (glyph->clip.y + glyph->clip.h) / pageSize;
+
+    int base = mVertices.size();
+
+    SDL_Vertex vertex;
+    vertex.color = mColor;
+
+    vertex.position.x = left;
+    vertex.position.y = top;
+    vertex.tex_coord.x = u0;
+    vertex.tex_coord.y = v0;
+    mVertices.push_back(vertex);
+
+    vertex.position.x = right;
+    vertex.tex_coord.x = u1;
+    mVertices.push_back(vertex);
+
+    vertex.position.y = bottom;
+    vertex.tex_coord.y = v1;
+    mVertices.push_back(vertex);
+
+    vertex.position.x = left;
+    vertex.tex_coord.x = u0;
+    mVertices.push_back(vertex);
+
+    mIndices.push_back(base);
+    mIndices.push_back(base + 1);
+    mIndices.push_back(base + 2);
+    mIndices.push_back(base);
+    mIndices.push_back(base + 2);
+    mIndices.push_back(base + 3);
+}
+
+void TextLayout::build()
+{
+    PROFILE_SCOPE("TextLayout::build");
+
+    mVertices.clear();
+    mIndices.clear();
+    mOriginX = 0.0f;
+    mOriginY = 0.0f;
+    mWidth = 0;
+    mHeight = 0;
+
+    if (mCache == NULL || mText.empty())
+    {
+        return;
+    }
+
+    int penX = 0;
+    int penY = 0;
+    Uint16 previous = 0;
+
+    size_t index = 0;
+    while (index < mText.size())
+    {
+        Uint16 ch = nextCodepoint(mText, &index);
+
+        if (ch == '\n')
+        {
+            penX = 0;
+            penY += mCache->getLineSkip();
+            previous = 0;
+            continue;
+        }
+
+        const Glyph *glyph = mCache->getGlyph(ch);
+        if (glyph == NULL)
+        {
+            continue;
+        }
+
+        penX += mCache->getKerning(previous, ch);
+
+        if (glyph->clip.w > 0)
+        {
+            addQuad(glyph, penX, penY);
+        }
+
+        penX += glyph->advance;
+        previous = ch;
+
+        if (penX > mWidth)
+        {
+            mWidth = penX;
+        }
+    }
+
+    mHeight = penY + mCache->getLineSkip();
+}
+
+void TextLayout::render(SDL_Renderer *renderer, int x, int y)
+{
+    PROFILE_SCOPE("TextLayout::render");
+
+    if (mVertices.empty())
+    {
+        return;
+    }
+
+    float dx = x - mOriginX;
+    float dy = y - mOriginY;
+    if (dx != 0.0f || dy != 0.0f)
+    {
+        for (size_t i = 0; i < mVertices.size(); ++i)
+        {
+            mVertices[i].position.x += dx;
+            mVertices[i].position.y += dy;
+        }
+        mOriginX = x;
+        mOriginY = y;
+    }
+
+    SDL_RenderGeometry(renderer, mCache->getTexture(), &mVertices[0], mVertices.size(), &mIndices[0], mIndices.size());
+}
+
+int TextLayout::getWidth()
+{
+    return mWidth;
+}
+
+int TextLayout::getHeight()
+{
+    return mHeight;
+}
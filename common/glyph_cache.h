@@ -0,0 +1,94 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "rect_packer.h"
+
+struct Glyph
+{
+    SDL_Rect clip;
+    int offsetX;
+    int offsetY;
+    int advance;
+};
+
+// One cache per font file, point size and style. Each glyph is rasterized
+// once, in white, into a shared page texture and tinted with vertex colors.
+// Glyphs that fail to rasterize or no longer fit on the page are drawn as
+// a box instead.
+class GlyphCache
+{
+public:
+    static const int PAGE_SIZE = 512;
+
+    GlyphCache();
+    ~GlyphCache();
+
+    bool load(SDL_Renderer *renderer, std::string path, int pointSize, int style = TTF_STYLE_NORMAL);
+
+    void free();
+
+    const Glyph *getGlyph(Uint16 ch);
+    int getKerning(Uint16 previous, Uint16 ch);
+
+    SDL_Texture *getTexture();
+    int getLineSkip();
+
+private:
+    GlyphCache(const GlyphCache &);
+    GlyphCache &operator=(const GlyphCache &);
+
+    bool createMissingGlyph();
+    bool rasterize(Uint16 ch, Glyph *glyph);
+
+    TTF_Font *mFont;
+    SDL_Texture *mTexture;
+    RectPacker mPacker;
+
+    std::vector<Glyph> mAsciiGlyphs;
+    std::vector<bool> mAsciiLoaded;
+    std::map<Uint16, Glyph> mGlyphs;
+
+    // Stands in for glyphs that failed, so they are not retried per lookup
+    Glyph mMissingGlyph;
+
+    int mLineSkip;
+};
+
+// Turns a string into cached glyph quads. Changing the text only rebuilds
+// vertices; no surfaces or textures are created.
+class TextLayout
+{
+public:
+    TextLayout();
+
+    void setText(GlyphCache *cache, std::string text, SDL_Color color);
+
+    void render(SDL_Renderer *renderer, int x, int y);
+
+    int getWidth();
+    int getHeight();
+
+private:
+    void build();
+    void addQuad(const Glyph *glyph, int penX, int penY);
+
+    GlyphCache *mCache;
+    std::string mText;
+    SDL_Color mColor;
+
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+
+    float mOriginX;
+    float mOriginY;
+
+    int mWidth;
+    int mHeight;
+};
+
+#endif
@@ -0,0 +1,140 @@
+#include "hit_grid.h"
+#include "profiler.h"
+
+HitGrid::HitGrid(int width, int height, int cellSize)
+{
+    reset(width, height, cellSize);
+}
+
+void HitGrid::reset(int width, int height, int cellSize)
+{
+    cellSize = SDL_max(cellSize, 1);
+    int columns = SDL_max((width + cellSize - 1) / cellSize, 1);
+    int rows = SDL_max((height + cellSize - 1) / cellSize, 1);
+
+    // Targets and points outside the grid are clamped onto its border cells,
+    // so off-screen parts still hit correctly, just less selectively.
+    mGrid.reset(cellSize, columns, rows);
+
+    mLayer.clear();
+    mOrder.clear();
+    mEnabled.clear();
+
+    mNextOrder = 0;
+    mHovered = -1;
+}
+
+int HitGrid::add(SDL_Rect bounds, int layer)
+{
+    int id = mGrid.add(bounds);
+    if (id >= (int)mLayer.size())
+    {
+        mLayer.resize(id + 1);
+        mOrder.resize(id + 1);
+        mEnabled.resize(id + 1);
+    }
+
+    mLayer[id] = layer;
+    mOrder[id] = mNextOrder++;
+    mEnabled[id] = 1;
+
+    return id;
+}
+
+void HitGrid::remove(int id)
+{
+    if (!mGrid.remove(id))
+    {
+        return;
+    }
+
+    if (mHovered == id)
+    {
+        mHovered = -1;
+    }
+}
+
+void HitGrid::move(int id, SDL_Rect bounds)
+{
+    mGrid.move(id, bounds);
+}
+
+void HitGrid::setLayer(int id, int layer)
+{
+    mLayer[id] = layer;
+}
+
+void HitGrid::setEnabled(int id, bool enabled)
+{
+    mEnabled[id] = enabled ? 1 : 0;
+}
+
+void HitGrid::raise(int id)
+{
+    mOrder[id] = mNextOrder++;
+}
+
+int HitGrid::hitTest(int x, int y) const
+{
+    PROFILE_SCOPE("HitGrid::hitTest");
+
+    SDL_Rect point = {x, y, 1, 1};
+    int x0, y0, x1, y1;
+    mGrid.cellRange(point, &x0, &y0, &x1, &y1);
+    const std::vector<int> &cell = *mGrid.getCell(x0, y0);
+
+    int best = -1;
+    for (size_t i = 0; i < cell.size(); ++i)
+    {
+        int id = cell[i];
+        const SDL_Rect &bounds = mGrid.getBounds(id);
+        if (!mEnabled[id] || x < bounds.x || y < bounds.y || x >= bounds.x + bounds.w || y >= bounds.y + bounds.h)
+        {
+            continue;
+        }
+
+        if (best < 0 || mLayer[id] > mLayer[best] || (mLayer[id] == mLayer[best] && mOrder[id] > mOrder[best]))
+        {
+            best = id;
+        }
+    }
+
+    return best;
+}
+
+HoverChange HitGrid::setHovered(int id)
+{
+    HoverChange change = {-1, -1};
+    if (id != mHovered)
+    {
+        change.left = mHovered;
+        change.entered = id;
+        mHovered = id;
+    }
+    return change;
+}
+
+HoverChange HitGrid::updateHover(int x, int y)
+{
+    return setHovered(hitTest(x, y));
+}
+
+HoverChange HitGrid::clearHover()
+{
+    return setHovered(-1);
+}
+
+int HitGrid::getHovered() const
+{
+    return mHovered;
+}
+
+const SDL_Rect &HitGrid::getBounds(int id) const
+{
+    return mGrid.getBounds(id);
+}
+
+int HitGrid::getCount() const
+{
+    return mGrid.getCount();
+}
@@ -0,0 +1,63 @@
+#ifndef HIT_GRID_H
+#define HIT_GRID_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "cell_grid.h"
+
+struct HoverChange
+{
+    // Targets the pointer left and entered, or -1
+    int left;
+    int entered;
+};
+
+// Uniform grid over screen space for pointer hit-testing. Each target is
+// listed in every cell it overlaps, so a query only checks the few targets
+// sharing the pointer's cell. Among overlapping targets the highest layer
+// wins, then the most recently added or raised.
+class HitGrid
+{
+public:
+    HitGrid(int width = 640, int height = 480, int cellSize = 64);
+
+    // Drops every target and resizes the grid
+    void reset(int width, int height, int cellSize);
+
+    // Returns the target id; ids of removed targets are reused.
+    int add(SDL_Rect bounds, int layer = 0);
+    void remove(int id);
+
+    void move(int id, SDL_Rect bounds);
+    void setLayer(int id, int layer);
+    void setEnabled(int id, bool enabled);
+
+    // Puts a target above the others on its layer
+    void raise(int id);
+
+    // Topmost enabled target under the point, or -1
+    int hitTest(int x, int y) const;
+
+    // Moves the hover to whatever is under the point
+    HoverChange updateHover(int x, int y);
+    HoverChange clearHover();
+    int getHovered() const;
+
+    const SDL_Rect &getBounds(int id) const;
+    int getCount() const;
+
+private:
+    HoverChange setHovered(int id);
+
+    CellGrid mGrid;
+
+    // Per target, indexed by id
+    std::vector<int> mLayer;
+    std::vector<Uint32> mOrder;
+    std::vector<Uint8> mEnabled;
+
+    Uint32 mNextOrder;
+    int mHovered;
+};
+
+#endif
@@ -0,0 +1,367 @@
+#include "input_log.h"
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include "profiler.h"
+
+bool packInputEvent(const SDL_Event &event, InputLogEvent *packed)
+{
+    memset(packed, 0, sizeof(*packed));
+    packed->type = event.type;
+    Sint32 *f = packed->fields;
+
+    switch (event.type)
+    {
+    case SDL_QUIT:
+        break;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        f[0] = event.key.keysym.scancode;
+        f[1] = event.key.keysym.sym;
+        f[2] = event.key.keysym.mod;
+        f[3] = event.key.repeat;
+        break;
+    case SDL_MOUSEMOTION:
+        f[0] = event.motion.x;
+        f[1] = event.motion.y;
+        f[2] = event.motion.xrel;
+        f[3] = event.motion.yrel;
+        f[4] = event.motion.state;
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        f[0] = event.button.x;
+        f[1] = event.button.y;
+        f[2] = event.button.button;
+        f[3] = event.button.clicks;
+        break;
+    case SDL_MOUSEWHEEL:
+        f[0] = event.wheel.x;
+        f[1] = event.wheel.y;
+        f[2] = event.wheel.direction;
+        break;
+    case SDL_WINDOWEVENT:
+        f[0] = event.window.event;
+        f[1] = event.window.data1;
+        f[2] = event.window.data2;
+        break;
+    case SDL_CONTROLLERBUTTONDOWN:
+    case SDL_CONTROLLERBUTTONUP:
+        f[0] = event.cbutton.which;
+        f[1] = event.cbutton.button;
+        break;
+    case SDL_CONTROLLERAXISMOTION:
+        f[0] = event.caxis.which;
+        f[1] = event.caxis.axis;
+        f[2] = event.caxis.value;
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+SDL_Event unpackInputEvent(const InputLogEvent &packed)
+{
+    SDL_Event event;
+    memset(&event, 0, sizeof(event));
+    event.type = packed.type;
+    const Sint32 *f = packed.fields;
+
+    switch (packed.type)
+    {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        event.key.state = packed.type == SDL_KEYDOWN ? SDL_PRESSED : SDL_RELEASED;
+        event.key.keysym.scancode = (SDL_Scancode)f[0];
+        event.key.keysym.sym = f[1];
+        event.key.keysym.mod = (Uint16)f[2];
+        event.key.repeat = (Uint8)f[3];
+        break;
+    case SDL_MOUSEMOTION:
+        event.motion.x = f[0];
+        event.motion.y = f[1];
+        event.motion.xrel = f[2];
+        event.motion.yrel = f[3];
+        event.motion.state = f[4];
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        event.button.state = packed.type == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+        event.button.x = f[0];
+        event.button.y = f[1];
+        event.button.button = (Uint8)f[2];
+        event.button.clicks = (Uint8)f[3];
+        break;
+    case SDL_MOUSEWHEEL:
+        event.wheel.x = f[0];
+        event.wheel.y = f[1];
+        event.wheel.direction = f[2];
+        break;
+    case SDL_WINDOWEVENT:
+        event.window.event = (Uint8)f[0];
+        event.window.data1 = f[1];
+        event.window.data2 = f[2];
+        break;
+    case SDL_CONTROLLERBUTTONDOWN:
+    case SDL_CONTROLLERBUTTONUP:
+        event.cbutton.state = packed.type == SDL_CONTROLLERBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+        event.cbutton.which = f[0];
+        event.cbutton.button = (Uint8)f[1];
+        break;
+    case SDL_CONTROLLERAXISMOTION:
+        event.caxis.which = f[0];
+        event.caxis.axis = (Uint8)f[1];
+        event.caxis.value = (Sint16)f[2];
+        break;
+    }
+
+    return event;
+}
+
+void parseInputLogArgs(int argc, char const *argv[], std::string *recordPath, std::string *replayPath)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "--record") == 0)
+        {
+            *recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0)
+        {
+            *replayPath = argv[++i];
+        }
+    }
+}
+
+static Uint64 microsecondsSince(Uint64 start)
+{
+    return (SDL_GetPerformanceCounter() - start) * 1000000 / SDL_GetPerformanceFrequency();
+}
+
+InputRecorder::InputRecorder()
+{
+    mStart = 0;
+    mFrames = 0;
+}
+
+InputRecorder::~InputRecorder()
+{
+    close();
+}
+
+bool InputRecorder::open(std::string path)
+{
+    close();
+
+    mOut.open(path, std::ios::binary | std::ios::trunc);
+    if (!mOut)
+    {
+        std::cout << "Unable to create input log " << path << std::endl;
+        return false;
+    }
+
+    InputLogHeader header = {INPUT_LOG_MAGIC, INPUT_LOG_VERSION, 0, 0};
+    mOut.write((const char *)&header, sizeof(header));
+
+    mPath = path;
+    mStart = SDL_GetPerformanceCounter();
+    mFrames = 0;
+
+    return true;
+}
+
+void InputRecorder::attach(EventDispatcher &dispatcher)
+{
+    dispatcher.setObserver([this](const std::vector<SDL_Event> &events) { recordFrame(events); });
+}
+
+void InputRecorder::recordFrame(const std::vector<SDL_Event> &events)
+{
+    PROFILE_SCOPE("InputRecorder::recordFrame");
+
+    if (!mOut.is_open())
+    {
+        return;
+    }
+
+    mPacked.clear();
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        InputLogEvent packed;
+        if (packInputEvent(events[i], &packed))
+        {
+            mPacked.push_back(packed);
+        }
+    }
+
+    InputLogFrame frame;
+    frame.time = microsecondsSince(mStart);
+    frame.eventCount = (Uint32)mPacked.size();
+    frame.reserved = 0;
+
+    mOut.write((const char *)&frame, sizeof(frame));
+    mOut.write((const char *)mPacked.data(), mPacked.size() * sizeof(InputLogEvent));
+    ++mFrames;
+}
+
+void InputRecorder::close()
+{
+    if (!mOut.is_open())
+    {
+        return;
+    }
+
+    mOut.seekp(offsetof(InputLogHeader, frameCount));
+    mOut.write((const char *)&mFrames, sizeof(mFrames));
+    mOut.close();
+
+    if (!mOut)
+    {
+        std::cout << "Unable to write input log " << mPath << std::endl;
+    }
+    else
+    {
+        std::cout << "Recorded " << mFrames << " frames to " << mPath << std::endl;
+    }
+}
+
+InputReplayer::InputReplayer()
+{
+    mOffset = 0;
+    mFrameCount = 0;
+    mFrame = 0;
+    mRealtime = false;
+    mFinished = false;
+    mStart = 0;
+    mEnd = 0;
+}
+
+bool InputReplayer::open(std::string path)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+    {
+        std::cout << "Unable to open input log " << path << std::endl;
+        return false;
+    }
+
+    mData.resize((size_t)in.tellg());
+    in.seekg(0);
+    in.read((char *)mData.data(), mData.size());
+
+    InputLogHeader header;
+    if (!in || mData.size() < sizeof(header))
+    {
+        std::cout << "Unable to read input log " << path << std::endl;
+        return false;
+    }
+
+    memcpy(&header, mData.data(), sizeof(header));
+    if (header.magic != INPUT_LOG_MAGIC || header.version != INPUT_LOG_VERSION)
+    {
+        std::cout << "Input log " << path << " is corrupt or from another version" << std::endl;
+        return false;
+    }
+
+    mOffset = sizeof(header);
+    mFrameCount = header.frameCount;
+    mFrame = 0;
+    mFinished = false;
+    mStart = 0;
+
+    return true;
+}
+
+void InputReplayer::attach(EventDispatcher &dispatcher)
+{
+    dispatcher.setSource([this](std::vector<SDL_Event> &events) { nextFrame(events); });
+}
+
+void InputReplayer::setRealtime(bool realtime)
+{
+    mRealtime = realtime;
+}
+
+void InputReplayer::nextFrame(std::vector<SDL_Event> &events)
+{
+    PROFILE_SCOPE("InputReplayer::nextFrame");
+
+    if (mFinished)
+    {
+        return;
+    }
+
+    if (mStart == 0)
+    {
+        mStart = SDL_GetPerformanceCounter();
+    }
+
+    InputLogFrame frame;
+    bool available = mData.size() - mOffset >= sizeof(frame);
+    if (available)
+    {
+        memcpy(&frame, &mData[mOffset], sizeof(frame));
+        available = (mData.size() - mOffset - sizeof(frame)) / sizeof(InputLogEvent) >= frame.eventCount;
+    }
+
+    // Goes by the data rather than the header count, so a log cut short
+    // by a crash still replays up to where it stops.
+    if (!available)
+    {
+        SDL_Event quit;
+        memset(&quit, 0, sizeof(quit));
+        quit.type = SDL_QUIT;
+        events.push_back(quit);
+
+        mFinished = true;
+        mEnd = SDL_GetPerformanceCounter();
+        return;
+    }
+
+    if (mRealtime)
+    {
+        Uint64 elapsed = microsecondsSince(mStart);
+        if (frame.time > elapsed)
+        {
+            SDL_Delay((Uint32)((frame.time - elapsed) / 1000));
+        }
+    }
+
+    mOffset += sizeof(frame);
+    for (Uint32 i = 0; i < frame.eventCount; ++i)
+    {
+        InputLogEvent packed;
+        memcpy(&packed, &mData[mOffset], sizeof(packed));
+        mOffset += sizeof(packed);
+
+        SDL_Event event = unpackInputEvent(packed);
+        event.common.timestamp = (Uint32)(frame.time / 1000);
+        events.push_back(event);
+    }
+
+    ++mFrame;
+}
+
+bool InputReplayer::isFinished() const
+{
+    return mFinished;
+}
+
+int InputReplayer::getFrameCount() const
+{
+    return (int)mFrameCount;
+}
+
+void InputReplayer::report() const
+{
+    if (mStart == 0 || mFrame == 0)
+    {
+        return;
+    }
+
+    Uint64 end = mFinished ? mEnd : SDL_GetPerformanceCounter();
+    double ms = (end - mStart) * 1000.0 / SDL_GetPerformanceFrequency();
+    std::cout << "Replayed " << mFrame << " frames in " << ms << " ms (" << ms / mFrame << " ms per frame)" << std::endl;
+}
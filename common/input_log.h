@@ -0,0 +1,105 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <SDL2/SDL.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "event_dispatcher.h"
+
+// Binary input log, native byte order:
+//
+//   InputLogHeader
+//   per frame: InputLogFrame, then InputLogEvent[eventCount]
+//
+// Only input, window and quit events are kept, each packed into five
+// integers, so an idle frame costs 16 bytes.
+const Uint32 INPUT_LOG_MAGIC = 0x4C49534D;
+const Uint32 INPUT_LOG_VERSION = 1;
+
+struct InputLogHeader
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 frameCount;
+    Uint32 reserved;
+};
+
+struct InputLogFrame
+{
+    // Microseconds since recording started
+    Uint64 time;
+    Uint32 eventCount;
+    Uint32 reserved;
+};
+
+struct InputLogEvent
+{
+    Uint32 type;
+    Sint32 fields[5];
+};
+
+bool packInputEvent(const SDL_Event &event, InputLogEvent *packed);
+SDL_Event unpackInputEvent(const InputLogEvent &packed);
+
+// Reads --record <path> and --replay <path> from a lesson's arguments
+void parseInputLogArgs(int argc, char const *argv[], std::string *recordPath, std::string *replayPath);
+
+// Writes what the dispatcher pulls each frame. Lessons take --record <path>.
+class InputRecorder
+{
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool open(std::string path);
+    void attach(EventDispatcher &dispatcher);
+    void recordFrame(const std::vector<SDL_Event> &events);
+
+    // Writes the frame count into the header
+    void close();
+
+private:
+    std::ofstream mOut;
+    std::string mPath;
+    Uint64 mStart;
+    Uint32 mFrames;
+    std::vector<InputLogEvent> mPacked;
+};
+
+// Feeds a log back through the dispatcher one frame per dispatch() and
+// sends SDL_QUIT when it runs out. Lessons take --replay <path> and then
+// run headless and uncapped, so replays double as benchmarks.
+class InputReplayer
+{
+public:
+    InputReplayer();
+
+    bool open(std::string path);
+    void attach(EventDispatcher &dispatcher);
+    void nextFrame(std::vector<SDL_Event> &events);
+
+    // Waits for each frame's recorded time instead of running flat out
+    void setRealtime(bool realtime);
+
+    bool isFinished() const;
+
+    // Frames in the header; 0 if the recording never closed
+    int getFrameCount() const;
+
+    // Prints frames replayed and the average frame time
+    void report() const;
+
+private:
+    std::vector<Uint8> mData;
+    size_t mOffset;
+    Uint32 mFrameCount;
+    Uint32 mFrame;
+    bool mRealtime;
+    bool mFinished;
+
+    Uint64 mStart;
+    Uint64 mEnd;
+};
+
+#endif
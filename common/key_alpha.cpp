@@ -0,0 +1,328 @@
+#include "key_alpha.h"
+#include <SDL2/SDL_image.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "profiler.h"
+#include "soft_blit.h"
+
+const Uint32 CACHE_MAGIC = 0x4B41534D;
+const Uint32 CACHE_VERSION = 1;
+const int MAX_CACHED_SIZE = 16384;
+const int BLEED_PASSES = 8;
+
+// Written in native byte order; a cache from another machine fails the
+// magic check and is simply rebuilt.
+struct KeyAlphaCacheHeader
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint64 sourceSize;
+    Sint64 sourceTime;
+    Uint32 options;
+    Uint32 width;
+    Uint32 height;
+    Uint32 reserved;
+};
+
+KeyAlphaOptions::KeyAlphaOptions()
+{
+    keyColor.r = 0;
+    keyColor.g = 0xFF;
+    keyColor.b = 0xFF;
+    keyColor.a = 0xFF;
+    premultiply = false;
+    bleed = true;
+    cacheDir = ".texcache";
+}
+
+static inline Uint32 div255(Uint32 x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline Uint32 *pixelRow(SDL_Surface *surface, int y)
+{
+    return (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+}
+
+void keyToAlpha(SDL_Surface *surface, SDL_Color keyColor)
+{
+    Uint32 key = ((Uint32)keyColor.r << 16) | ((Uint32)keyColor.g << 8) | keyColor.b;
+
+    for (int y = 0; y < surface->h; ++y)
+    {
+        Uint32 *row = pixelRow(surface, y);
+        for (int x = 0; x < surface->w; ++x)
+        {
+            if ((row[x] & 0x00FFFFFF) == key)
+            {
+                row[x] = 0;
+            }
+        }
+    }
+}
+
+void bleedAlpha(SDL_Surface *surface)
+{
+    int w = surface->w;
+    int h = surface->h;
+    std::vector<Uint8> known(w * h);
+    std::vector<int> filled;
+
+    for (int y = 0; y < h; ++y)
+    {
+        Uint32 *row = pixelRow(surface, y);
+        for (int x = 0; x < w; ++x)
+        {
+            known[y * w + x] = (row[x] >> 24) != 0;
+        }
+    }
+
+    // Each pass grows the colored region by one pixel; a few rings are all
+    // linear filtering and small mip levels ever sample.
+    for (int pass = 0; pass < BLEED_PASSES; ++pass)
+    {
+        filled.clear();
+
+        for (int y = 0; y < h; ++y)
+        {
+            Uint32 *row = pixelRow(surface, y);
+            for (int x = 0; x < w; ++x)
+            {
+                if (known[y * w + x])
+                {
+                    continue;
+                }
+
+                Uint32 r = 0;
+                Uint32 g = 0;
+                Uint32 b = 0;
+                Uint32 count = 0;
+
+                for (int ny = SDL_max(y - 1, 0); ny <= SDL_min(y + 1, h - 1); ++ny)
+                {
+                    Uint32 *neighbours = pixelRow(surface, ny);
+                    for (int nx = SDL_max(x - 1, 0); nx <= SDL_min(x + 1, w - 1); ++nx)
+                    {
+                        if (known[ny * w + nx])
+                        {
+                            r += (neighbours[nx] >> 16) & 0xFF;
+                            g += (neighbours[nx] >> 8) & 0xFF;
+                            b += neighbours[nx] & 0xFF;
+                            ++count;
+                        }
+                    }
+                }
+
+                if (count > 0)
+                {
+                    row[x] = ((r / count) << 16) | ((g / count) << 8) | (b / count);
+                    filled.push_back(y * w + x);
+                }
+            }
+        }
+
+        if (filled.empty())
+        {
+            break;
+        }
+        for (size_t i = 0; i < filled.size(); ++i)
+        {
+            known[filled[i]] = 1;
+        }
+    }
+}
+
+void premultiplyAlpha(SDL_Surface *surface)
+{
+    for (int y = 0; y < surface->h; ++y)
+    {
+        Uint32 *row = pixelRow(surface, y);
+        for (int x = 0; x < surface->w; ++x)
+        {
+            Uint32 pixel = row[x];
+            Uint32 a = pixel >> 24;
+            Uint32 r = div255(((pixel >> 16) & 0xFF) * a);
+            Uint32 g = div255(((pixel >> 8) & 0xFF) * a);
+            Uint32 b = div255((pixel & 0xFF) * a);
+
+            row[x] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+}
+
+SDL_BlendMode getPremultipliedBlendMode()
+{
+    return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                      SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+}
+
+static Uint32 packOptions(const KeyAlphaOptions &options)
+{
+    return ((Uint32)options.keyColor.r << 24) | ((Uint32)options.keyColor.g << 16) | ((Uint32)options.keyColor.b << 8) |
+           (options.premultiply ? 2 : 0) | (options.bleed && !options.premultiply ? 1 : 0);
+}
+
+static std::string makeCachePath(std::string path, const KeyAlphaOptions &options)
+{
+    std::error_code error;
+    std::filesystem::path source = std::filesystem::weakly_canonical(std::filesystem::absolute(path, error), error);
+    if (error)
+    {
+        source = path;
+    }
+
+    // FNV-1a over the source path and options keeps names short and stable.
+    std::string key = source.string();
+    Uint32 packed = packOptions(options);
+    Uint64 hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < key.size(); ++i)
+    {
+        hash = (hash ^ (Uint8)key[i]) * 1099511628211ULL;
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        hash = (hash ^ ((packed >> (i * 8)) & 0xFF)) * 1099511628211ULL;
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "-%016llx.argb", (unsigned long long)hash);
+
+    return (std::filesystem::path(options.cacheDir) / (source.stem().string() + name)).string();
+}
+
+static SDL_Surface *readCache(std::string cachePath, const KeyAlphaCacheHeader &expected)
+{
+    std::ifstream in(cachePath, std::ios::binary);
+    if (!in)
+    {
+        return NULL;
+    }
+
+    KeyAlphaCacheHeader header;
+    if (!in.read((char *)&header, sizeof(header)) || header.magic != expected.magic ||
+        header.version != expected.version || header.sourceSize != expected.sourceSize ||
+        header.sourceTime != expected.sourceTime || header.options != expected.options ||
+        header.width == 0 || header.height == 0 || header.width > MAX_CACHED_SIZE || header.height > MAX_CACHED_SIZE)
+    {
+        return NULL;
+    }
+
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, header.width, header.height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (surface == NULL)
+    {
+        return NULL;
+    }
+
+    for (int y = 0; y < surface->h; ++y)
+    {
+        if (!in.read((char *)pixelRow(surface, y), surface->w * sizeof(Uint32)))
+        {
+            SDL_FreeSurface(surface);
+            return NULL;
+        }
+    }
+
+    return surface;
+}
+
+static void writeCache(std::string cachePath, SDL_Surface *surface, KeyAlphaCacheHeader header)
+{
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+
+    // Write beside the final name and rename, so a reader never sees a
+    // half written file.
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+
+        header.width = surface->w;
+        header.height = surface->h;
+        out.write((const char *)&header, sizeof(header));
+        for (int y = 0; y < surface->h; ++y)
+        {
+            out.write((const char *)pixelRow(surface, y), surface->w * sizeof(Uint32));
+        }
+
+        if (!out)
+        {
+            std::cout << "Unable to write texture cache " << cachePath << std::endl;
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error)
+    {
+        std::cout << "Unable to write texture cache " << cachePath << "! " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+SDL_Surface *loadKeyedImage(std::string path, const KeyAlphaOptions &options)
+{
+    PROFILE_SCOPE("loadKeyedImage");
+
+    KeyAlphaCacheHeader header = {};
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.options = packOptions(options);
+
+    std::error_code error;
+    header.sourceSize = std::filesystem::file_size(path, error);
+    if (!error)
+    {
+        header.sourceTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    }
+
+    std::string cachePath;
+    if (!error && !options.cacheDir.empty())
+    {
+        cachePath = makeCachePath(path, options);
+
+        SDL_Surface *cached = readCache(cachePath, header);
+        if (cached != NULL)
+        {
+            return cached;
+        }
+    }
+
+    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
+    if (loadedSurface == NULL)
+    {
+        std::cout << "Unable to load image " << path << "! SDL_image error: " << IMG_GetError() << std::endl;
+        return NULL;
+    }
+
+    SDL_Surface *surface = softConvertSurface(loadedSurface, SDL_PIXELFORMAT_ARGB8888);
+    SDL_FreeSurface(loadedSurface);
+    if (surface == NULL)
+    {
+        std::cout << "Unable to convert image " << path << "! SDL error: " << SDL_GetError() << std::endl;
+        return NULL;
+    }
+
+    keyToAlpha(surface, options.keyColor);
+    if (options.bleed && !options.premultiply)
+    {
+        bleedAlpha(surface);
+    }
+    if (options.premultiply)
+    {
+        premultiplyAlpha(surface);
+    }
+
+    if (!cachePath.empty())
+    {
+        writeCache(cachePath, surface, header);
+    }
+
+    return surface;
+}
@@ -0,0 +1,39 @@
+#ifndef KEY_ALPHA_H
+#define KEY_ALPHA_H
+
+#include <SDL2/SDL.h>
+#include <string>
+
+// Load-time replacement for runtime color keying: the key color becomes a
+// real alpha channel once, so the texture draws with a plain blend.
+struct KeyAlphaOptions
+{
+    KeyAlphaOptions();
+
+    SDL_Color keyColor;
+
+    // Store color multiplied by alpha; drawn with getPremultipliedBlendMode().
+    bool premultiply;
+
+    // Spread edge colors into transparent pixels so filtering does not pull
+    // in the key color. Off when premultiplying, which zeroes those pixels.
+    bool bleed;
+
+    // Directory of the key-alpha bake cache; empty disables it.
+    std::string cacheDir;
+};
+
+// Loads path as an ARGB8888 surface with the key baked into alpha. A cached
+// copy is used when its recorded source size and modification time still
+// match the file on disk.
+SDL_Surface *loadKeyedImage(std::string path, const KeyAlphaOptions &options = KeyAlphaOptions());
+
+// The individual passes, all on ARGB8888 surfaces.
+void keyToAlpha(SDL_Surface *surface, SDL_Color keyColor);
+void bleedAlpha(SDL_Surface *surface);
+void premultiplyAlpha(SDL_Surface *surface);
+
+// result = src + dst * (1 - srcAlpha), for premultiplied textures.
+SDL_BlendMode getPremultipliedBlendMode();
+
+#endif
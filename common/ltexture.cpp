@@ -0,0 +1,325 @@
+#include "ltexture.h"
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <utility>
+#include "profiler.h"
+
+LTexture::LTexture()
+{
+    mTexture = NULL;
+    mRenderer = NULL;
+    mWidth = 0;
+    mHeight = 0;
+    mFormat = SDL_PIXELFORMAT_UNKNOWN;
+    mAccess = SDL_TEXTUREACCESS_STATIC;
+    mPremultiplied = false;
+    mRed = 0xFF;
+    mGreen = 0xFF;
+    mBlue = 0xFF;
+    mAlpha = 0xFF;
+}
+
+LTexture::~LTexture()
+{
+    free();
+}
+
+LTexture::LTexture(LTexture &&other) noexcept
+{
+    mTexture = other.mTexture;
+    mShared = std::move(other.mShared);
+    mRenderer = other.mRenderer;
+    mWidth = other.mWidth;
+    mHeight = other.mHeight;
+    mFormat = other.mFormat;
+    mAccess = other.mAccess;
+    mPremultiplied = other.mPremultiplied;
+    mRed = other.mRed;
+    mGreen = other.mGreen;
+    mBlue = other.mBlue;
+    mAlpha = other.mAlpha;
+
+    other.mTexture = NULL;
+    other.mWidth = 0;
+    other.mHeight = 0;
+}
+
+LTexture &LTexture::operator=(LTexture &&other) noexcept
+{
+    if (this != &other)
+    {
+        free();
+
+        mTexture = other.mTexture;
+        mShared = std::move(other.mShared);
+        mRenderer = other.mRenderer;
+        mWidth = other.mWidth;
+        mHeight = other.mHeight;
+        mFormat = other.mFormat;
+        mAccess = other.mAccess;
+        mPremultiplied = other.mPremultiplied;
+        mRed = other.mRed;
+        mGreen = other.mGreen;
+        mBlue = other.mBlue;
+        mAlpha = other.mAlpha;
+
+        other.mTexture = NULL;
+        other.mWidth = 0;
+        other.mHeight = 0;
+    }
+    return *this;
+}
+
+bool LTexture::adopt(SDL_Renderer *renderer, SDL_Texture *texture)
+{
+    if (texture == NULL)
+    {
+        return false;
+    }
+
+    mTexture = texture;
+    mRenderer = renderer;
+    SDL_QueryTexture(mTexture, &mFormat, &mAccess, &mWidth, &mHeight);
+
+    return true;
+}
+
+void LTexture::applyModulation()
+{
+    if (mPremultiplied)
+    {
+        SDL_SetTextureColorMod(mTexture, mRed * mAlpha / 0xFF, mGreen * mAlpha / 0xFF, mBlue * mAlpha / 0xFF);
+    }
+    else
+    {
+        SDL_SetTextureColorMod(mTexture, mRed, mGreen, mBlue);
+    }
+    SDL_SetTextureAlphaMod(mTexture, mAlpha);
+}
+
+bool LTexture::loadFromFile(SDL_Renderer *renderer, std::string path)
+{
+    PROFILE_SCOPE("LTexture::loadFromFile");
+
+    free();
+
+    SDL_Texture *newTexture = NULL;
+    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
+    if (loadedSurface == NULL)
+    {
+        std::cout << "Unable to load image " << path << "! SDL_image error: " << IMG_GetError() << std::endl;
+    }
+    else
+    {
+        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
+
+        newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
+        if (newTexture == NULL)
+        {
+            std::cout << "Unable to create texture from " << path << "! SDL error: " << SDL_GetError() << std::endl;
+        }
+
+        SDL_FreeSurface(loadedSurface);
+    }
+
+    return adopt(renderer, newTexture);
+}
+
+bool LTexture::loadFromFile(SDL_Renderer *renderer, std::string path, const KeyAlphaOptions &options)
+{
+    PROFILE_SCOPE("LTexture::loadFromFile");
+
+    free();
+
+    SDL_Texture *newTexture = NULL;
+    SDL_Surface *loadedSurface = loadKeyedImage(path, options);
+    if (loadedSurface != NULL)
+    {
+        newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
+        if (newTexture == NULL)
+        {
+            std::cout << "Unable to create texture from " << path << "! SDL error: " << SDL_GetError() << std::endl;
+        }
+
+        SDL_FreeSurface(loadedSurface);
+    }
+
+    if (newTexture != NULL && options.premultiply && SDL_SetTextureBlendMode(newTexture, getPremultipliedBlendMode()) < 0)
+    {
+        // Renderers without custom blend modes get straight alpha instead.
+        SDL_DestroyTexture(newTexture);
+
+        KeyAlphaOptions straight = options;
+        straight.premultiply = false;
+        return loadFromFile(renderer, path, straight);
+    }
+
+    if (!adopt(renderer, newTexture))
+    {
+        return false;
+    }
+
+    if (options.premultiply)
+    {
+        mPremultiplied = true;
+    }
+    else
+    {
+        SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+    }
+
+    return true;
+}
+
+bool LTexture::loadFromCache(TextureCache &cache, SDL_Renderer *renderer, std::string path, const TextureLoadOptions &options)
+{
+    PROFILE_SCOPE("LTexture::loadFromCache");
+
+    free();
+
+    TextureHandle handle = cache.load(renderer, path, options);
+    if (!handle || !adopt(renderer, handle->texture))
+    {
+        return false;
+    }
+
+    mShared = handle;
+    mPremultiplied = handle->premultiplied;
+
+    return true;
+}
+
+bool LTexture::loadFromRenderedText(SDL_Renderer *renderer, TTF_Font *font, std::string textureText, SDL_Color textColor)
+{
+    PROFILE_SCOPE("LTexture::loadFromRenderedText");
+
+    free();
+
+    SDL_Texture *newTexture = NULL;
+    SDL_Surface *textSurface = TTF_RenderText_Solid(font, textureText.c_str(), textColor);
+    if (textSurface == NULL)
+    {
+        std::cout << "Unable to render text surface! SDL_ttf error: " << SDL_GetError() << std::endl;
+    }
+    else
+    {
+        newTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+        if (newTexture == NULL)
+        {
+            std::cout << "Unable to create texture from rendered text! SDL error: " << SDL_GetError() << std::endl;
+        }
+
+        SDL_FreeSurface(textSurface);
+    }
+
+    return adopt(renderer, newTexture);
+}
+
+void LTexture::free()
+{
+    if (mTexture != NULL)
+    {
+        if (mShared)
+        {
+            mShared.reset();
+        }
+        else
+        {
+            SDL_DestroyTexture(mTexture);
+        }
+
+        mTexture = NULL;
+        mWidth = 0;
+        mHeight = 0;
+        mFormat = SDL_PIXELFORMAT_UNKNOWN;
+        mAccess = SDL_TEXTUREACCESS_STATIC;
+    }
+
+    mPremultiplied = false;
+    mRed = 0xFF;
+    mGreen = 0xFF;
+    mBlue = 0xFF;
+    mAlpha = 0xFF;
+}
+
+void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
+{
+    mRed = red;
+    mGreen = green;
+    mBlue = blue;
+    applyModulation();
+}
+
+void LTexture::setBlendMode(SDL_BlendMode blend_mode)
+{
+    if (mPremultiplied && blend_mode == SDL_BLENDMODE_BLEND)
+    {
+        blend_mode = getPremultipliedBlendMode();
+    }
+    SDL_SetTextureBlendMode(mTexture, blend_mode);
+}
+
+void LTexture::setAlpha(Uint8 alpha)
+{
+    mAlpha = alpha;
+    applyModulation();
+}
+
+void LTexture::render(int x, int y, const SDL_Rect *clip, double angle, SDL_Point *center, SDL_RendererFlip flip)
+{
+    PROFILE_SCOPE("LTexture::render");
+
+    SDL_Rect renderQuad = {x, y, mWidth, mHeight};
+
+    if (clip != NULL)
+    {
+        renderQuad.w = clip->w;
+        renderQuad.h = clip->h;
+    }
+
+    if (angle == 0.0 && flip == SDL_FLIP_NONE)
+    {
+        SDL_RenderCopy(mRenderer, mTexture, clip, &renderQuad);
+    }
+    else
+    {
+        SDL_RenderCopyEx(mRenderer, mTexture, clip, &renderQuad, angle, center, flip);
+    }
+}
+
+void LTexture::render(const SDL_Rect &dest, const SDL_Rect *clip)
+{
+    PROFILE_SCOPE("LTexture::render");
+
+    SDL_RenderCopy(mRenderer, mTexture, clip, &dest);
+}
+
+int LTexture::getWidth() const
+{
+    return mWidth;
+}
+
+int LTexture::getHeight() const
+{
+    return mHeight;
+}
+
+Uint32 LTexture::getFormat() const
+{
+    return mFormat;
+}
+
+int LTexture::getAccess() const
+{
+    return mAccess;
+}
+
+SDL_Texture *LTexture::getTexture() const
+{
+    return mTexture;
+}
+
+bool LTexture::isPremultiplied() const
+{
+    return mPremultiplied;
+}
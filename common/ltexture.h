@@ -0,0 +1,82 @@
+#ifndef LTEXTURE_H
+#define LTEXTURE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include "key_alpha.h"
+#include "texture_cache.h"
+
+// Texture wrapper shared by the lessons. It owns its SDL_Texture, so it can
+// be moved but not copied; width, height, format and access are queried once
+// at load time. Textures loaded through a TextureCache are shared instead,
+// and color and alpha modulation apply to every holder.
+class LTexture
+{
+public:
+    LTexture();
+    ~LTexture();
+
+    LTexture(LTexture &&other) noexcept;
+    LTexture &operator=(LTexture &&other) noexcept;
+
+    LTexture(const LTexture &) = delete;
+    LTexture &operator=(const LTexture &) = delete;
+
+    // Load image from path, keying out cyan
+    bool loadFromFile(SDL_Renderer *renderer, std::string path);
+
+    // Load image from path with the key baked into alpha at load time
+    bool loadFromFile(SDL_Renderer *renderer, std::string path, const KeyAlphaOptions &options);
+
+    // Load image from path through cache, reusing any earlier load with the
+    // same options
+    bool loadFromCache(TextureCache &cache, SDL_Renderer *renderer, std::string path, const TextureLoadOptions &options = TextureLoadOptions());
+
+    // Render text with the given font
+    bool loadFromRenderedText(SDL_Renderer *renderer, TTF_Font *font, std::string textureText, SDL_Color textColor);
+
+    // Deallocates texture from memory
+    void free();
+
+    void setColor(Uint8 red, Uint8 green, Uint8 blue);
+    void setBlendMode(SDL_BlendMode blend_mode);
+    void setAlpha(Uint8 alpha);
+
+    void render(int x, int y, const SDL_Rect *clip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
+
+    // Stretched to dest, e.g. a camera's screen rect at some zoom
+    void render(const SDL_Rect &dest, const SDL_Rect *clip = NULL);
+
+    int getWidth() const;
+    int getHeight() const;
+    Uint32 getFormat() const;
+    int getAccess() const;
+    SDL_Texture *getTexture() const;
+    bool isPremultiplied() const;
+
+private:
+    bool adopt(SDL_Renderer *renderer, SDL_Texture *texture);
+    void applyModulation();
+
+    SDL_Texture *mTexture;
+    SDL_Renderer *mRenderer;
+
+    // Set when mTexture belongs to a cache entry
+    TextureHandle mShared;
+
+    int mWidth;
+    int mHeight;
+    Uint32 mFormat;
+    int mAccess;
+
+    // Premultiplied textures fade by scaling color as well as alpha, so the
+    // requested modulation is kept and applied together.
+    bool mPremultiplied;
+    Uint8 mRed;
+    Uint8 mGreen;
+    Uint8 mBlue;
+    Uint8 mAlpha;
+};
+
+#endif
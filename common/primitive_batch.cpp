@@ -0,0 +1,389 @@
+#include "primitive_batch.h"
+#include <cmath>
+#include "profiler.h"
+
+static bool sameColor(SDL_Color a, SDL_Color b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+PrimitiveBatch::PrimitiveBatch()
+{
+    mLastGroup = 0;
+    mPointCount = 0;
+
+    mColor.r = 0xFF;
+    mColor.g = 0xFF;
+    mColor.b = 0xFF;
+    mColor.a = 0xFF;
+    mLineWidth = 1.0f;
+    mBlendMode = SDL_BLENDMODE_BLEND;
+
+    mDrawCalls = 0;
+}
+
+void PrimitiveBatch::setColor(Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha)
+{
+    mColor.r = red;
+    mColor.g = green;
+    mColor.b = blue;
+    mColor.a = alpha;
+}
+
+void PrimitiveBatch::setLineWidth(float width)
+{
+    mLineWidth = width > 0.0f ? width : 1.0f;
+}
+
+void PrimitiveBatch::setBlendMode(SDL_BlendMode blend_mode)
+{
+    mBlendMode = blend_mode;
+}
+
+int PrimitiveBatch::addVertex(float x, float y, SDL_Color color)
+{
+    SDL_Vertex vertex;
+    vertex.position.x = x;
+    vertex.position.y = y;
+    vertex.color = color;
+    vertex.tex_coord.x = 0.0f;
+    vertex.tex_coord.y = 0.0f;
+    mVertices.push_back(vertex);
+    return (int)mVertices.size() - 1;
+}
+
+void PrimitiveBatch::addQuad(int a, int b, int c, int d)
+{
+    mIndices.push_back(a);
+    mIndices.push_back(b);
+    mIndices.push_back(c);
+    mIndices.push_back(a);
+    mIndices.push_back(c);
+    mIndices.push_back(d);
+}
+
+PrimitiveBatch::PointGroup *PrimitiveBatch::pointGroup(SDL_Color color)
+{
+    if (mLastGroup < mPointGroups.size() && sameColor(mPointGroups[mLastGroup].color, color))
+    {
+        return &mPointGroups[mLastGroup];
+    }
+
+    for (size_t i = 0; i < mPointGroups.size(); ++i)
+    {
+        if (sameColor(mPointGroups[i].color, color))
+        {
+            mLastGroup = i;
+            return &mPointGroups[i];
+        }
+    }
+
+    if ((int)mPointGroups.size() >= MAX_POINT_COLORS)
+    {
+        return NULL;
+    }
+
+    PointGroup group;
+    group.color = color;
+    mPointGroups.push_back(group);
+    mLastGroup = mPointGroups.size() - 1;
+    return &mPointGroups.back();
+}
+
+void PrimitiveBatch::point(float x, float y)
+{
+    point(x, y, mColor);
+}
+
+void PrimitiveBatch::point(float x, float y, SDL_Color color)
+{
+    ++mPointCount;
+
+    PointGroup *group = pointGroup(color);
+    if (group != NULL)
+    {
+        SDL_FPoint p = {x, y};
+        group->points.push_back(p);
+        return;
+    }
+
+    int a = addVertex(x, y, color);
+    addVertex(x + 1.0f, y, color);
+    addVertex(x + 1.0f, y + 1.0f, color);
+    addVertex(x, y + 1.0f, color);
+    addQuad(a, a + 1, a + 2, a + 3);
+}
+
+void PrimitiveBatch::points(const SDL_FPoint *points, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        point(points[i].x, points[i].y, mColor);
+    }
+}
+
+void PrimitiveBatch::line(float x1, float y1, float x2, float y2)
+{
+    line(x1, y1, x2, y2, mColor, mColor);
+}
+
+void PrimitiveBatch::line(float x1, float y1, float x2, float y2, SDL_Color color1, SDL_Color color2)
+{
+    // Through pixel centers, with square caps half a width long so both end
+    // pixels are covered.
+    float half = mLineWidth / 2.0f;
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float length = sqrtf(dx * dx + dy * dy);
+
+    float ux = 1.0f;
+    float uy = 0.0f;
+    if (length > 0.0001f)
+    {
+        ux = dx / length;
+        uy = dy / length;
+    }
+
+    float capX = ux * half;
+    float capY = uy * half;
+    float normalX = -uy * half;
+    float normalY = ux * half;
+
+    float sx = x1 + 0.5f - capX;
+    float sy = y1 + 0.5f - capY;
+    float ex = x2 + 0.5f + capX;
+    float ey = y2 + 0.5f + capY;
+
+    int a = addVertex(sx + normalX, sy + normalY, color1);
+    addVertex(ex + normalX, ey + normalY, color2);
+    addVertex(ex - normalX, ey - normalY, color2);
+    addVertex(sx - normalX, sy - normalY, color1);
+    addQuad(a, a + 1, a + 2, a + 3);
+}
+
+void PrimitiveBatch::polyline(const SDL_FPoint *points, int count, bool closed)
+{
+    for (int i = 0; i + 1 < count; ++i)
+    {
+        line(points[i].x, points[i].y, points[i + 1].x, points[i + 1].y);
+    }
+    if (closed && count > 2)
+    {
+        line(points[count - 1].x, points[count - 1].y, points[0].x, points[0].y);
+    }
+}
+
+void PrimitiveBatch::fillRect(const SDL_FRect &rect)
+{
+    fillRect(rect, mColor, mColor, mColor, mColor);
+}
+
+void PrimitiveBatch::fillRect(const SDL_FRect &rect, SDL_Color topLeft, SDL_Color topRight, SDL_Color bottomRight, SDL_Color bottomLeft)
+{
+    if (rect.w <= 0.0f || rect.h <= 0.0f)
+    {
+        return;
+    }
+
+    int a = addVertex(rect.x, rect.y, topLeft);
+    addVertex(rect.x + rect.w, rect.y, topRight);
+    addVertex(rect.x + rect.w, rect.y + rect.h, bottomRight);
+    addVertex(rect.x, rect.y + rect.h, bottomLeft);
+    addQuad(a, a + 1, a + 2, a + 3);
+}
+
+void PrimitiveBatch::drawRect(const SDL_FRect &rect)
+{
+    // Four strips inside the rect that do not overlap, so translucent
+    // outlines keep an even alpha.
+    float width = SDL_min(mLineWidth, SDL_min(rect.w, rect.h) / 2.0f);
+
+    SDL_FRect top = {rect.x, rect.y, rect.w, width};
+    SDL_FRect bottom = {rect.x, rect.y + rect.h - width, rect.w, width};
+    SDL_FRect left = {rect.x, rect.y + width, width, rect.h - 2.0f * width};
+    SDL_FRect right = {rect.x + rect.w - width, rect.y + width, width, rect.h - 2.0f * width};
+
+    fillRect(top);
+    fillRect(bottom);
+    fillRect(left);
+    fillRect(right);
+}
+
+// Enough segments to keep the chord within a quarter pixel of the arc
+int PrimitiveBatch::circleSegments(float radius)
+{
+    if (radius <= 1.0f)
+    {
+        return 8;
+    }
+
+    int segments = (int)ceilf((float)M_PI / acosf(1.0f - 0.25f / radius));
+    return SDL_min(SDL_max(segments, 8), 256);
+}
+
+void PrimitiveBatch::fillCircle(float x, float y, float radius)
+{
+    fillCircle(x, y, radius, mColor, mColor);
+}
+
+void PrimitiveBatch::fillCircle(float x, float y, float radius, SDL_Color center, SDL_Color edge)
+{
+    if (radius <= 0.0f)
+    {
+        return;
+    }
+
+    int segments = circleSegments(radius);
+    int middle = addVertex(x, y, center);
+    for (int i = 0; i < segments; ++i)
+    {
+        float angle = 2.0f * (float)M_PI * i / segments;
+        addVertex(x + cosf(angle) * radius, y + sinf(angle) * radius, edge);
+    }
+
+    for (int i = 0; i < segments; ++i)
+    {
+        mIndices.push_back(middle);
+        mIndices.push_back(middle + 1 + i);
+        mIndices.push_back(middle + 1 + (i + 1) % segments);
+    }
+}
+
+void PrimitiveBatch::drawCircle(float x, float y, float radius)
+{
+    if (radius <= 0.0f)
+    {
+        return;
+    }
+
+    float inner = SDL_max(radius - mLineWidth / 2.0f, 0.0f);
+    float outer = radius + mLineWidth / 2.0f;
+
+    int segments = circleSegments(outer);
+    int first = (int)mVertices.size();
+    for (int i = 0; i < segments; ++i)
+    {
+        float angle = 2.0f * (float)M_PI * i / segments;
+        float c = cosf(angle);
+        float s = sinf(angle);
+        addVertex(x + c * outer, y + s * outer, mColor);
+        addVertex(x + c * inner, y + s * inner, mColor);
+    }
+
+    for (int i = 0; i < segments; ++i)
+    {
+        int a = first + i * 2;
+        int b = first + ((i + 1) % segments) * 2;
+        addQuad(a, b, b + 1, a + 1);
+    }
+}
+
+void PrimitiveBatch::fillPolygon(const SDL_FPoint *points, int count, const SDL_Color *colors)
+{
+    if (count < 3)
+    {
+        return;
+    }
+
+    int first = (int)mVertices.size();
+    for (int i = 0; i < count; ++i)
+    {
+        addVertex(points[i].x, points[i].y, colors != NULL ? colors[i] : mColor);
+    }
+
+    for (int i = 1; i + 1 < count; ++i)
+    {
+        mIndices.push_back(first);
+        mIndices.push_back(first + i);
+        mIndices.push_back(first + i + 1);
+    }
+}
+
+void PrimitiveBatch::fillTriangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color colorA, SDL_Color colorB, SDL_Color colorC)
+{
+    mIndices.push_back(addVertex(a.x, a.y, colorA));
+    mIndices.push_back(addVertex(b.x, b.y, colorB));
+    mIndices.push_back(addVertex(c.x, c.y, colorC));
+}
+
+int PrimitiveBatch::flush(SDL_Renderer *renderer)
+{
+    PROFILE_SCOPE("PrimitiveBatch::flush");
+
+    mDrawCalls = 0;
+
+    // Both the blend mode and the draw color go back to the caller's
+    SDL_BlendMode blendMode;
+    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+    SDL_SetRenderDrawBlendMode(renderer, mBlendMode);
+
+    if (!mIndices.empty())
+    {
+        SDL_RenderGeometry(renderer, NULL, mVertices.data(), (int)mVertices.size(), mIndices.data(), (int)mIndices.size());
+        ++mDrawCalls;
+    }
+
+    if (mPointCount > 0)
+    {
+        Uint8 r, g, b, a;
+        SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+
+        for (size_t i = 0; i < mPointGroups.size(); ++i)
+        {
+            const PointGroup &group = mPointGroups[i];
+            if (!group.points.empty())
+            {
+                SDL_SetRenderDrawColor(renderer, group.color.r, group.color.g, group.color.b, group.color.a);
+                SDL_RenderDrawPointsF(renderer, group.points.data(), (int)group.points.size());
+                ++mDrawCalls;
+            }
+        }
+
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
+
+    clear();
+    return mDrawCalls;
+}
+
+void PrimitiveBatch::clear()
+{
+    mVertices.clear();
+    mIndices.clear();
+
+    // Colors unused this frame give up their group.
+    size_t kept = 0;
+    for (size_t i = 0; i < mPointGroups.size(); ++i)
+    {
+        if (!mPointGroups[i].points.empty())
+        {
+            if (kept != i)
+            {
+                mPointGroups[kept].color = mPointGroups[i].color;
+                mPointGroups[kept].points.swap(mPointGroups[i].points);
+            }
+            mPointGroups[kept].points.clear();
+            ++kept;
+        }
+    }
+    mPointGroups.resize(kept);
+    mLastGroup = 0;
+    mPointCount = 0;
+}
+
+int PrimitiveBatch::getVertexCount() const
+{
+    return (int)mVertices.size();
+}
+
+int PrimitiveBatch::getPointCount() const
+{
+    return mPointCount;
+}
+
+int PrimitiveBatch::getDrawCalls() const
+{
+    return mDrawCalls;
+}
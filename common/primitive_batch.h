@@ -0,0 +1,86 @@
+#ifndef PRIMITIVE_BATCH_H
+#define PRIMITIVE_BATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Accumulates untextured primitives for debug overlays and the like, and
+// flushes them in as few calls as possible. Lines, outlines and fills are
+// triangles with per-vertex color, submitted in order with one
+// SDL_RenderGeometry call. Points are grouped by color and each group goes
+// out in one SDL_RenderDrawPointsF call, after the triangles; past
+// MAX_POINT_COLORS colors further points become one-pixel quads instead.
+class PrimitiveBatch
+{
+public:
+    static const int MAX_POINT_COLORS = 16;
+
+    PrimitiveBatch();
+
+    // Used by calls without explicit colors
+    void setColor(Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha = 0xFF);
+    void setLineWidth(float width);
+    void setBlendMode(SDL_BlendMode blend_mode);
+
+    void point(float x, float y);
+    void point(float x, float y, SDL_Color color);
+    void points(const SDL_FPoint *points, int count);
+
+    // Lines include both end pixels, like SDL_RenderDrawLine.
+    void line(float x1, float y1, float x2, float y2);
+    void line(float x1, float y1, float x2, float y2, SDL_Color color1, SDL_Color color2);
+    void polyline(const SDL_FPoint *points, int count, bool closed = false);
+
+    void fillRect(const SDL_FRect &rect);
+
+    // Corner colors run clockwise from the top left.
+    void fillRect(const SDL_FRect &rect, SDL_Color topLeft, SDL_Color topRight, SDL_Color bottomRight, SDL_Color bottomLeft);
+    void drawRect(const SDL_FRect &rect);
+
+    void fillCircle(float x, float y, float radius);
+    void fillCircle(float x, float y, float radius, SDL_Color center, SDL_Color edge);
+    void drawCircle(float x, float y, float radius);
+
+    // Convex polygons, fanned from the first point; colors is per point.
+    void fillPolygon(const SDL_FPoint *points, int count, const SDL_Color *colors = NULL);
+
+    void fillTriangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color colorA, SDL_Color colorB, SDL_Color colorC);
+
+    // Returns the number of draw calls
+    int flush(SDL_Renderer *renderer);
+
+    void clear();
+
+    int getVertexCount() const;
+    int getPointCount() const;
+    int getDrawCalls() const;
+
+private:
+    struct PointGroup
+    {
+        SDL_Color color;
+        std::vector<SDL_FPoint> points;
+    };
+
+    static int circleSegments(float radius);
+
+    int addVertex(float x, float y, SDL_Color color);
+    void addQuad(int a, int b, int c, int d);
+    PointGroup *pointGroup(SDL_Color color);
+
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+
+    // Groups stay allocated across frames; empty ones are skipped.
+    std::vector<PointGroup> mPointGroups;
+    size_t mLastGroup;
+    int mPointCount;
+
+    SDL_Color mColor;
+    float mLineWidth;
+    SDL_BlendMode mBlendMode;
+
+    int mDrawCalls;
+};
+
+#endif
@@ -0,0 +1,231 @@
+#include "profiler.h"
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+const int OVERLAY_ROW_HEIGHT = 6;
+const int OVERLAY_MAX_DEPTH = 4;
+
+struct ProfileThreadBuffer
+{
+    ProfileThreadBuffer()
+    {
+        events.resize(Profiler::EVENTS_PER_THREAD);
+        head = 0;
+        depth = 0;
+        id = 0;
+    }
+
+    std::vector<ProfileEvent> events;
+    std::atomic<Uint32> head;
+    int depth;
+    int id;
+    std::string name;
+};
+
+static std::mutex gBufferMutex;
+static std::vector<ProfileThreadBuffer *> gBuffers;
+static thread_local ProfileThreadBuffer *tBuffer = NULL;
+
+static ProfileThreadBuffer *gFrameBuffer = NULL;
+static Uint64 gFrameStart = 0;
+static Uint64 gPreviousFrameStart = 0;
+
+// Buffers are intentionally never freed: zones on worker threads may still
+// be exported after those threads have exited.
+static ProfileThreadBuffer *threadBuffer()
+{
+    if (tBuffer == NULL)
+    {
+        tBuffer = new ProfileThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(gBufferMutex);
+        tBuffer->id = gBuffers.size() + 1;
+        tBuffer->name = "thread " + std::to_string(tBuffer->id);
+        gBuffers.push_back(tBuffer);
+    }
+    return tBuffer;
+}
+
+ProfileZone::ProfileZone(const char *name)
+{
+    mName = name;
+    Profiler::enterZone();
+    mStart = SDL_GetPerformanceCounter();
+}
+
+ProfileZone::~ProfileZone()
+{
+    Profiler::record(mName, mStart, SDL_GetPerformanceCounter());
+}
+
+void Profiler::enterZone()
+{
+    ++threadBuffer()->depth;
+}
+
+void Profiler::record(const char *name, Uint64 start, Uint64 end)
+{
+    ProfileThreadBuffer *buffer = threadBuffer();
+    --buffer->depth;
+
+    Uint32 head = buffer->head.load(std::memory_order_relaxed);
+    ProfileEvent &event = buffer->events[head % EVENTS_PER_THREAD];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    event.depth = buffer->depth;
+
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char *name)
+{
+    ProfileThreadBuffer *buffer = threadBuffer();
+
+    std::lock_guard<std::mutex> lock(gBufferMutex);
+    buffer->name = name;
+}
+
+void Profiler::markFrame()
+{
+    gFrameBuffer = threadBuffer();
+    gPreviousFrameStart = gFrameStart;
+    gFrameStart = SDL_GetPerformanceCounter();
+}
+
+void Profiler::renderOverlay(SDL_Renderer *renderer, int x, int y, int width, double budgetMs)
+{
+    if (gFrameBuffer == NULL || gPreviousFrameStart == 0)
+    {
+        return;
+    }
+
+    double ticksPerPixel = budgetMs * SDL_GetPerformanceFrequency() / 1000.0 / width;
+
+    SDL_Rect background = {x, y, width, OVERLAY_ROW_HEIGHT * OVERLAY_MAX_DEPTH};
+    SDL_SetRenderDrawColor(renderer, 0x20, 0x20, 0x20, 0xFF);
+    SDL_RenderFillRect(renderer, &background);
+
+    Uint32 head = gFrameBuffer->head.load(std::memory_order_acquire);
+    Uint32 count = head < (Uint32)EVENTS_PER_THREAD ? head : EVENTS_PER_THREAD;
+
+    for (Uint32 i = 1; i <= count; ++i)
+    {
+        const ProfileEvent &event = gFrameBuffer->events[(head - i) % EVENTS_PER_THREAD];
+        if (event.end <= gPreviousFrameStart)
+        {
+            break;
+        }
+        if (event.start < gPreviousFrameStart || event.end > gFrameStart || event.depth >= OVERLAY_MAX_DEPTH)
+        {
+            continue;
+        }
+
+        SDL_Rect bar;
+        bar.x = x + (int)((event.start - gPreviousFrameStart) / ticksPerPixel);
+        bar.y = y + event.depth * OVERLAY_ROW_HEIGHT;
+        bar.w = (int)((event.end - event.start) / ticksPerPixel);
+        bar.h = OVERLAY_ROW_HEIGHT - 1;
+
+        if (bar.w < 1)
+        {
+            bar.w = 1;
+        }
+
+        // Color by name pointer so each zone keeps a stable color.
+        Uint32 hash = (Uint32)(size_t)event.name * 2654435761u;
+        SDL_SetRenderDrawColor(renderer, 0x60 + (hash >> 24) % 0xA0, 0x60 + (hash >> 16) % 0xA0, 0x60 + (hash >> 8) % 0xA0, 0xFF);
+        SDL_RenderFillRect(renderer, &bar);
+    }
+
+    int budgetX = x + width - 1;
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0x00, 0x00, 0xFF);
+    SDL_RenderDrawLine(renderer, budgetX, y, budgetX, y + OVERLAY_ROW_HEIGHT * OVERLAY_MAX_DEPTH);
+}
+
+static void writeJsonString(std::ofstream &out, const std::string &text)
+{
+    out << '"';
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        char c = text[i];
+        if (c == '"' || c == '\\')
+        {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+bool Profiler::exportChromeTrace(std::string path)
+{
+    std::ofstream out(path.c_str());
+    if (!out)
+    {
+        std::cout << "Unable to open trace file " << path << std::endl;
+        return false;
+    }
+
+    out.setf(std::ios::fixed);
+    out.precision(3);
+
+    double ticksPerMicrosecond = SDL_GetPerformanceFrequency() / 1000000.0;
+    Uint64 origin = 0;
+
+    std::lock_guard<std::mutex> lock(gBufferMutex);
+
+    for (size_t b = 0; b < gBuffers.size(); ++b)
+    {
+        ProfileThreadBuffer *buffer = gBuffers[b];
+        Uint32 head = buffer->head.load(std::memory_order_acquire);
+        Uint32 first = head > (Uint32)EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+        if (head > first)
+        {
+            Uint64 start = buffer->events[first % EVENTS_PER_THREAD].start;
+            if (origin == 0 || start < origin)
+            {
+                origin = start;
+            }
+        }
+    }
+
+    out << "{\"traceEvents\":[";
+    bool firstEvent = true;
+
+    for (size_t b = 0; b < gBuffers.size(); ++b)
+    {
+        ProfileThreadBuffer *buffer = gBuffers[b];
+
+        if (!firstEvent)
+        {
+            out << ",";
+        }
+        firstEvent = false;
+
+        out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":";
+        writeJsonString(out, buffer->name);
+        out << "}}";
+
+        Uint32 head = buffer->head.load(std::memory_order_acquire);
+        Uint32 first = head > (Uint32)EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+
+        for (Uint32 i = first; i < head; ++i)
+        {
+            const ProfileEvent &event = buffer->events[i % EVENTS_PER_THREAD];
+            double ts = event.start < origin ? 0.0 : (event.start - origin) / ticksPerMicrosecond;
+
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"ts\":" << ts
+                << ",\"dur\":" << (event.end - event.start) / ticksPerMicrosecond << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    return out.good();
+}
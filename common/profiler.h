@@ -0,0 +1,68 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SDL2/SDL.h>
+#include <string>
+
+// Zones are only recorded when built with -DMINISDL_PROFILE; otherwise the
+// PROFILE_* macros expand to nothing and cost nothing. Zone names are string
+// literals, "Class::method" for members, so traces tell overloads and
+// classes apart.
+
+struct ProfileEvent
+{
+    const char *name;
+    Uint64 start;
+    Uint64 end;
+    int depth;
+};
+
+class ProfileZone
+{
+public:
+    ProfileZone(const char *name);
+    ~ProfileZone();
+
+private:
+    const char *mName;
+    Uint64 mStart;
+};
+
+class Profiler
+{
+public:
+    static const int EVENTS_PER_THREAD = 16384;
+
+    static void setThreadName(const char *name);
+
+    static void markFrame();
+
+    static void renderOverlay(SDL_Renderer *renderer, int x, int y, int width, double budgetMs = 1000.0 / 60.0);
+
+    // Reads every thread's ring buffer without locking it, so call it once
+    // other threads have stopped recording, e.g. after ViewRenderer::stop()
+    // and AssetLoader::stop().
+    static bool exportChromeTrace(std::string path);
+
+    static void record(const char *name, Uint64 start, Uint64 end);
+    static void enterZone();
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef MINISDL_PROFILE
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#define PROFILE_FRAME() Profiler::markFrame()
+#define PROFILE_OVERLAY(renderer, x, y, width) Profiler::renderOverlay(renderer, x, y, width)
+#define PROFILE_EXPORT(path) Profiler::exportChromeTrace(path)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+#define PROFILE_FRAME()
+#define PROFILE_OVERLAY(renderer, x, y, width)
+#define PROFILE_EXPORT(path)
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+#include "rect_packer.h"
+
+RectPacker::RectPacker()
+{
+    reset(0, 0);
+}
+
+RectPacker::RectPacker(int width, int height)
+{
+    reset(width, height);
+}
+
+void RectPacker::reset(int width, int height)
+{
+    mWidth = width;
+    mHeight = height;
+    mUsedArea = 0;
+
+    mSkyline.clear();
+
+    SkylineNode node = {0, 0, width};
+    mSkyline.push_back(node);
+}
+
+int RectPacker::fit(int index, int w, int h)
+{
+    int x = mSkyline[index].x;
+    if (x + w > mWidth)
+    {
+        return -1;
+    }
+
+    int y = mSkyline[index].y;
+    int widthLeft = w;
+
+    while (widthLeft > 0)
+    {
+        if (mSkyline[index].y > y)
+        {
+            y = mSkyline[index].y;
+        }
+
+        if (y + h > mHeight)
+        {
+            return -1;
+        }
+
+        widthLeft -= mSkyline[index].w;
+        ++index;
+    }
+
+    return y;
+}
+
+bool RectPacker::insert(int w, int h, SDL_Rect *result)
+{
+    int bestIndex = -1;
+    int bestBottom = mHeight + 1;
+    int bestWidth = mWidth + 1;
+    int bestY = 0;
+
+    for (size_t i = 0; i < mSkyline.size(); ++i)
+    {
+        int y = fit(i, w, h);
+        if (y < 0)
+        {
+            continue;
+        }
+
+        if (y + h < bestBottom || (y + h == bestBottom && mSkyline[i].w < bestWidth))
+        {
+            bestIndex = i;
+            bestBottom = y + h;
+            bestWidth = mSkyline[i].w;
+            bestY = y;
+        }
+    }
+
+    if (bestIndex < 0)
+    {
+        return false;
+    }
+
+    SkylineNode node = {mSkyline[bestIndex].x, bestY + h, w};
+    mSkyline.insert(mSkyline.begin() + bestIndex, node);
+
+    for (size_t i = bestIndex + 1; i < mSkyline.size(); ++i)
+    {
+        int shrink = mSkyline[i - 1].x + mSkyline[i - 1].w - mSkyline[i].x;
+        if (shrink <= 0)
+        {
+            break;
+        }
+
+        mSkyline[i].x += shrink;
+        mSkyline[i].w -= shrink;
+
+        if (mSkyline[i].w > 0)
+        {
+            break;
+        }
+
+        mSkyline.erase(mSkyline.begin() + i);
+        --i;
+    }
+
+    for (size_t i = 0; i + 1 < mSkyline.size(); ++i)
+    {
+        if (mSkyline[i].y == mSkyline[i + 1].y)
+        {
+            mSkyline[i].w += mSkyline[i + 1].w;
+            mSkyline.erase(mSkyline.begin() + i + 1);
+            --i;
+        }
+    }
+
+    result->x = node.x;
+    result->y = bestY;
+    result->w = w;
+    result->h = h;
+
+    mUsedArea += (long)w * h;
+    return true;
+}
+
+int RectPacker::getWidth()
+{
+    return mWidth;
+}
+
+int RectPacker::getHeight()
+{
+    return mHeight;
+}
+
+float RectPacker::getOccupancy()
+{
+    if (mWidth == 0 || mHeight == 0)
+    {
+        return 0.0f;
+    }
+
+    return (float)mUsedArea / ((float)mWidth * mHeight);
+}
@@ -0,0 +1,40 @@
+#ifndef RECT_PACKER_H
+#define RECT_PACKER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Skyline bottom-left bin packer used to place images inside atlas pages.
+class RectPacker
+{
+public:
+    RectPacker();
+    RectPacker(int width, int height);
+
+    void reset(int width, int height);
+
+    bool insert(int w, int h, SDL_Rect *result);
+
+    int getWidth();
+    int getHeight();
+
+    float getOccupancy();
+
+private:
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int w;
+    };
+
+    int fit(int index, int w, int h);
+
+    std::vector<SkylineNode> mSkyline;
+
+    int mWidth;
+    int mHeight;
+    long mUsedArea;
+};
+
+#endif
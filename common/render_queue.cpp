@@ -0,0 +1,399 @@
+#include "render_queue.h"
+#include <algorithm>
+#include <cstring>
+#include "key_alpha.h"
+#include "profiler.h"
+
+static Uint32 packColor(SDL_Color color)
+{
+    return ((Uint32)color.r << 24) | ((Uint32)color.g << 16) | ((Uint32)color.b << 8) | color.a;
+}
+
+static bool sameColor(SDL_Color a, SDL_Color b)
+{
+    return packColor(a) == packColor(b);
+}
+
+RenderQueue::RenderQueue()
+{
+    mLayer = 0;
+    mColor.r = 0xFF;
+    mColor.g = 0xFF;
+    mColor.b = 0xFF;
+    mColor.a = 0xFF;
+    mBlendMode = SDL_BLENDMODE_BLEND;
+
+    mDrawColor = mColor;
+    mDrawBlendMode = SDL_BLENDMODE_NONE;
+
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+void RenderQueue::setLayer(int layer)
+{
+    mLayer = layer;
+}
+
+void RenderQueue::setColor(Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha)
+{
+    mColor.r = red;
+    mColor.g = green;
+    mColor.b = blue;
+    mColor.a = alpha;
+}
+
+void RenderQueue::setBlendMode(SDL_BlendMode blend_mode)
+{
+    mBlendMode = blend_mode;
+}
+
+int RenderQueue::textureSlot(SDL_Texture *texture)
+{
+    // Slots follow first use, so the sort does not depend on pointer values.
+    for (size_t i = mTextures.size(); i > 0; --i)
+    {
+        if (mTextures[i - 1].texture == texture)
+        {
+            return (int)i;
+        }
+    }
+
+    TextureState state;
+    memset(&state, 0, sizeof(state));
+    state.texture = texture;
+    mTextures.push_back(state);
+
+    return (int)mTextures.size();
+}
+
+int RenderQueue::blendSlot(SDL_BlendMode blend_mode)
+{
+    for (size_t i = 0; i < mBlendModes.size(); ++i)
+    {
+        if (mBlendModes[i] == blend_mode)
+        {
+            return (int)i;
+        }
+    }
+
+    mBlendModes.push_back(blend_mode);
+    return (int)mBlendModes.size() - 1;
+}
+
+RenderQueue::Command &RenderQueue::push(CommandType type, int texture)
+{
+    Command command;
+    memset(&command, 0, sizeof(command));
+
+    command.type = type;
+    command.texture = texture;
+    command.blendMode = mBlendMode;
+    command.rgba = mColor;
+    command.color = packColor(mColor);
+    command.order = (int)mCommands.size();
+
+    // Primitives use texture slot 0, so they sort ahead of copies in a layer.
+    Uint64 layer = (Uint16)(mLayer + 0x8000);
+    command.key = (layer << 48) | ((Uint64)(texture & 0xFFFF) << 32) | ((Uint64)(blendSlot(mBlendMode) & 0xFF) << 24);
+
+    mCommands.push_back(command);
+    return mCommands.back();
+}
+
+void RenderQueue::fillRect(const SDL_Rect &rect)
+{
+    push(COMMAND_FILL_RECT, 0).dest = rect;
+}
+
+void RenderQueue::drawRect(const SDL_Rect &rect)
+{
+    push(COMMAND_DRAW_RECT, 0).dest = rect;
+}
+
+void RenderQueue::drawLine(int x1, int y1, int x2, int y2)
+{
+    Command &command = push(COMMAND_LINE, 0);
+    command.dest.x = x1;
+    command.dest.y = y1;
+    command.dest.w = x2;
+    command.dest.h = y2;
+}
+
+void RenderQueue::drawPoint(int x, int y)
+{
+    Command &command = push(COMMAND_POINT, 0);
+    command.dest.x = x;
+    command.dest.y = y;
+}
+
+void RenderQueue::copy(SDL_Texture *texture, const SDL_Rect *source, const SDL_Rect &dest, double angle, const SDL_Point *center, SDL_RendererFlip flip)
+{
+    if (texture == NULL)
+    {
+        return;
+    }
+
+    Command &command = push(COMMAND_COPY, textureSlot(texture));
+    command.dest = dest;
+    command.angle = angle;
+    command.flip = flip;
+
+    if (source != NULL)
+    {
+        command.source = *source;
+        command.hasSource = true;
+    }
+    if (center != NULL)
+    {
+        command.center = *center;
+        command.hasCenter = true;
+    }
+}
+
+void RenderQueue::copy(const LTexture &texture, int x, int y, const SDL_Rect *clip, double angle, const SDL_Point *center, SDL_RendererFlip flip)
+{
+    SDL_Rect dest = {x, y, texture.getWidth(), texture.getHeight()};
+    if (clip != NULL)
+    {
+        dest.w = clip->w;
+        dest.h = clip->h;
+    }
+
+    if (!texture.isPremultiplied())
+    {
+        copy(texture.getTexture(), clip, dest, angle, center, flip);
+        return;
+    }
+
+    // Premultiplied textures fade by scaling color along with alpha.
+    SDL_Color color = mColor;
+    SDL_BlendMode blendMode = mBlendMode;
+
+    setColor(color.r * color.a / 0xFF, color.g * color.a / 0xFF, color.b * color.a / 0xFF, color.a);
+    if (blendMode == SDL_BLENDMODE_BLEND)
+    {
+        mBlendMode = getPremultipliedBlendMode();
+    }
+
+    copy(texture.getTexture(), clip, dest, angle, center, flip);
+
+    mColor = color;
+    mBlendMode = blendMode;
+}
+
+bool RenderQueue::submitOrder(const Command &a, const Command &b)
+{
+    if (a.key != b.key)
+    {
+        return a.key < b.key;
+    }
+    if (a.color != b.color)
+    {
+        return a.color < b.color;
+    }
+    if (a.type != b.type)
+    {
+        return a.type < b.type;
+    }
+    return a.order < b.order;
+}
+
+bool RenderQueue::sameState(const Command &a, const Command &b)
+{
+    return a.texture == b.texture && a.blendMode == b.blendMode && a.color == b.color;
+}
+
+void RenderQueue::applyDrawState(SDL_Renderer *renderer, const Command &command)
+{
+    if (!sameColor(mDrawColor, command.rgba))
+    {
+        SDL_SetRenderDrawColor(renderer, command.rgba.r, command.rgba.g, command.rgba.b, command.rgba.a);
+        mDrawColor = command.rgba;
+        ++mStats.stateChanges;
+    }
+    else
+    {
+        ++mStats.stateChangesAvoided;
+    }
+
+    if (mDrawBlendMode != command.blendMode)
+    {
+        SDL_SetRenderDrawBlendMode(renderer, command.blendMode);
+        mDrawBlendMode = command.blendMode;
+        ++mStats.stateChanges;
+    }
+    else
+    {
+        ++mStats.stateChangesAvoided;
+    }
+}
+
+void RenderQueue::applyTextureState(const Command &command)
+{
+    TextureState &state = mTextures[command.texture - 1];
+
+    if (state.mod.r != command.rgba.r || state.mod.g != command.rgba.g || state.mod.b != command.rgba.b)
+    {
+        SDL_SetTextureColorMod(state.texture, command.rgba.r, command.rgba.g, command.rgba.b);
+        ++mStats.stateChanges;
+    }
+    else
+    {
+        ++mStats.stateChangesAvoided;
+    }
+
+    if (state.mod.a != command.rgba.a)
+    {
+        SDL_SetTextureAlphaMod(state.texture, command.rgba.a);
+        ++mStats.stateChanges;
+    }
+    else
+    {
+        ++mStats.stateChangesAvoided;
+    }
+
+    if (state.blendMode != command.blendMode)
+    {
+        SDL_SetTextureBlendMode(state.texture, command.blendMode);
+        ++mStats.stateChanges;
+    }
+    else
+    {
+        ++mStats.stateChangesAvoided;
+    }
+
+    state.mod = command.rgba;
+    state.blendMode = command.blendMode;
+}
+
+void RenderQueue::execute(SDL_Renderer *renderer, size_t first, size_t last)
+{
+    const Command &command = mCommands[first];
+
+    if (command.type == COMMAND_COPY)
+    {
+        applyTextureState(command);
+
+        const SDL_Rect *source = command.hasSource ? &command.source : NULL;
+        if (command.angle == 0.0 && command.flip == SDL_FLIP_NONE)
+        {
+            SDL_RenderCopy(renderer, mTextures[command.texture - 1].texture, source, &command.dest);
+        }
+        else
+        {
+            SDL_RenderCopyEx(renderer, mTextures[command.texture - 1].texture, source, &command.dest, command.angle, command.hasCenter ? &command.center : NULL, command.flip);
+        }
+        ++mStats.drawCalls;
+        return;
+    }
+
+    applyDrawState(renderer, command);
+
+    // The rest of the run shares the state just applied.
+    mStats.stateChangesAvoided += (int)(last - first - 1) * 2;
+
+    switch (command.type)
+    {
+    case COMMAND_FILL_RECT:
+    case COMMAND_DRAW_RECT:
+        mRects.clear();
+        for (size_t i = first; i < last; ++i)
+        {
+            mRects.push_back(mCommands[i].dest);
+        }
+        if (command.type == COMMAND_FILL_RECT)
+        {
+            SDL_RenderFillRects(renderer, mRects.data(), (int)mRects.size());
+        }
+        else
+        {
+            SDL_RenderDrawRects(renderer, mRects.data(), (int)mRects.size());
+        }
+        break;
+
+    case COMMAND_POINT:
+        mPoints.clear();
+        for (size_t i = first; i < last; ++i)
+        {
+            SDL_Point point = {mCommands[i].dest.x, mCommands[i].dest.y};
+            mPoints.push_back(point);
+        }
+        SDL_RenderDrawPoints(renderer, mPoints.data(), (int)mPoints.size());
+        break;
+
+    case COMMAND_LINE:
+        SDL_RenderDrawLine(renderer, command.dest.x, command.dest.y, command.dest.w, command.dest.h);
+        break;
+
+    default:
+        break;
+    }
+    ++mStats.drawCalls;
+}
+
+void RenderQueue::submit(SDL_Renderer *renderer, bool keep)
+{
+    PROFILE_SCOPE("RenderQueue::submit");
+
+    memset(&mStats, 0, sizeof(mStats));
+    mStats.commands = (int)mCommands.size();
+
+    if (mCommands.empty())
+    {
+        return;
+    }
+
+    std::sort(mCommands.begin(), mCommands.end(), submitOrder);
+
+    // Start from what SDL already has, so the first commands can skip too.
+    SDL_GetRenderDrawColor(renderer, &mDrawColor.r, &mDrawColor.g, &mDrawColor.b, &mDrawColor.a);
+    SDL_GetRenderDrawBlendMode(renderer, &mDrawBlendMode);
+    for (size_t i = 0; i < mTextures.size(); ++i)
+    {
+        TextureState &state = mTextures[i];
+        SDL_GetTextureColorMod(state.texture, &state.mod.r, &state.mod.g, &state.mod.b);
+        SDL_GetTextureAlphaMod(state.texture, &state.mod.a);
+        SDL_GetTextureBlendMode(state.texture, &state.blendMode);
+    }
+
+    size_t first = 0;
+    while (first < mCommands.size())
+    {
+        size_t last = first + 1;
+
+        // Lines and copies draw one at a time; rects and points batch.
+        CommandType type = mCommands[first].type;
+        if (type != COMMAND_LINE && type != COMMAND_COPY)
+        {
+            while (last < mCommands.size() && mCommands[last].type == type && sameState(mCommands[first], mCommands[last]))
+            {
+                ++last;
+            }
+        }
+
+        execute(renderer, first, last);
+        first = last;
+    }
+
+    if (!keep)
+    {
+        clear();
+    }
+}
+
+void RenderQueue::clear()
+{
+    mCommands.clear();
+    mTextures.clear();
+    mBlendModes.clear();
+}
+
+int RenderQueue::getCommandCount() const
+{
+    return (int)mCommands.size();
+}
+
+const RenderQueueStats &RenderQueue::getStats() const
+{
+    return mStats;
+}
@@ -0,0 +1,126 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "ltexture.h"
+
+struct RenderQueueStats
+{
+    int commands;
+    int drawCalls;
+
+    // Color, alpha and blend changes sent to SDL, and the ones the
+    // commands asked for that already matched the current state.
+    int stateChanges;
+    int stateChangesAvoided;
+};
+
+// Records a frame's draws together with the state each one needs, then
+// submits them in one go. Commands are sorted by layer, texture, blend mode
+// and color, state calls that would not change anything are skipped, and
+// runs of rects or points with the same state go out as one call.
+//
+// Only layers keep their order; within a layer commands may be reordered,
+// so draws that overlap and must stack go on separate layers.
+class RenderQueue
+{
+public:
+    RenderQueue();
+
+    void setLayer(int layer);
+
+    // Draw color for primitives, color and alpha mod for textures
+    void setColor(Uint8 red, Uint8 green, Uint8 blue, Uint8 alpha = 0xFF);
+    void setBlendMode(SDL_BlendMode blend_mode);
+
+    void fillRect(const SDL_Rect &rect);
+    void drawRect(const SDL_Rect &rect);
+    void drawLine(int x1, int y1, int x2, int y2);
+    void drawPoint(int x, int y);
+
+    void copy(SDL_Texture *texture, const SDL_Rect *source, const SDL_Rect &dest, double angle = 0.0, const SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
+
+    // Same as LTexture::render, including premultiplied alpha
+    void copy(const LTexture &texture, int x, int y, const SDL_Rect *clip = NULL, double angle = 0.0, const SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
+
+    // Sorts, draws and clears. Renderer and texture state is left as the
+    // last command set it. With keep the commands stay queued, so the same
+    // frame can be drawn again, e.g. once per dirty region.
+    void submit(SDL_Renderer *renderer, bool keep = false);
+
+    void clear();
+
+    int getCommandCount() const;
+
+    // Stats of the last submit
+    const RenderQueueStats &getStats() const;
+
+private:
+    enum CommandType
+    {
+        COMMAND_FILL_RECT,
+        COMMAND_DRAW_RECT,
+        COMMAND_LINE,
+        COMMAND_POINT,
+        COMMAND_COPY
+    };
+
+    struct Command
+    {
+        // Layer, texture slot and blend slot; color, type and order break ties.
+        Uint64 key;
+        Uint32 color;
+        int order;
+
+        CommandType type;
+        int texture;
+        SDL_BlendMode blendMode;
+        SDL_Color rgba;
+
+        SDL_Rect source;
+        SDL_Rect dest;
+        bool hasSource;
+
+        double angle;
+        SDL_Point center;
+        bool hasCenter;
+        SDL_RendererFlip flip;
+    };
+
+    struct TextureState
+    {
+        SDL_Texture *texture;
+        SDL_Color mod;
+        SDL_BlendMode blendMode;
+    };
+
+    static bool submitOrder(const Command &a, const Command &b);
+    static bool sameState(const Command &a, const Command &b);
+
+    Command &push(CommandType type, int texture);
+    int textureSlot(SDL_Texture *texture);
+    int blendSlot(SDL_BlendMode blend_mode);
+
+    void applyDrawState(SDL_Renderer *renderer, const Command &command);
+    void applyTextureState(const Command &command);
+    void execute(SDL_Renderer *renderer, size_t first, size_t last);
+
+    std::vector<Command> mCommands;
+    std::vector<TextureState> mTextures;
+    std::vector<SDL_BlendMode> mBlendModes;
+
+    std::vector<SDL_Rect> mRects;
+    std::vector<SDL_Point> mPoints;
+
+    int mLayer;
+    SDL_Color mColor;
+    SDL_BlendMode mBlendMode;
+
+    SDL_Color mDrawColor;
+    SDL_BlendMode mDrawBlendMode;
+
+    RenderQueueStats mStats;
+};
+
+#endif
@@ -0,0 +1,833 @@
+#include "soft_blit.h"
+#include <atomic>
+#include <cstring>
+#include "profiler.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SOFT_BLIT_X86 1
+#include <immintrin.h>
+#define SSE41_TARGET __attribute__((target("sse4.1")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+#if defined(__ARM_NEON) && SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define SOFT_BLIT_NEON 1
+#include <arm_neon.h>
+#endif
+
+const Uint32 RGB_MASK = 0x00FFFFFF;
+const Uint32 ALPHA_MASK = 0xFF000000;
+const int SCRATCH_PIXELS = 256;
+
+typedef void (*ConvertRow)(const Uint8 *src, Uint32 *dst, int count);
+
+// Rounded x / 255 for x <= 255 * 255. The SIMD kernels use the same
+// formula on 16-bit lanes so every kernel set agrees to the bit.
+static inline Uint32 div255(Uint32 x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline Uint32 blendPixel(Uint32 s, Uint32 d)
+{
+    Uint32 a = s >> 24;
+    Uint32 ia = 255 - a;
+
+    Uint32 outA = div255(255 * a + (d >> 24) * ia);
+    Uint32 outR = div255(((s >> 16) & 0xFF) * a + ((d >> 16) & 0xFF) * ia);
+    Uint32 outG = div255(((s >> 8) & 0xFF) * a + ((d >> 8) & 0xFF) * ia);
+    Uint32 outB = div255((s & 0xFF) * a + (d & 0xFF) * ia);
+
+    return (outA << 24) | (outR << 16) | (outG << 8) | outB;
+}
+
+static inline Uint32 modulatePixel(Uint32 s, Uint32 mod)
+{
+    Uint32 outA = div255((s >> 24) * (mod >> 24));
+    Uint32 outR = div255(((s >> 16) & 0xFF) * ((mod >> 16) & 0xFF));
+    Uint32 outG = div255(((s >> 8) & 0xFF) * ((mod >> 8) & 0xFF));
+    Uint32 outB = div255((s & 0xFF) * (mod & 0xFF));
+
+    return (outA << 24) | (outR << 16) | (outG << 8) | outB;
+}
+
+static void rgb24ToArgbScalar(const Uint8 *src, Uint32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i, src += 3)
+    {
+        dst[i] = ALPHA_MASK | ((Uint32)src[0] << 16) | ((Uint32)src[1] << 8) | src[2];
+    }
+}
+
+static void bgr24ToArgbScalar(const Uint8 *src, Uint32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i, src += 3)
+    {
+        dst[i] = ALPHA_MASK | ((Uint32)src[2] << 16) | ((Uint32)src[1] << 8) | src[0];
+    }
+}
+
+static void rgbaToArgbScalar(const Uint8 *src, Uint32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i, src += 4)
+    {
+        dst[i] = ((Uint32)src[3] << 24) | ((Uint32)src[0] << 16) | ((Uint32)src[1] << 8) | src[2];
+    }
+}
+
+static void copyKeyedScalar(const Uint32 *src, Uint32 *dst, int count, Uint32 key)
+{
+    key &= RGB_MASK;
+    for (int i = 0; i < count; ++i)
+    {
+        if ((src[i] & RGB_MASK) != key)
+        {
+            dst[i] = src[i];
+        }
+    }
+}
+
+static void blendScalar(const Uint32 *src, Uint32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        Uint32 a = src[i] >> 24;
+        if (a == 0xFF)
+        {
+            dst[i] = src[i];
+        }
+        else if (a != 0)
+        {
+            dst[i] = blendPixel(src[i], dst[i]);
+        }
+    }
+}
+
+static void modulateScalar(const Uint32 *src, Uint32 *dst, int count, Uint32 mod)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        dst[i] = modulatePixel(src[i], mod);
+    }
+}
+
+static const PixelKernels SCALAR_KERNELS = {
+    "scalar",
+    rgb24ToArgbScalar,
+    bgr24ToArgbScalar,
+    rgbaToArgbScalar,
+    copyKeyedScalar,
+    blendScalar,
+    modulateScalar};
+
+#ifdef SOFT_BLIT_X86
+
+// Two pixels widened to 16-bit lanes in, two blended pixels out.
+SSE41_TARGET static inline __m128i blendWideSse(__m128i s, __m128i d)
+{
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF);
+    __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+
+    // The output alpha is blended as if the source alpha channel held 255.
+    s = _mm_or_si128(s, _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255));
+
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(s, alpha), _mm_mullo_epi16(d, inverse));
+    t = _mm_add_epi16(t, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+SSE41_TARGET static inline __m128i modulateWideSse(__m128i s, __m128i mod)
+{
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(s, mod), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+SSE41_TARGET static void shuffle24Sse(const Uint8 *src, Uint32 *dst, int count, __m128i shuffle, ConvertRow tail)
+{
+    const __m128i alpha = _mm_set1_epi32((int)ALPHA_MASK);
+    int i = 0;
+
+    // Each 16-byte load consumes 12 bytes, so stop while a full load still
+    // stays inside the row.
+    for (; i + 6 <= count; i += 4)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i * 3));
+        pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha);
+        _mm_storeu_si128((__m128i *)(dst + i), pixels);
+    }
+
+    tail(src + i * 3, dst + i, count - i);
+}
+
+SSE41_TARGET static void rgb24ToArgbSse(const Uint8 *src, Uint32 *dst, int count)
+{
+    shuffle24Sse(src, dst, count, _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1), rgb24ToArgbScalar);
+}
+
+SSE41_TARGET static void bgr24ToArgbSse(const Uint8 *src, Uint32 *dst, int count)
+{
+    shuffle24Sse(src, dst, count, _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1), bgr24ToArgbScalar);
+}
+
+SSE41_TARGET static void rgbaToArgbSse(const Uint8 *src, Uint32 *dst, int count)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i * 4));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(pixels, shuffle));
+    }
+
+    rgbaToArgbScalar(src + i * 4, dst + i, count - i);
+}
+
+SSE41_TARGET static void copyKeyedSse(const Uint32 *src, Uint32 *dst, int count, Uint32 key)
+{
+    const __m128i mask = _mm_set1_epi32((int)RGB_MASK);
+    const __m128i keys = _mm_set1_epi32((int)(key & RGB_MASK));
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i keyed = _mm_cmpeq_epi32(_mm_and_si128(s, mask), keys);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_blendv_epi8(s, d, keyed));
+    }
+
+    copyKeyedScalar(src + i, dst + i, count - i, key);
+}
+
+SSE41_TARGET static void blendSse(const Uint32 *src, Uint32 *dst, int count)
+{
+    const __m128i alphaMask = _mm_set1_epi32((int)ALPHA_MASK);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+
+        // Sprites are mostly fully transparent or fully opaque runs.
+        if (_mm_testz_si128(s, alphaMask))
+        {
+            continue;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alphaMask), alphaMask)) == 0xFFFF)
+        {
+            _mm_storeu_si128((__m128i *)(dst + i), s);
+            continue;
+        }
+
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i lo = blendWideSse(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+        __m128i hi = blendWideSse(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+
+    blendScalar(src + i, dst + i, count - i);
+}
+
+SSE41_TARGET static void modulateSse(const Uint32 *src, Uint32 *dst, int count, Uint32 mod)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mods = _mm_unpacklo_epi8(_mm_set1_epi32((int)mod), zero);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i lo = modulateWideSse(_mm_unpacklo_epi8(s, zero), mods);
+        __m128i hi = modulateWideSse(_mm_unpackhi_epi8(s, zero), mods);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+
+    modulateScalar(src + i, dst + i, count - i, mod);
+}
+
+static const PixelKernels SSE41_KERNELS = {
+    "sse4.1",
+    rgb24ToArgbSse,
+    bgr24ToArgbSse,
+    rgbaToArgbSse,
+    copyKeyedSse,
+    blendSse,
+    modulateSse};
+
+AVX2_TARGET static inline __m256i blendWideAvx(__m256i s, __m256i d)
+{
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xFF), 0xFF);
+    __m256i inverse = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+
+    s = _mm256_or_si256(s, _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255));
+
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(s, alpha), _mm256_mullo_epi16(d, inverse));
+    t = _mm256_add_epi16(t, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+AVX2_TARGET static inline __m256i modulateWideAvx(__m256i s, __m256i mod)
+{
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(s, mod), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+
+AVX2_TARGET static void shuffle24Avx(const Uint8 *src, Uint32 *dst, int count, __m256i shuffle, ConvertRow tail)
+{
+    const __m256i alpha = _mm256_set1_epi32((int)ALPHA_MASK);
+    int i = 0;
+
+    // Two 16-byte loads 12 bytes apart feed the two 128-bit lanes, so the
+    // second load ends 28 bytes into the block.
+    for (; i + 10 <= count; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(src + i * 3));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(src + i * 3 + 12));
+        __m256i pixels = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        pixels = _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle), alpha);
+        _mm256_storeu_si256((__m256i *)(dst + i), pixels);
+    }
+
+    tail(src + i * 3, dst + i, count - i);
+}
+
+AVX2_TARGET static void rgb24ToArgbAvx(const Uint8 *src, Uint32 *dst, int count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+                                             2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    shuffle24Avx(src, dst, count, shuffle, rgb24ToArgbScalar);
+}
+
+AVX2_TARGET static void bgr24ToArgbAvx(const Uint8 *src, Uint32 *dst, int count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                             0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    shuffle24Avx(src, dst, count, shuffle, bgr24ToArgbScalar);
+}
+
+AVX2_TARGET static void rgbaToArgbAvx(const Uint8 *src, Uint32 *dst, int count)
+{
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                             2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i pixels = _mm256_loadu_si256((const __m256i *)(src + i * 4));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_shuffle_epi8(pixels, shuffle));
+    }
+
+    rgbaToArgbScalar(src + i * 4, dst + i, count - i);
+}
+
+AVX2_TARGET static void copyKeyedAvx(const Uint32 *src, Uint32 *dst, int count, Uint32 key)
+{
+    const __m256i mask = _mm256_set1_epi32((int)RGB_MASK);
+    const __m256i keys = _mm256_set1_epi32((int)(key & RGB_MASK));
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i keyed = _mm256_cmpeq_epi32(_mm256_and_si256(s, mask), keys);
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_blendv_epi8(s, d, keyed));
+    }
+
+    copyKeyedScalar(src + i, dst + i, count - i, key);
+}
+
+AVX2_TARGET static void blendAvx(const Uint32 *src, Uint32 *dst, int count)
+{
+    const __m256i alphaMask = _mm256_set1_epi32((int)ALPHA_MASK);
+    const __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+
+        if (_mm256_testz_si256(s, alphaMask))
+        {
+            continue;
+        }
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(s, alphaMask), alphaMask)) == -1)
+        {
+            _mm256_storeu_si256((__m256i *)(dst + i), s);
+            continue;
+        }
+
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i lo = blendWideAvx(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+        __m256i hi = blendWideAvx(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+
+    blendScalar(src + i, dst + i, count - i);
+}
+
+AVX2_TARGET static void modulateAvx(const Uint32 *src, Uint32 *dst, int count, Uint32 mod)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mods = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)mod), zero);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i lo = modulateWideAvx(_mm256_unpacklo_epi8(s, zero), mods);
+        __m256i hi = modulateWideAvx(_mm256_unpackhi_epi8(s, zero), mods);
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+
+    modulateScalar(src + i, dst + i, count - i, mod);
+}
+
+static const PixelKernels AVX2_KERNELS = {
+    "avx2",
+    rgb24ToArgbAvx,
+    bgr24ToArgbAvx,
+    rgbaToArgbAvx,
+    copyKeyedAvx,
+    blendAvx,
+    modulateAvx};
+
+#endif
+
+#ifdef SOFT_BLIT_NEON
+
+// Same rounding as div255: (t + ((t + 128) >> 8) + 128) >> 8.
+static inline uint8x8_t div255Neon(uint16x8_t t)
+{
+    return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+
+static void rgb24ToArgbNeon(const Uint8 *src, Uint32 *dst, int count)
+{
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+        uint8x16x4_t bgra;
+        bgra.val[0] = rgb.val[2];
+        bgra.val[1] = rgb.val[1];
+        bgra.val[2] = rgb.val[0];
+        bgra.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8((Uint8 *)(dst + i), bgra);
+    }
+
+    rgb24ToArgbScalar(src + i * 3, dst + i, count - i);
+}
+
+static void bgr24ToArgbNeon(const Uint8 *src, Uint32 *dst, int count)
+{
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x3_t bgr = vld3q_u8(src + i * 3);
+        uint8x16x4_t bgra;
+        bgra.val[0] = bgr.val[0];
+        bgra.val[1] = bgr.val[1];
+        bgra.val[2] = bgr.val[2];
+        bgra.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8((Uint8 *)(dst + i), bgra);
+    }
+
+    bgr24ToArgbScalar(src + i * 3, dst + i, count - i);
+}
+
+static void rgbaToArgbNeon(const Uint8 *src, Uint32 *dst, int count)
+{
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        uint8x16x4_t rgba = vld4q_u8(src + i * 4);
+        uint8x16_t red = rgba.val[0];
+        rgba.val[0] = rgba.val[2];
+        rgba.val[2] = red;
+        vst4q_u8((Uint8 *)(dst + i), rgba);
+    }
+
+    rgbaToArgbScalar(src + i * 4, dst + i, count - i);
+}
+
+static void copyKeyedNeon(const Uint32 *src, Uint32 *dst, int count, Uint32 key)
+{
+    const uint32x4_t mask = vdupq_n_u32(RGB_MASK);
+    const uint32x4_t keys = vdupq_n_u32(key & RGB_MASK);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t s = vld1q_u32(src + i);
+        uint32x4_t d = vld1q_u32(dst + i);
+        uint32x4_t keyed = vceqq_u32(vandq_u32(s, mask), keys);
+        vst1q_u32(dst + i, vbslq_u32(keyed, d, s));
+    }
+
+    copyKeyedScalar(src + i, dst + i, count - i, key);
+}
+
+static void blendNeon(const Uint32 *src, Uint32 *dst, int count)
+{
+    const uint8x8_t opaque = vdup_n_u8(0xFF);
+    int i = 0;
+
+    // Little endian ARGB8888 deinterleaves into B, G, R, A planes.
+    for (; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t s = vld4_u8((const Uint8 *)(src + i));
+        Uint64 alphaBits = vget_lane_u64(vreinterpret_u64_u8(s.val[3]), 0);
+
+        if (alphaBits == 0)
+        {
+            continue;
+        }
+        if (alphaBits == ~(Uint64)0)
+        {
+            vst4_u8((Uint8 *)(dst + i), s);
+            continue;
+        }
+
+        uint8x8x4_t d = vld4_u8((const Uint8 *)(dst + i));
+        uint8x8_t a = s.val[3];
+        uint8x8_t ia = vsub_u8(opaque, a);
+
+        for (int c = 0; c < 3; ++c)
+        {
+            d.val[c] = div255Neon(vmlal_u8(vmull_u8(s.val[c], a), d.val[c], ia));
+        }
+        d.val[3] = div255Neon(vmlal_u8(vmull_u8(opaque, a), d.val[3], ia));
+
+        vst4_u8((Uint8 *)(dst + i), d);
+    }
+
+    blendScalar(src + i, dst + i, count - i);
+}
+
+static void modulateNeon(const Uint32 *src, Uint32 *dst, int count, Uint32 mod)
+{
+    uint8x8_t mods[4];
+    mods[0] = vdup_n_u8(mod & 0xFF);
+    mods[1] = vdup_n_u8((mod >> 8) & 0xFF);
+    mods[2] = vdup_n_u8((mod >> 16) & 0xFF);
+    mods[3] = vdup_n_u8(mod >> 24);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        uint8x8x4_t s = vld4_u8((const Uint8 *)(src + i));
+
+        for (int c = 0; c < 4; ++c)
+        {
+            s.val[c] = div255Neon(vmull_u8(s.val[c], mods[c]));
+        }
+
+        vst4_u8((Uint8 *)(dst + i), s);
+    }
+
+    modulateScalar(src + i, dst + i, count - i, mod);
+}
+
+static const PixelKernels NEON_KERNELS = {
+    "neon",
+    rgb24ToArgbNeon,
+    bgr24ToArgbNeon,
+    rgbaToArgbNeon,
+    copyKeyedNeon,
+    blendNeon,
+    modulateNeon};
+
+#endif
+
+static std::atomic<const PixelKernels *> gPixelKernels(NULL);
+
+static const PixelKernels *detectPixelKernels()
+{
+    const PixelKernelSet preferred[] = {PIXEL_KERNELS_AVX2, PIXEL_KERNELS_SSE41, PIXEL_KERNELS_NEON};
+
+    for (size_t i = 0; i < sizeof(preferred) / sizeof(preferred[0]); ++i)
+    {
+        const PixelKernels *kernels = getPixelKernels(preferred[i]);
+        if (kernels != NULL)
+        {
+            return kernels;
+        }
+    }
+
+    return &SCALAR_KERNELS;
+}
+
+const PixelKernels &getPixelKernels()
+{
+    const PixelKernels *kernels = gPixelKernels.load(std::memory_order_acquire);
+    if (kernels == NULL)
+    {
+        kernels = detectPixelKernels();
+        gPixelKernels.store(kernels, std::memory_order_release);
+    }
+
+    return *kernels;
+}
+
+const PixelKernels *getPixelKernels(PixelKernelSet set)
+{
+    switch (set)
+    {
+    case PIXEL_KERNELS_AUTO:
+        return detectPixelKernels();
+    case PIXEL_KERNELS_SCALAR:
+        return &SCALAR_KERNELS;
+#ifdef SOFT_BLIT_X86
+    case PIXEL_KERNELS_SSE41:
+        return SDL_HasSSE41() ? &SSE41_KERNELS : NULL;
+    case PIXEL_KERNELS_AVX2:
+        return SDL_HasAVX2() ? &AVX2_KERNELS : NULL;
+#endif
+#ifdef SOFT_BLIT_NEON
+    case PIXEL_KERNELS_NEON:
+        return SDL_HasNEON() ? &NEON_KERNELS : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+bool setPixelKernels(PixelKernelSet set)
+{
+    const PixelKernels *kernels = getPixelKernels(set);
+    if (kernels == NULL)
+    {
+        return false;
+    }
+
+    gPixelKernels.store(kernels, std::memory_order_release);
+    return true;
+}
+
+static bool isArgbLayout(Uint32 format)
+{
+    return format == SDL_PIXELFORMAT_ARGB8888 || format == SDL_PIXELFORMAT_RGB888;
+}
+
+SDL_Surface *softConvertSurface(SDL_Surface *surface, Uint32 format)
+{
+    PROFILE_SCOPE("softConvertSurface");
+
+    ConvertRow convertRow = NULL;
+
+    // Color keyed sources need SDL's key to alpha conversion.
+    if (SDL_BYTEORDER == SDL_LIL_ENDIAN && surface != NULL && isArgbLayout(format) && !SDL_HasColorKey(surface))
+    {
+        const PixelKernels &kernels = getPixelKernels();
+
+        switch (surface->format->format)
+        {
+        case SDL_PIXELFORMAT_RGB24:
+            convertRow = kernels.rgb24ToArgb;
+            break;
+        case SDL_PIXELFORMAT_BGR24:
+            convertRow = kernels.bgr24ToArgb;
+            break;
+        case SDL_PIXELFORMAT_RGBA32:
+            convertRow = kernels.rgbaToArgb;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (convertRow == NULL)
+    {
+        return SDL_ConvertSurfaceFormat(surface, format, 0);
+    }
+
+    SDL_Surface *converted = SDL_CreateRGBSurfaceWithFormat(0, surface->w, surface->h, 32, format);
+    if (converted == NULL)
+    {
+        return NULL;
+    }
+
+    if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) < 0)
+    {
+        SDL_FreeSurface(converted);
+        return NULL;
+    }
+
+    for (int y = 0; y < surface->h; ++y)
+    {
+        const Uint8 *srcRow = (const Uint8 *)surface->pixels + y * surface->pitch;
+        Uint32 *dstRow = (Uint32 *)((Uint8 *)converted->pixels + y * converted->pitch);
+        convertRow(srcRow, dstRow, surface->w);
+    }
+
+    if (SDL_MUSTLOCK(surface))
+    {
+        SDL_UnlockSurface(surface);
+    }
+
+    SDL_BlendMode blendMode;
+    if (SDL_GetSurfaceBlendMode(surface, &blendMode) == 0)
+    {
+        SDL_SetSurfaceBlendMode(converted, blendMode);
+    }
+
+    return converted;
+}
+
+int softBlitSurface(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect)
+{
+    PROFILE_SCOPE("softBlitSurface");
+
+    if (src == NULL || dst == NULL || !isArgbLayout(src->format->format) || !isArgbLayout(dst->format->format))
+    {
+        return SDL_BlitSurface(src, srcrect, dst, dstrect);
+    }
+
+    SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+    Uint8 r = 0xFF;
+    Uint8 g = 0xFF;
+    Uint8 b = 0xFF;
+    Uint8 alpha = 0xFF;
+    Uint32 key = 0;
+
+    SDL_GetSurfaceBlendMode(src, &blendMode);
+    SDL_GetSurfaceColorMod(src, &r, &g, &b);
+    SDL_GetSurfaceAlphaMod(src, &alpha);
+    bool keyed = SDL_GetColorKey(src, &key) == 0;
+
+    Uint32 mod = ((Uint32)alpha << 24) | ((Uint32)r << 16) | ((Uint32)g << 8) | b;
+    bool modulated = mod != 0xFFFFFFFF;
+    bool blended = blendMode == SDL_BLENDMODE_BLEND && src->format->Amask != 0;
+
+    // Leave the combinations whose exact SDL semantics the kernels do not
+    // reproduce (constant alpha, additive modes, keyed plus blended, opaque
+    // alpha fill) to SDL.
+    bool supported = blendMode == SDL_BLENDMODE_NONE || blendMode == SDL_BLENDMODE_BLEND;
+    supported = supported && !(keyed && (blended || modulated));
+    supported = supported && (blended || alpha == 0xFF);
+    supported = supported && !(src->format->Amask == 0 && dst->format->Amask != 0);
+    if (!supported)
+    {
+        return SDL_BlitSurface(src, srcrect, dst, dstrect);
+    }
+
+    SDL_Rect area = {0, 0, src->w, src->h};
+    if (srcrect != NULL)
+    {
+        area = *srcrect;
+    }
+    int x = dstrect != NULL ? dstrect->x : 0;
+    int y = dstrect != NULL ? dstrect->y : 0;
+
+    // Clip against the source surface, then the destination clip rect.
+    if (area.x < 0)
+    {
+        x -= area.x;
+        area.w += area.x;
+        area.x = 0;
+    }
+    if (area.y < 0)
+    {
+        y -= area.y;
+        area.h += area.y;
+        area.y = 0;
+    }
+    area.w = SDL_min(area.w, src->w - area.x);
+    area.h = SDL_min(area.h, src->h - area.y);
+
+    const SDL_Rect &clip = dst->clip_rect;
+    if (x < clip.x)
+    {
+        area.x += clip.x - x;
+        area.w -= clip.x - x;
+        x = clip.x;
+    }
+    if (y < clip.y)
+    {
+        area.y += clip.y - y;
+        area.h -= clip.y - y;
+        y = clip.y;
+    }
+    area.w = SDL_min(area.w, clip.x + clip.w - x);
+    area.h = SDL_min(area.h, clip.y + clip.h - y);
+
+    if (dstrect != NULL)
+    {
+        dstrect->x = x;
+        dstrect->y = y;
+        dstrect->w = SDL_max(area.w, 0);
+        dstrect->h = SDL_max(area.h, 0);
+    }
+
+    if (area.w <= 0 || area.h <= 0)
+    {
+        return 0;
+    }
+
+    if (SDL_MUSTLOCK(src) && SDL_LockSurface(src) < 0)
+    {
+        return -1;
+    }
+    if (SDL_MUSTLOCK(dst) && SDL_LockSurface(dst) < 0)
+    {
+        if (SDL_MUSTLOCK(src))
+        {
+            SDL_UnlockSurface(src);
+        }
+        return -1;
+    }
+
+    const PixelKernels &kernels = getPixelKernels();
+    Uint32 scratch[SCRATCH_PIXELS];
+
+    for (int row = 0; row < area.h; ++row)
+    {
+        const Uint32 *srcRow = (const Uint32 *)((const Uint8 *)src->pixels + (area.y + row) * src->pitch) + area.x;
+        Uint32 *dstRow = (Uint32 *)((Uint8 *)dst->pixels + (y + row) * dst->pitch) + x;
+
+        if (keyed)
+        {
+            kernels.copyKeyed(srcRow, dstRow, area.w, key);
+        }
+        else if (blended && modulated)
+        {
+            for (int i = 0; i < area.w; i += SCRATCH_PIXELS)
+            {
+                int count = SDL_min(SCRATCH_PIXELS, area.w - i);
+                kernels.modulate(srcRow + i, scratch, count, mod);
+                kernels.blend(scratch, dstRow + i, count);
+            }
+        }
+        else if (blended)
+        {
+            kernels.blend(srcRow, dstRow, area.w);
+        }
+        else if (modulated)
+        {
+            kernels.modulate(srcRow, dstRow, area.w, mod);
+        }
+        else
+        {
+            memcpy(dstRow, srcRow, area.w * sizeof(Uint32));
+        }
+    }
+
+    if (SDL_MUSTLOCK(dst))
+    {
+        SDL_UnlockSurface(dst);
+    }
+    if (SDL_MUSTLOCK(src))
+    {
+        SDL_UnlockSurface(src);
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef SOFT_BLIT_H
+#define SOFT_BLIT_H
+
+#include <SDL2/SDL.h>
+
+// Row kernels behind the software surface path. Destination pixels are
+// ARGB8888 (or XRGB8888, which shares the layout) and every instruction set
+// produces bit-identical output to the scalar version.
+struct PixelKernels
+{
+    const char *name;
+
+    // Packed byte formats to ARGB8888 with opaque alpha where there is none.
+    void (*rgb24ToArgb)(const Uint8 *src, Uint32 *dst, int count);
+    void (*bgr24ToArgb)(const Uint8 *src, Uint32 *dst, int count);
+    void (*rgbaToArgb)(const Uint8 *src, Uint32 *dst, int count);
+
+    // Copies every pixel whose RGB differs from key.
+    void (*copyKeyed)(const Uint32 *src, Uint32 *dst, int count, Uint32 key);
+
+    // Source-over blend using the source alpha channel.
+    void (*blend)(const Uint32 *src, Uint32 *dst, int count);
+
+    // Multiplies each channel by the matching channel of mod (0xAARRGGBB).
+    void (*modulate)(const Uint32 *src, Uint32 *dst, int count, Uint32 mod);
+};
+
+enum PixelKernelSet
+{
+    PIXEL_KERNELS_AUTO,
+    PIXEL_KERNELS_SCALAR,
+    PIXEL_KERNELS_SSE41,
+    PIXEL_KERNELS_AVX2,
+    PIXEL_KERNELS_NEON
+};
+
+// Kernels in use, picked from the CPU features on first call.
+const PixelKernels &getPixelKernels();
+
+// Returns NULL when the set was not compiled in or the CPU lacks it.
+const PixelKernels *getPixelKernels(PixelKernelSet set);
+
+// Forces a kernel set, mostly for benchmarks. PIXEL_KERNELS_AUTO restores
+// the CPU based choice.
+bool setPixelKernels(PixelKernelSet set);
+
+// Drop-in for SDL_ConvertSurfaceFormat. RGB24, BGR24 and RGBA32 sources going
+// to ARGB8888 or XRGB8888 use the kernels, everything else goes through SDL.
+SDL_Surface *softConvertSurface(SDL_Surface *surface, Uint32 format);
+
+// Drop-in for SDL_BlitSurface with the same clipping rules. 32-bit
+// ARGB/XRGB surfaces with a color key, alpha blending or color/alpha
+// modulation use the kernels, everything else goes through SDL.
+int softBlitSurface(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect);
+
+#endif
@@ -0,0 +1,97 @@
+#include "spatial_hash.h"
+#include <algorithm>
+#include "profiler.h"
+
+SpatialHash::SpatialHash(int cellSize)
+{
+    reset(cellSize);
+}
+
+void SpatialHash::reset(int cellSize)
+{
+    mGrid.reset(cellSize);
+    mStamp.clear();
+    mQueryStamp = 0;
+}
+
+int SpatialHash::add(SDL_Rect bounds)
+{
+    int id = mGrid.add(bounds);
+    if (id >= (int)mStamp.size())
+    {
+        mStamp.resize(id + 1);
+    }
+    mStamp[id] = 0;
+
+    return id;
+}
+
+void SpatialHash::remove(int id)
+{
+    mGrid.remove(id);
+}
+
+void SpatialHash::move(int id, SDL_Rect bounds)
+{
+    mGrid.move(id, bounds);
+}
+
+void SpatialHash::query(const SDL_Rect &area, std::vector<int> &results)
+{
+    PROFILE_SCOPE("SpatialHash::query");
+
+    results.clear();
+    if (area.w <= 0 || area.h <= 0)
+    {
+        return;
+    }
+
+    // Objects spanning several cells are reported once, tracked by stamp.
+    if (++mQueryStamp == 0)
+    {
+        std::fill(mStamp.begin(), mStamp.end(), 0);
+        mQueryStamp = 1;
+    }
+
+    int x0, y0, x1, y1;
+    mGrid.cellRange(area, &x0, &y0, &x1, &y1);
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            const std::vector<int> *cell = mGrid.getCell(x, y);
+            if (cell == NULL)
+            {
+                continue;
+            }
+
+            for (size_t i = 0; i < cell->size(); ++i)
+            {
+                int id = (*cell)[i];
+                if (mStamp[id] != mQueryStamp)
+                {
+                    mStamp[id] = mQueryStamp;
+                    if (SDL_HasIntersection(&mGrid.getBounds(id), &area))
+                    {
+                        results.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+}
+
+const SDL_Rect &SpatialHash::getBounds(int id) const
+{
+    return mGrid.getBounds(id);
+}
+
+int SpatialHash::getCount() const
+{
+    return mGrid.getCount();
+}
+
+int SpatialHash::getCellCount() const
+{
+    return mGrid.getCellCount();
+}
@@ -0,0 +1,39 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "cell_grid.h"
+
+// Unbounded grid over world space for visibility and area queries. Only
+// occupied cells exist, so a world many screens wide costs memory per
+// object, not per area, and a query only visits the cells it covers.
+class SpatialHash
+{
+public:
+    SpatialHash(int cellSize = 256);
+
+    // Drops every object
+    void reset(int cellSize);
+
+    // Returns the object id; ids of removed objects are reused.
+    int add(SDL_Rect bounds);
+    void remove(int id);
+    void move(int id, SDL_Rect bounds);
+
+    // Replaces results with the ids of objects overlapping area, each once
+    void query(const SDL_Rect &area, std::vector<int> &results);
+
+    const SDL_Rect &getBounds(int id) const;
+    int getCount() const;
+    int getCellCount() const;
+
+private:
+    CellGrid mGrid;
+
+    // Per object, indexed by id
+    std::vector<Uint32> mStamp;
+    Uint32 mQueryStamp;
+};
+
+#endif
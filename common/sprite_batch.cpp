@@ -0,0 +1,244 @@
+#include "sprite_batch.h"
+#include <algorithm>
+#include <cmath>
+#include "profiler.h"
+
+SpriteBatch::SpriteBatch()
+{
+    mColor.r = 0xFF;
+    mColor.g = 0xFF;
+    mColor.b = 0xFF;
+    mColor.a = 0xFF;
+    mBlendMode = SDL_BLENDMODE_INVALID;
+
+    mSizeTexture = NULL;
+    mSizeWidth = 0;
+    mSizeHeight = 0;
+
+    mDrawCalls = 0;
+}
+
+void SpriteBatch::setColor(Uint8 red, Uint8 green, Uint8 blue)
+{
+    mColor.r = red;
+    mColor.g = green;
+    mColor.b = blue;
+}
+
+void SpriteBatch::setAlpha(Uint8 alpha)
+{
+    mColor.a = alpha;
+}
+
+void SpriteBatch::setBlendMode(SDL_BlendMode blend_mode)
+{
+    mBlendMode = blend_mode;
+}
+
+void SpriteBatch::draw(SDL_Texture *texture, int x, int y, SDL_Rect *clip, double angle, SDL_Point *center, SDL_RendererFlip flip)
+{
+    if (texture == NULL)
+    {
+        return;
+    }
+
+    if (texture != mSizeTexture)
+    {
+        SDL_QueryTexture(texture, NULL, NULL, &mSizeWidth, &mSizeHeight);
+        mSizeTexture = texture;
+    }
+
+    Quad quad;
+    quad.texture = texture;
+    quad.blendMode = mBlendMode;
+    if (quad.blendMode == SDL_BLENDMODE_INVALID)
+    {
+        SDL_GetTextureBlendMode(texture, &quad.blendMode);
+    }
+    quad.order = mQuads.size();
+
+    if (clip != NULL)
+    {
+        quad.source = *clip;
+    }
+    else
+    {
+        quad.source.x = 0;
+        quad.source.y = 0;
+        quad.source.w = mSizeWidth;
+        quad.source.h = mSizeHeight;
+    }
+
+    quad.dest.x = x;
+    quad.dest.y = y;
+    quad.dest.w = quad.source.w;
+    quad.dest.h = quad.source.h;
+
+    quad.textureWidth = mSizeWidth;
+    quad.textureHeight = mSizeHeight;
+    quad.color = mColor;
+    quad.angle = angle;
+    quad.flip = flip;
+
+    if (center != NULL)
+    {
+        quad.center.x = center->x;
+        quad.center.y = center->y;
+    }
+    else
+    {
+        quad.center.x = quad.dest.w / 2.0f;
+        quad.center.y = quad.dest.h / 2.0f;
+    }
+
+    mQuads.push_back(quad);
+}
+
+void SpriteBatch::draw(const AtlasSprite *sprite, int x, int y, SDL_Rect *subClip, double angle, SDL_Point *center, SDL_RendererFlip flip)
+{
+    SDL_Rect source = sprite->clip;
+
+    if (subClip != NULL)
+    {
+        source.x += subClip->x;
+        source.y += subClip->y;
+        source.w = subClip->w;
+        source.h = subClip->h;
+    }
+
+    draw(sprite->texture, x, y, &source, angle, center, flip);
+}
+
+bool SpriteBatch::groupOrder(const Quad &a, const Quad &b)
+{
+    if (a.texture != b.texture)
+    {
+        return a.texture < b.texture;
+    }
+    if (a.blendMode != b.blendMode)
+    {
+        return a.blendMode < b.blendMode;
+    }
+    return a.order < b.order;
+}
+
+void SpriteBatch::appendVertices(const Quad &quad)
+{
+    float u0 = quad.source.x / quad.textureWidth;
+    float v0 = quad.source.y / quad.textureHeight;
+    float u1 = (quad.source.x + quad.source.w) / quad.textureWidth;
+    float v1 = (quad.source.y + quad.source.h) / quad.textureHeight;
+
+    if (quad.flip & SDL_FLIP_HORIZONTAL)
+    {
+        std::swap(u0, u1);
+    }
+    if (quad.flip & SDL_FLIP_VERTICAL)
+    {
+        std::swap(v0, v1);
+    }
+
+    float cornersX[4] = {0.0f, quad.dest.w, quad.dest.w, 0.0f};
+    float cornersY[4] = {0.0f, 0.0f, quad.dest.h, quad.dest.h};
+    float texU[4] = {u0, u1, u1, u0};
+    float texV[4] = {v0, v0, v1, v1};
+
+    float cosA = 1.0f;
+    float sinA = 0.0f;
+    if (quad.angle != 0.0f)
+    {
+        float radians = quad.angle * (float)M_PI / 180.0f;
+        cosA = std::cos(radians);
+        sinA = std::sin(radians);
+    }
+
+    int base = mVertices.size();
+    for (int i = 0; i < 4; ++i)
+    {
+        float localX = cornersX[i] - quad.center.x;
+        float localY = cornersY[i] - quad.center.y;
+
+        SDL_Vertex vertex;
+        vertex.position.x = quad.dest.x + quad.center.x + localX * cosA - localY * sinA;
+        vertex.position.y = quad.dest.y + quad.center.y + localX * sinA + localY * cosA;
+        vertex.color = quad.color;
+        vertex.tex_coord.x = texU[i];
+        vertex.tex_coord.y = texV[i];
+        mVertices.push_back(vertex);
+    }
+
+    mIndices.push_back(base);
+    mIndices.push_back(base + 1);
+    mIndices.push_back(base + 2);
+    mIndices.push_back(base);
+    mIndices.push_back(base + 2);
+    mIndices.push_back(base + 3);
+}
+
+int SpriteBatch::flush(SDL_Renderer *renderer)
+{
+    PROFILE_SCOPE("SpriteBatch::flush");
+
+    mDrawCalls = 0;
+
+    if (mQuads.empty())
+    {
+        return 0;
+    }
+
+    std::sort(mQuads.begin(), mQuads.end(), groupOrder);
+
+    size_t start = 0;
+    while (start < mQuads.size())
+    {
+        size_t end = start;
+        mVertices.clear();
+        mIndices.clear();
+
+        while (end < mQuads.size() && mQuads[end].texture == mQuads[start].texture && mQuads[end].blendMode == mQuads[start].blendMode)
+        {
+            appendVertices(mQuads[end]);
+            ++end;
+        }
+
+        // The texture keeps its own mode, e.g. a premultiplied one, for
+        // whoever draws it next
+        SDL_Texture *texture = mQuads[start].texture;
+        SDL_BlendMode textureMode = SDL_BLENDMODE_INVALID;
+        SDL_GetTextureBlendMode(texture, &textureMode);
+
+        if (textureMode != mQuads[start].blendMode)
+        {
+            SDL_SetTextureBlendMode(texture, mQuads[start].blendMode);
+        }
+        SDL_RenderGeometry(renderer, texture, &mVertices[0], mVertices.size(), &mIndices[0], mIndices.size());
+        if (textureMode != mQuads[start].blendMode && textureMode != SDL_BLENDMODE_INVALID)
+        {
+            SDL_SetTextureBlendMode(texture, textureMode);
+        }
+        ++mDrawCalls;
+
+        start = end;
+    }
+
+    clear();
+    return mDrawCalls;
+}
+
+void SpriteBatch::clear()
+{
+    mQuads.clear();
+
+    // A texture freed after this may hand its address to one of another size.
+    mSizeTexture = NULL;
+}
+
+int SpriteBatch::getSpriteCount()
+{
+    return mQuads.size();
+}
+
+int SpriteBatch::getDrawCalls()
+{
+    return mDrawCalls;
+}
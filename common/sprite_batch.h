@@ -0,0 +1,67 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "texture_atlas.h"
+
+// Collects textured quads and submits them with one SDL_RenderGeometry call
+// per texture/blend mode group. Flushing sorts by texture, so sprites from
+// different textures only keep their relative order across separate flushes.
+class SpriteBatch
+{
+public:
+    SpriteBatch();
+
+    void setColor(Uint8 red, Uint8 green, Uint8 blue);
+    void setAlpha(Uint8 alpha);
+    // Blend mode for the following draws, only for the duration of the
+    // flush. SDL_BLENDMODE_INVALID, the default, uses each texture's own.
+    void setBlendMode(SDL_BlendMode blend_mode);
+
+    void draw(SDL_Texture *texture, int x, int y, SDL_Rect *clip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
+    void draw(const AtlasSprite *sprite, int x, int y, SDL_Rect *subClip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
+
+    int flush(SDL_Renderer *renderer);
+
+    void clear();
+
+    int getSpriteCount();
+    int getDrawCalls();
+
+private:
+    struct Quad
+    {
+        SDL_Texture *texture;
+        SDL_BlendMode blendMode;
+        int order;
+        SDL_FRect dest;
+        SDL_Rect source;
+        float textureWidth;
+        float textureHeight;
+        SDL_Color color;
+        float angle;
+        SDL_FPoint center;
+        SDL_RendererFlip flip;
+    };
+
+    static bool groupOrder(const Quad &a, const Quad &b);
+
+    void appendVertices(const Quad &quad);
+
+    std::vector<Quad> mQuads;
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+
+    SDL_Color mColor;
+    SDL_BlendMode mBlendMode;
+
+    // Size of the last texture drawn, only trusted until the next flush
+    SDL_Texture *mSizeTexture;
+    int mSizeWidth;
+    int mSizeHeight;
+
+    int mDrawCalls;
+};
+
+#endif
@@ -0,0 +1,275 @@
+#include "texture_atlas.h"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <iostream>
+#include "profiler.h"
+
+void AtlasSprite::render(SDL_Renderer *renderer, int x, int y, SDL_Rect *subClip, double angle, SDL_Point *center, SDL_RendererFlip flip) const
+{
+    SDL_Rect source = clip;
+
+    if (subClip != NULL)
+    {
+        source.x += subClip->x;
+        source.y += subClip->y;
+        source.w = subClip->w;
+        source.h = subClip->h;
+    }
+
+    SDL_Rect renderQuad = {x, y, source.w, source.h};
+
+    if (angle == 0.0 && flip == SDL_FLIP_NONE)
+    {
+        SDL_RenderCopy(renderer, texture, &source, &renderQuad);
+    }
+    else
+    {
+        SDL_RenderCopyEx(renderer, texture, &source, &renderQuad, angle, center, flip);
+    }
+}
+
+void AtlasSprite::render(SDL_Renderer *renderer, const SDL_Rect &dest, const SDL_Rect *subClip) const
+{
+    SDL_Rect source = clip;
+
+    if (subClip != NULL)
+    {
+        source.x += subClip->x;
+        source.y += subClip->y;
+        source.w = subClip->w;
+        source.h = subClip->h;
+    }
+
+    SDL_RenderCopy(renderer, texture, &source, &dest);
+}
+
+int AtlasSprite::getWidth() const
+{
+    return clip.w;
+}
+
+int AtlasSprite::getHeight() const
+{
+    return clip.h;
+}
+
+static bool tallerFirst(const SDL_Surface *a, const SDL_Surface *b)
+{
+    if (a->h != b->h)
+    {
+        return a->h > b->h;
+    }
+    return a->w > b->w;
+}
+
+TextureAtlas::TextureAtlas()
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    free();
+}
+
+bool TextureAtlas::addImage(std::string name, std::string path, bool colorKey)
+{
+    PROFILE_SCOPE("TextureAtlas::addImage");
+
+    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
+    if (loadedSurface == NULL)
+    {
+        std::cout << "Unable to load atlas image " << path << "! SDL_image error: " << IMG_GetError() << std::endl;
+        return false;
+    }
+
+    bool success = addSurface(name, loadedSurface, colorKey);
+    SDL_FreeSurface(loadedSurface);
+
+    return success;
+}
+
+bool TextureAtlas::addSurface(std::string name, SDL_Surface *surface, bool colorKey)
+{
+    if (colorKey)
+    {
+        SDL_SetColorKey(surface, SDL_TRUE, SDL_MapRGB(surface->format, 0, 0xFF, 0xFF));
+    }
+
+    // Converting a keyed surface to a format with alpha turns the key into
+    // real transparency, so the page can be blitted without keying later.
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (converted == NULL)
+    {
+        std::cout << "Unable to convert atlas image " << name << "! SDL error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    SDL_SetColorKey(converted, SDL_FALSE, 0);
+    SDL_SetSurfaceBlendMode(converted, SDL_BLENDMODE_NONE);
+
+    PendingImage image = {name, converted};
+    mPending.push_back(image);
+
+    return true;
+}
+
+bool TextureAtlas::build(SDL_Renderer *renderer, int pageSize)
+{
+    PROFILE_SCOPE("TextureAtlas::build");
+
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) == 0)
+    {
+        if (info.max_texture_width > 0 && pageSize > info.max_texture_width)
+        {
+            pageSize = info.max_texture_width;
+        }
+        if (info.max_texture_height > 0 && pageSize > info.max_texture_height)
+        {
+            pageSize = info.max_texture_height;
+        }
+    }
+
+    std::vector<SDL_Surface *> order;
+    std::map<SDL_Surface *, std::string> names;
+    for (size_t i = 0; i < mPending.size(); ++i)
+    {
+        order.push_back(mPending[i].surface);
+        names[mPending[i].surface] = mPending[i].name;
+    }
+    std::sort(order.begin(), order.end(), tallerFirst);
+
+    std::vector<RectPacker> packers;
+    std::vector<SDL_Surface *> pageSurfaces;
+    bool success = true;
+
+    for (size_t i = 0; i < order.size() && success; ++i)
+    {
+        SDL_Surface *image = order[i];
+        int paddedW = image->w + PADDING * 2;
+        int paddedH = image->h + PADDING * 2;
+
+        if (paddedW > pageSize || paddedH > pageSize)
+        {
+            std::cout << "Atlas image " << names[image] << " does not fit in a " << pageSize << "x" << pageSize << " page" << std::endl;
+            success = false;
+            break;
+        }
+
+        SDL_Rect slot;
+        int page = -1;
+        for (size_t p = 0; p < packers.size(); ++p)
+        {
+            if (packers[p].insert(paddedW, paddedH, &slot))
+            {
+                page = p;
+                break;
+            }
+        }
+
+        if (page < 0)
+        {
+            SDL_Surface *pageSurface = SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_ARGB8888);
+            if (pageSurface == NULL)
+            {
+                std::cout << "Unable to create atlas page! SDL error: " << SDL_GetError() << std::endl;
+                success = false;
+                break;
+            }
+
+            SDL_FillRect(pageSurface, NULL, 0);
+            pageSurfaces.push_back(pageSurface);
+            packers.push_back(RectPacker(pageSize, pageSize));
+
+            page = packers.size() - 1;
+            packers[page].insert(paddedW, paddedH, &slot);
+        }
+
+        SDL_Rect target = {slot.x + PADDING, slot.y + PADDING, image->w, image->h};
+        SDL_BlitSurface(image, NULL, pageSurfaces[page], &target);
+
+        AtlasSprite sprite;
+        sprite.texture = NULL;
+        sprite.clip = target;
+        sprite.page = mPages.size() + page;
+        mSprites[names[image]] = sprite;
+    }
+
+    int firstPage = mPages.size();
+    for (size_t p = 0; p < pageSurfaces.size(); ++p)
+    {
+        SDL_Texture *pageTexture = NULL;
+        if (success)
+        {
+            pageTexture = SDL_CreateTextureFromSurface(renderer, pageSurfaces[p]);
+            if (pageTexture == NULL)
+            {
+                std::cout << "Unable to create atlas page texture! SDL error: " << SDL_GetError() << std::endl;
+                success = false;
+            }
+            else
+            {
+                SDL_SetTextureBlendMode(pageTexture, SDL_BLENDMODE_BLEND);
+            }
+        }
+
+        mPages.push_back(pageTexture);
+        SDL_FreeSurface(pageSurfaces[p]);
+    }
+
+    for (std::map<std::string, AtlasSprite>::iterator it = mSprites.begin(); it != mSprites.end(); ++it)
+    {
+        if (it->second.page >= firstPage && it->second.texture == NULL)
+        {
+            it->second.texture = mPages[it->second.page];
+        }
+    }
+
+    freePending();
+    return success;
+}
+
+void TextureAtlas::freePending()
+{
+    for (size_t i = 0; i < mPending.size(); ++i)
+    {
+        SDL_FreeSurface(mPending[i].surface);
+    }
+    mPending.clear();
+}
+
+void TextureAtlas::free()
+{
+    freePending();
+
+    for (size_t i = 0; i < mPages.size(); ++i)
+    {
+        if (mPages[i] != NULL)
+        {
+            SDL_DestroyTexture(mPages[i]);
+        }
+    }
+
+    mPages.clear();
+    mSprites.clear();
+}
+
+AtlasSprite *TextureAtlas::getSprite(std::string name)
+{
+    std::map<std::string, AtlasSprite>::iterator it = mSprites.find(name);
+    if (it == mSprites.end())
+    {
+        return NULL;
+    }
+    return &it->second;
+}
+
+int TextureAtlas::getPageCount()
+{
+    return mPages.size();
+}
+
+SDL_Texture *TextureAtlas::getPage(int index)
+{
+    return mPages[index];
+}
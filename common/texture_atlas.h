@@ -0,0 +1,65 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "rect_packer.h"
+
+// Sub-texture handle into an atlas page. Sprites sharing a page share one
+// SDL_Texture, so drawing them back to back never switches textures.
+struct AtlasSprite
+{
+    SDL_Texture *texture;
+    SDL_Rect clip;
+    int page;
+
+    void render(SDL_Renderer *renderer, int x, int y, SDL_Rect *subClip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE) const;
+
+    // Stretched to dest, e.g. for a zoomed camera
+    void render(SDL_Renderer *renderer, const SDL_Rect &dest, const SDL_Rect *subClip = NULL) const;
+
+    int getWidth() const;
+    int getHeight() const;
+};
+
+class TextureAtlas
+{
+public:
+    static const int DEFAULT_PAGE_SIZE = 2048;
+    static const int PADDING = 1;
+
+    TextureAtlas();
+    ~TextureAtlas();
+
+    bool addImage(std::string name, std::string path, bool colorKey = true);
+    bool addSurface(std::string name, SDL_Surface *surface, bool colorKey = true);
+
+    bool build(SDL_Renderer *renderer, int pageSize = DEFAULT_PAGE_SIZE);
+
+    void free();
+
+    AtlasSprite *getSprite(std::string name);
+
+    int getPageCount();
+    SDL_Texture *getPage(int index);
+
+private:
+    TextureAtlas(const TextureAtlas &);
+    TextureAtlas &operator=(const TextureAtlas &);
+
+    struct PendingImage
+    {
+        std::string name;
+        SDL_Surface *surface;
+    };
+
+    void freePending();
+
+    std::vector<PendingImage> mPending;
+    std::vector<SDL_Texture *> mPages;
+    std::map<std::string, AtlasSprite> mSprites;
+};
+
+#endif
@@ -0,0 +1,219 @@
+#include "texture_cache.h"
+#include <SDL2/SDL_image.h>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include "key_alpha.h"
+#include "profiler.h"
+
+TextureLoadOptions::TextureLoadOptions()
+{
+    colorKey = true;
+    keyColor.r = 0;
+    keyColor.g = 0xFF;
+    keyColor.b = 0xFF;
+    keyColor.a = 0xFF;
+    blendMode = SDL_BLENDMODE_BLEND;
+    premultiply = false;
+}
+
+CachedTexture::CachedTexture()
+{
+    texture = NULL;
+    width = 0;
+    height = 0;
+    bytes = 0;
+    premultiplied = false;
+}
+
+CachedTexture::~CachedTexture()
+{
+    if (texture != NULL)
+    {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+TextureCache::TextureCache(size_t budgetBytes)
+{
+    mBudget = budgetBytes;
+    mResidentBytes = 0;
+    mHits = 0;
+    mMisses = 0;
+    mEvictions = 0;
+}
+
+TextureCache::~TextureCache()
+{
+    clear();
+}
+
+std::string TextureCache::makeKey(std::string path, const TextureLoadOptions &options)
+{
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(std::filesystem::absolute(path, error), error);
+
+    std::ostringstream key;
+    key << (error ? path : canonical.string()) << '|' << options.colorKey;
+    if (options.colorKey)
+    {
+        key << ':' << (int)options.keyColor.r << ',' << (int)options.keyColor.g << ',' << (int)options.keyColor.b;
+    }
+    key << '|' << (options.premultiply ? -1 : (int)options.blendMode);
+
+    return key.str();
+}
+
+SDL_Surface *TextureCache::loadSurface(std::string path, const TextureLoadOptions &options, bool premultiply)
+{
+    if (premultiply)
+    {
+        KeyAlphaOptions keyAlpha;
+        keyAlpha.keyColor = options.keyColor;
+        keyAlpha.premultiply = true;
+        return loadKeyedImage(path, keyAlpha);
+    }
+
+    SDL_Surface *loadedSurface = IMG_Load(path.c_str());
+    if (loadedSurface == NULL)
+    {
+        std::cout << "Unable to load image " << path << "! SDL_image error: " << IMG_GetError() << std::endl;
+        return NULL;
+    }
+
+    if (options.colorKey)
+    {
+        SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, options.keyColor.r, options.keyColor.g, options.keyColor.b));
+    }
+
+    return loadedSurface;
+}
+
+TextureHandle TextureCache::load(SDL_Renderer *renderer, std::string path, const TextureLoadOptions &options)
+{
+    PROFILE_SCOPE("TextureCache::load");
+
+    std::string key = makeKey(path, options);
+
+    std::unordered_map<std::string, Entry>::iterator it = mEntries.find(key);
+    if (it != mEntries.end())
+    {
+        ++mHits;
+        mLru.splice(mLru.begin(), mLru, it->second.lruPosition);
+        return it->second.texture;
+    }
+
+    ++mMisses;
+
+    TextureHandle handle = std::make_shared<CachedTexture>();
+    bool premultiply = options.premultiply;
+    while (handle->texture == NULL)
+    {
+        SDL_Surface *loadedSurface = loadSurface(path, options, premultiply);
+        if (loadedSurface == NULL)
+        {
+            return TextureHandle();
+        }
+
+        handle->texture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
+        handle->width = loadedSurface->w;
+        handle->height = loadedSurface->h;
+        SDL_FreeSurface(loadedSurface);
+
+        if (handle->texture == NULL)
+        {
+            std::cout << "Unable to create texture from " << path << "! SDL error: " << SDL_GetError() << std::endl;
+            return TextureHandle();
+        }
+
+        if (premultiply && SDL_SetTextureBlendMode(handle->texture, getPremultipliedBlendMode()) < 0)
+        {
+            // Renderers without custom blend modes get straight alpha instead,
+            // still cached under the premultiplied key so this happens once.
+            SDL_DestroyTexture(handle->texture);
+            handle->texture = NULL;
+            premultiply = false;
+        }
+        else if (!premultiply)
+        {
+            SDL_SetTextureBlendMode(handle->texture, options.blendMode);
+        }
+    }
+
+    handle->premultiplied = premultiply;
+
+    Uint32 format;
+    SDL_QueryTexture(handle->texture, &format, NULL, NULL, NULL);
+    int bytesPerPixel = SDL_BYTESPERPIXEL(format);
+    if (bytesPerPixel == 0)
+    {
+        bytesPerPixel = 4;
+    }
+    handle->bytes = (size_t)handle->width * handle->height * bytesPerPixel;
+
+    mLru.push_front(key);
+
+    Entry entry;
+    entry.texture = handle;
+    entry.lruPosition = mLru.begin();
+    mEntries[key] = entry;
+
+    mResidentBytes += handle->bytes;
+    trim();
+
+    return handle;
+}
+
+void TextureCache::setBudget(size_t budgetBytes)
+{
+    mBudget = budgetBytes;
+    trim();
+}
+
+void TextureCache::trim()
+{
+    std::list<std::string>::iterator it = mLru.end();
+    while (mResidentBytes > mBudget && it != mLru.begin())
+    {
+        --it;
+
+        Entry &entry = mEntries[*it];
+        if (entry.texture.use_count() > 1)
+        {
+            continue;
+        }
+
+        mResidentBytes -= entry.texture->bytes;
+        ++mEvictions;
+
+        mEntries.erase(*it);
+        it = mLru.erase(it);
+    }
+}
+
+void TextureCache::clear()
+{
+    mEntries.clear();
+    mLru.clear();
+    mResidentBytes = 0;
+}
+
+int TextureCache::getHits()
+{
+    return mHits;
+}
+
+int TextureCache::getMisses()
+{
+    return mMisses;
+}
+
+int TextureCache::getEvictions()
+{
+    return mEvictions;
+}
+
+size_t TextureCache::getResidentBytes()
+{
+    return mResidentBytes;
+}
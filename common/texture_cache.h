@@ -0,0 +1,86 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+struct TextureLoadOptions
+{
+    TextureLoadOptions();
+
+    bool colorKey;
+    SDL_Color keyColor;
+    SDL_BlendMode blendMode;
+
+    // Bake the key into premultiplied alpha instead of keying at draw time;
+    // blendMode is then ignored.
+    bool premultiply;
+};
+
+struct CachedTexture
+{
+    CachedTexture();
+    ~CachedTexture();
+
+    SDL_Texture *texture;
+    int width;
+    int height;
+    size_t bytes;
+
+    // False when premultiply was asked for but the renderer has no custom
+    // blend modes, so the texture fell back to straight alpha.
+    bool premultiplied;
+};
+
+typedef std::shared_ptr<CachedTexture> TextureHandle;
+
+// Deduplicates texture loads by canonical path and load options. Entries
+// still referenced outside the cache are never evicted; the rest are dropped
+// least recently used first once resident bytes exceed the budget.
+class TextureCache
+{
+public:
+    static const size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+    TextureCache(size_t budgetBytes = DEFAULT_BUDGET);
+    ~TextureCache();
+
+    TextureHandle load(SDL_Renderer *renderer, std::string path, const TextureLoadOptions &options = TextureLoadOptions());
+
+    void setBudget(size_t budgetBytes);
+    void trim();
+    void clear();
+
+    int getHits();
+    int getMisses();
+    int getEvictions();
+    size_t getResidentBytes();
+
+private:
+    TextureCache(const TextureCache &);
+    TextureCache &operator=(const TextureCache &);
+
+    struct Entry
+    {
+        TextureHandle texture;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    std::string makeKey(std::string path, const TextureLoadOptions &options);
+    SDL_Surface *loadSurface(std::string path, const TextureLoadOptions &options, bool premultiply);
+
+    std::unordered_map<std::string, Entry> mEntries;
+    std::list<std::string> mLru;
+
+    size_t mBudget;
+    size_t mResidentBytes;
+
+    int mHits;
+    int mMisses;
+    int mEvictions;
+};
+
+#endif
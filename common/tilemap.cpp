@@ -0,0 +1,612 @@
+#include "tilemap.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "profiler.h"
+
+Tilemap::Tilemap()
+{
+    mWidth = 0;
+    mHeight = 0;
+
+    mTileset = NULL;
+    mClipWidth = 0;
+    mClipHeight = 0;
+    mColumns = 0;
+    mTileSize = 32;
+
+    mCacheSize = 256;
+    mFrame = 0;
+
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+Tilemap::~Tilemap()
+{
+    free();
+}
+
+void Tilemap::create(int width, int height, int layerCount)
+{
+    free();
+
+    mWidth = SDL_max(width, 0);
+    mHeight = SDL_max(height, 0);
+    mLayers.assign(SDL_max(layerCount, 0), std::vector<Uint16>((size_t)mWidth * mHeight, 0));
+    mAnimations.clear();
+}
+
+bool Tilemap::loadFromFile(std::string path)
+{
+    PROFILE_SCOPE("Tilemap::loadFromFile");
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+    {
+        std::cout << "Unable to open tilemap " << path << std::endl;
+        return false;
+    }
+
+    std::vector<Uint8> data((size_t)in.tellg());
+    in.seekg(0);
+    in.read((char *)data.data(), data.size());
+
+    TilemapHeader header;
+    if (!in || data.size() < sizeof(header))
+    {
+        std::cout << "Unable to read tilemap " << path << std::endl;
+        return false;
+    }
+
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != TILEMAP_MAGIC || header.version != TILEMAP_VERSION)
+    {
+        std::cout << "Tilemap " << path << " is corrupt or from another version" << std::endl;
+        return false;
+    }
+
+    Uint64 layerTiles = (Uint64)header.width * header.height;
+    if (header.width > TILEMAP_MAX_TILES || header.height > TILEMAP_MAX_TILES || header.layerCount > TILEMAP_MAX_LAYERS ||
+        layerTiles * header.layerCount > TILEMAP_MAX_TILES)
+    {
+        std::cout << "Tilemap " << path << " is " << header.width << "x" << header.height << " with " << header.layerCount
+                  << " layers, more than supported" << std::endl;
+        return false;
+    }
+
+    // Every layer needs its run count and one run per 65535 tiles, so a
+    // short file cannot ask for a big map.
+    Uint64 runsPerLayer = (layerTiles + 0xFFFF - 1) / 0xFFFF;
+    if ((Uint64)(data.size() - sizeof(header)) < header.layerCount * (sizeof(Uint32) + runsPerLayer * sizeof(TilemapRun)))
+    {
+        std::cout << "Tilemap " << path << " is truncated" << std::endl;
+        return false;
+    }
+
+    create(header.width, header.height, header.layerCount);
+
+    size_t offset = sizeof(header);
+    bool valid = true;
+
+    for (Uint32 i = 0; i < header.animationCount && valid; ++i)
+    {
+        TilemapAnimation animation;
+        valid = data.size() - offset >= sizeof(animation);
+        if (valid)
+        {
+            memcpy(&animation, &data[offset], sizeof(animation));
+            offset += sizeof(animation);
+            valid = (data.size() - offset) / sizeof(Uint16) >= animation.frameCount;
+        }
+        if (valid)
+        {
+            std::vector<Uint16> frames(animation.frameCount);
+            memcpy(frames.data(), &data[offset], frames.size() * sizeof(Uint16));
+            offset += frames.size() * sizeof(Uint16);
+            setAnimation(animation.tile, frames, animation.frameMs);
+        }
+    }
+
+    for (size_t layer = 0; layer < mLayers.size() && valid; ++layer)
+    {
+        Uint32 runCount = 0;
+        valid = data.size() - offset >= sizeof(runCount);
+        if (valid)
+        {
+            memcpy(&runCount, &data[offset], sizeof(runCount));
+            offset += sizeof(runCount);
+            valid = (data.size() - offset) / sizeof(TilemapRun) >= runCount;
+        }
+
+        std::vector<Uint16> &tiles = mLayers[layer];
+        size_t filled = 0;
+        for (Uint32 i = 0; i < runCount && valid; ++i)
+        {
+            TilemapRun run;
+            memcpy(&run, &data[offset], sizeof(run));
+            offset += sizeof(run);
+
+            valid = tiles.size() - filled >= run.count;
+            if (valid)
+            {
+                std::fill(tiles.begin() + filled, tiles.begin() + filled + run.count, run.tile);
+                filled += run.count;
+            }
+        }
+        valid = valid && filled == tiles.size();
+    }
+
+    if (!valid)
+    {
+        std::cout << "Tilemap " << path << " is truncated" << std::endl;
+        create(0, 0, 0);
+        return false;
+    }
+
+    return true;
+}
+
+bool Tilemap::saveToFile(std::string path) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cout << "Unable to create tilemap " << path << std::endl;
+        return false;
+    }
+
+    TilemapHeader header = {TILEMAP_MAGIC, TILEMAP_VERSION, (Uint32)mWidth, (Uint32)mHeight, (Uint32)mLayers.size(), (Uint32)mAnimations.size()};
+    out.write((const char *)&header, sizeof(header));
+
+    for (std::unordered_map<Uint16, Animation>::const_iterator it = mAnimations.begin(); it != mAnimations.end(); ++it)
+    {
+        TilemapAnimation animation = {it->first, (Uint16)it->second.frames.size(), it->second.frameMs};
+        out.write((const char *)&animation, sizeof(animation));
+        out.write((const char *)it->second.frames.data(), it->second.frames.size() * sizeof(Uint16));
+    }
+
+    std::vector<TilemapRun> runs;
+    for (size_t layer = 0; layer < mLayers.size(); ++layer)
+    {
+        const std::vector<Uint16> &tiles = mLayers[layer];
+
+        runs.clear();
+        for (size_t i = 0; i < tiles.size(); ++i)
+        {
+            if (!runs.empty() && runs.back().tile == tiles[i] && runs.back().count < 0xFFFF)
+            {
+                ++runs.back().count;
+            }
+            else
+            {
+                TilemapRun run = {1, tiles[i]};
+                runs.push_back(run);
+            }
+        }
+
+        Uint32 runCount = (Uint32)runs.size();
+        out.write((const char *)&runCount, sizeof(runCount));
+        out.write((const char *)runs.data(), runs.size() * sizeof(TilemapRun));
+    }
+
+    out.close();
+    if (!out)
+    {
+        std::cout << "Unable to write tilemap " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void Tilemap::setTileset(SDL_Texture *tileset, int clipWidth, int clipHeight, int tileSize)
+{
+    mTileset = tileset;
+    mClipWidth = clipWidth;
+    mClipHeight = clipHeight;
+    mTileSize = SDL_max(tileSize, 1);
+    mColumns = 0;
+
+    int width = 0;
+    if (tileset != NULL && clipWidth > 0 && SDL_QueryTexture(tileset, NULL, NULL, &width, NULL) == 0)
+    {
+        mColumns = width / clipWidth;
+    }
+
+    invalidate();
+}
+
+void Tilemap::setAnimation(Uint16 tile, const std::vector<Uint16> &frames, Uint32 frameMs)
+{
+    Animation &animation = mAnimations[tile];
+    animation.frames = frames;
+    animation.frameMs = frameMs;
+
+    // Tiles moving in or out of the bakes
+    invalidate();
+}
+
+void Tilemap::setTile(int layer, int x, int y, Uint16 tile)
+{
+    if (layer < 0 || layer >= (int)mLayers.size() || x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+    {
+        return;
+    }
+
+    mLayers[layer][(size_t)y * mWidth + x] = tile;
+
+    std::unordered_map<Uint64, Chunk>::iterator it = mChunks.find(chunkKey(layer, x / CHUNK_TILES, y / CHUNK_TILES));
+    if (it != mChunks.end())
+    {
+        it->second.baked = false;
+    }
+}
+
+Uint16 Tilemap::getTile(int layer, int x, int y) const
+{
+    if (layer < 0 || layer >= (int)mLayers.size() || x < 0 || y < 0 || x >= mWidth || y >= mHeight)
+    {
+        return 0;
+    }
+
+    return mLayers[layer][(size_t)y * mWidth + x];
+}
+
+void Tilemap::setCacheSize(int chunks)
+{
+    mCacheSize = SDL_max(chunks, 1);
+}
+
+void Tilemap::invalidate()
+{
+    for (std::unordered_map<Uint64, Chunk>::iterator it = mChunks.begin(); it != mChunks.end(); ++it)
+    {
+        it->second.baked = false;
+    }
+}
+
+void Tilemap::handleEvent(const SDL_Event &e)
+{
+    if (e.type == SDL_RENDER_TARGETS_RESET)
+    {
+        invalidate();
+    }
+    else if (e.type == SDL_RENDER_DEVICE_RESET)
+    {
+        free();
+    }
+}
+
+void Tilemap::free()
+{
+    for (std::unordered_map<Uint64, Chunk>::iterator it = mChunks.begin(); it != mChunks.end(); ++it)
+    {
+        if (it->second.texture != NULL)
+        {
+            SDL_DestroyTexture(it->second.texture);
+        }
+    }
+    mChunks.clear();
+}
+
+Uint64 Tilemap::chunkKey(int layer, int cx, int cy)
+{
+    return ((Uint64)(Uint16)layer << 48) | ((Uint64)(cx & 0xFFFFFF) << 24) | (Uint64)(cy & 0xFFFFFF);
+}
+
+bool Tilemap::getClip(Uint16 tile, SDL_Rect *clip) const
+{
+    if (tile == 0 || mColumns == 0)
+    {
+        return false;
+    }
+
+    int index = tile - 1;
+    clip->x = (index % mColumns) * mClipWidth;
+    clip->y = (index / mColumns) * mClipHeight;
+    clip->w = mClipWidth;
+    clip->h = mClipHeight;
+    return true;
+}
+
+Uint16 Tilemap::animationFrame(Uint16 tile, Uint32 timeMs) const
+{
+    std::unordered_map<Uint16, Animation>::const_iterator it = mAnimations.find(tile);
+    if (it == mAnimations.end() || it->second.frames.empty())
+    {
+        return tile;
+    }
+
+    const Animation &animation = it->second;
+    Uint32 step = animation.frameMs > 0 ? timeMs / animation.frameMs : 0;
+    return animation.frames[step % animation.frames.size()];
+}
+
+Tilemap::Chunk &Tilemap::getChunk(SDL_Renderer *renderer, int layer, int cx, int cy)
+{
+    Uint64 key = chunkKey(layer, cx, cy);
+    std::unordered_map<Uint64, Chunk>::iterator it = mChunks.find(key);
+    if (it == mChunks.end())
+    {
+        Chunk chunk;
+        chunk.texture = NULL;
+        chunk.baked = false;
+        chunk.empty = true;
+        chunk.lastUsed = 0;
+        it = mChunks.insert(std::make_pair(key, chunk)).first;
+    }
+
+    Chunk &chunk = it->second;
+    if (!chunk.baked)
+    {
+        bake(renderer, chunk, layer, cx, cy);
+    }
+    chunk.lastUsed = mFrame;
+
+    return chunk;
+}
+
+void Tilemap::bake(SDL_Renderer *renderer, Chunk &chunk, int layer, int cx, int cy)
+{
+    PROFILE_SCOPE("Tilemap::bake");
+
+    const std::vector<Uint16> &tiles = mLayers[layer];
+    int x0 = cx * CHUNK_TILES;
+    int y0 = cy * CHUNK_TILES;
+    int x1 = SDL_min(x0 + CHUNK_TILES, mWidth);
+    int y1 = SDL_min(y0 + CHUNK_TILES, mHeight);
+
+    chunk.baked = true;
+    chunk.empty = true;
+    chunk.animated.clear();
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            Uint16 tile = tiles[(size_t)y * mWidth + x];
+            if (tile == 0)
+            {
+                continue;
+            }
+
+            if (mAnimations.count(tile) > 0)
+            {
+                AnimatedTile animated = {x, y, tile};
+                chunk.animated.push_back(animated);
+            }
+            else
+            {
+                chunk.empty = false;
+            }
+        }
+    }
+
+    // Only animated tiles, or nothing at all: no texture needed.
+    if (chunk.empty)
+    {
+        if (chunk.texture != NULL)
+        {
+            SDL_DestroyTexture(chunk.texture);
+            chunk.texture = NULL;
+        }
+        return;
+    }
+
+    int size = CHUNK_TILES * mTileSize;
+    if (chunk.texture == NULL)
+    {
+        chunk.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, size, size);
+        if (chunk.texture == NULL)
+        {
+            std::cout << "Unable to create tilemap chunk, drawing its tiles directly! SDL error: " << SDL_GetError() << std::endl;
+            return;
+        }
+        SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+    }
+
+    // Baking may happen inside someone else's target pass, e.g. a
+    // RetainedCanvas region, so everything it touches is put back.
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_Rect previousViewport;
+    SDL_Rect previousClip;
+    SDL_RenderGetViewport(renderer, &previousViewport);
+    SDL_RenderGetClipRect(renderer, &previousClip);
+    bool clipEnabled = SDL_RenderIsClipEnabled(renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_BlendMode tilesetBlend = SDL_BLENDMODE_BLEND;
+    SDL_GetTextureBlendMode(mTileset, &tilesetBlend);
+
+    SDL_SetRenderTarget(renderer, chunk.texture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    // Tiles never overlap, so copying keeps their alpha exact instead of
+    // blending it into the clear color.
+    SDL_SetTextureBlendMode(mTileset, SDL_BLENDMODE_NONE);
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            Uint16 tile = tiles[(size_t)y * mWidth + x];
+            SDL_Rect clip;
+            if (mAnimations.count(tile) == 0 && getClip(tile, &clip))
+            {
+                SDL_Rect dest = {(x - x0) * mTileSize, (y - y0) * mTileSize, mTileSize, mTileSize};
+                SDL_RenderCopy(renderer, mTileset, &clip, &dest);
+            }
+        }
+    }
+    SDL_SetTextureBlendMode(mTileset, tilesetBlend);
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_RenderSetViewport(renderer, &previousViewport);
+    SDL_RenderSetClipRect(renderer, clipEnabled ? &previousClip : NULL);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+    ++mStats.chunksBaked;
+}
+
+void Tilemap::evict()
+{
+    if ((int)mChunks.size() <= mCacheSize)
+    {
+        return;
+    }
+
+    std::vector<std::pair<Uint32, Uint64> > candidates;
+    for (std::unordered_map<Uint64, Chunk>::iterator it = mChunks.begin(); it != mChunks.end(); ++it)
+    {
+        if (it->second.lastUsed != mFrame)
+        {
+            candidates.push_back(std::make_pair(it->second.lastUsed, it->first));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (size_t i = 0; i < candidates.size() && (int)mChunks.size() > mCacheSize; ++i)
+    {
+        std::unordered_map<Uint64, Chunk>::iterator it = mChunks.find(candidates[i].second);
+        if (it->second.texture != NULL)
+        {
+            SDL_DestroyTexture(it->second.texture);
+        }
+        mChunks.erase(it);
+    }
+}
+
+void Tilemap::renderTiles(SDL_Renderer *renderer, const Camera &camera, int layer, const SDL_Rect &tiles, Uint32 timeMs)
+{
+    const std::vector<Uint16> &layerTiles = mLayers[layer];
+    for (int y = tiles.y; y < tiles.y + tiles.h; ++y)
+    {
+        for (int x = tiles.x; x < tiles.x + tiles.w; ++x)
+        {
+            SDL_Rect clip;
+            if (getClip(animationFrame(layerTiles[(size_t)y * mWidth + x], timeMs), &clip))
+            {
+                SDL_Rect world = {x * mTileSize, y * mTileSize, mTileSize, mTileSize};
+                SDL_Rect dest = camera.worldToScreen(world);
+                SDL_RenderCopy(renderer, mTileset, &clip, &dest);
+                ++mStats.tileCopies;
+            }
+        }
+    }
+}
+
+static int floorDiv(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+void Tilemap::render(SDL_Renderer *renderer, const Camera &camera, Uint32 timeMs)
+{
+    PROFILE_SCOPE("Tilemap::render");
+
+    memset(&mStats, 0, sizeof(mStats));
+    ++mFrame;
+
+    if (mTileset == NULL || mColumns == 0 || mWidth == 0 || mHeight == 0)
+    {
+        return;
+    }
+
+    SDL_Rect view = camera.getVisibleBounds();
+    SDL_Rect visible;
+    visible.x = SDL_max(floorDiv(view.x, mTileSize), 0);
+    visible.y = SDL_max(floorDiv(view.y, mTileSize), 0);
+    visible.w = SDL_min(floorDiv(view.x + view.w - 1, mTileSize), mWidth - 1) - visible.x + 1;
+    visible.h = SDL_min(floorDiv(view.y + view.h - 1, mTileSize), mHeight - 1) - visible.y + 1;
+    if (visible.w <= 0 || visible.h <= 0)
+    {
+        return;
+    }
+
+    // Without render targets there is nothing to bake into.
+    if (!SDL_RenderTargetSupported(renderer))
+    {
+        for (size_t layer = 0; layer < mLayers.size(); ++layer)
+        {
+            renderTiles(renderer, camera, (int)layer, visible, timeMs);
+        }
+        return;
+    }
+
+    int cx0 = visible.x / CHUNK_TILES;
+    int cy0 = visible.y / CHUNK_TILES;
+    int cx1 = (visible.x + visible.w - 1) / CHUNK_TILES;
+    int cy1 = (visible.y + visible.h - 1) / CHUNK_TILES;
+    int chunkSize = CHUNK_TILES * mTileSize;
+
+    for (size_t layer = 0; layer < mLayers.size(); ++layer)
+    {
+        for (int cy = cy0; cy <= cy1; ++cy)
+        {
+            for (int cx = cx0; cx <= cx1; ++cx)
+            {
+                Chunk &chunk = getChunk(renderer, (int)layer, cx, cy);
+
+                if (!chunk.empty && chunk.texture == NULL)
+                {
+                    SDL_Rect chunkTiles = {cx * CHUNK_TILES, cy * CHUNK_TILES, CHUNK_TILES, CHUNK_TILES};
+                    SDL_Rect tiles;
+                    if (SDL_IntersectRect(&chunkTiles, &visible, &tiles))
+                    {
+                        renderTiles(renderer, camera, (int)layer, tiles, timeMs);
+                    }
+                    continue;
+                }
+
+                if (!chunk.empty)
+                {
+                    SDL_Rect world = {cx * chunkSize, cy * chunkSize, chunkSize, chunkSize};
+                    SDL_Rect dest = camera.worldToScreen(world);
+                    SDL_RenderCopy(renderer, chunk.texture, NULL, &dest);
+                    ++mStats.chunkCopies;
+                }
+
+                for (size_t i = 0; i < chunk.animated.size(); ++i)
+                {
+                    const AnimatedTile &animated = chunk.animated[i];
+                    SDL_Rect world = {animated.x * mTileSize, animated.y * mTileSize, mTileSize, mTileSize};
+                    SDL_Rect clip;
+                    if (SDL_HasIntersection(&world, &view) && getClip(animationFrame(animated.tile, timeMs), &clip))
+                    {
+                        SDL_Rect dest = camera.worldToScreen(world);
+                        SDL_RenderCopy(renderer, mTileset, &clip, &dest);
+                        ++mStats.tileCopies;
+                    }
+                }
+            }
+        }
+    }
+
+    evict();
+    mStats.chunksCached = (int)mChunks.size();
+}
+
+int Tilemap::getWidth() const
+{
+    return mWidth;
+}
+
+int Tilemap::getHeight() const
+{
+    return mHeight;
+}
+
+int Tilemap::getLayerCount() const
+{
+    return (int)mLayers.size();
+}
+
+int Tilemap::getTileSize() const
+{
+    return mTileSize;
+}
+
+const TilemapStats &Tilemap::getStats() const
+{
+    return mStats;
+}
@@ -0,0 +1,163 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "camera.h"
+
+// Binary map file, native byte order:
+//
+//   TilemapHeader
+//   per animation: TilemapAnimation, then Uint16 frames[frameCount]
+//   per layer: Uint32 runCount, then TilemapRun[runCount]
+//
+// Layers are run-length encoded row by row, so open ground and repeated
+// terrain cost a few bytes per run rather than two per tile.
+const Uint32 TILEMAP_MAGIC = 0x50414D54;
+const Uint32 TILEMAP_VERSION = 1;
+
+// Limits on what a file may ask for, so a bad header is rejected instead of
+// allocating gigabytes. Tiles are counted across every layer.
+const Uint32 TILEMAP_MAX_LAYERS = 16;
+const Uint32 TILEMAP_MAX_TILES = 1 << 24;
+
+struct TilemapHeader
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 width;
+    Uint32 height;
+    Uint32 layerCount;
+    Uint32 animationCount;
+};
+
+struct TilemapAnimation
+{
+    Uint16 tile;
+    Uint16 frameCount;
+    Uint32 frameMs;
+};
+
+struct TilemapRun
+{
+    Uint16 count;
+    Uint16 tile;
+};
+
+struct TilemapStats
+{
+    int chunkCopies;
+    int tileCopies;
+    int chunksBaked;
+    int chunksCached;
+};
+
+// Tile grid drawn through a camera. Tile 0 is empty; tile n uses the n-th
+// clip of the tileset, row by row. Tiles are grouped into square chunks and
+// the static ones of each chunk are baked once into a target texture, so a
+// frame costs one copy per visible chunk. Animated tiles are left out of the
+// bake and drawn on top of their chunk each frame.
+class Tilemap
+{
+public:
+    static const int CHUNK_TILES = 16;
+
+    Tilemap();
+    ~Tilemap();
+
+    // Empty map; drops any cached chunks
+    void create(int width, int height, int layerCount);
+
+    bool loadFromFile(std::string path);
+    bool saveToFile(std::string path) const;
+
+    // Clips of clipWidth x clipHeight drawn into tileSize world pixels
+    void setTileset(SDL_Texture *tileset, int clipWidth, int clipHeight, int tileSize);
+
+    // Any tile listed here is animated wherever it is placed
+    void setAnimation(Uint16 tile, const std::vector<Uint16> &frames, Uint32 frameMs);
+
+    void setTile(int layer, int x, int y, Uint16 tile);
+    Uint16 getTile(int layer, int x, int y) const;
+
+    // Most chunks kept baked; the least recently drawn go first. Chunks in
+    // view are never evicted mid-frame, so this only bounds memory.
+    void setCacheSize(int chunks);
+
+    // Drops every baked chunk; they bake again as they come into view.
+    void invalidate();
+
+    // Rebakes after lost render targets
+    void handleEvent(const SDL_Event &e);
+
+    // Draws the layers in order. timeMs drives the animated tiles.
+    void render(SDL_Renderer *renderer, const Camera &camera, Uint32 timeMs);
+
+    void free();
+
+    int getWidth() const;
+    int getHeight() const;
+    int getLayerCount() const;
+    int getTileSize() const;
+
+    // Stats of the last render
+    const TilemapStats &getStats() const;
+
+private:
+    Tilemap(const Tilemap &);
+    Tilemap &operator=(const Tilemap &);
+
+    struct AnimatedTile
+    {
+        int x;
+        int y;
+        Uint16 tile;
+    };
+
+    struct Chunk
+    {
+        SDL_Texture *texture;
+        bool baked;
+        bool empty;
+        Uint32 lastUsed;
+        std::vector<AnimatedTile> animated;
+    };
+
+    struct Animation
+    {
+        std::vector<Uint16> frames;
+        Uint32 frameMs;
+    };
+
+    static Uint64 chunkKey(int layer, int cx, int cy);
+
+    bool getClip(Uint16 tile, SDL_Rect *clip) const;
+    Uint16 animationFrame(Uint16 tile, Uint32 timeMs) const;
+
+    Chunk &getChunk(SDL_Renderer *renderer, int layer, int cx, int cy);
+    void bake(SDL_Renderer *renderer, Chunk &chunk, int layer, int cx, int cy);
+    void evict();
+
+    void renderTiles(SDL_Renderer *renderer, const Camera &camera, int layer, const SDL_Rect &tiles, Uint32 timeMs);
+
+    int mWidth;
+    int mHeight;
+    std::vector<std::vector<Uint16> > mLayers;
+    std::unordered_map<Uint16, Animation> mAnimations;
+
+    SDL_Texture *mTileset;
+    int mClipWidth;
+    int mClipHeight;
+    int mColumns;
+    int mTileSize;
+
+    std::unordered_map<Uint64, Chunk> mChunks;
+    int mCacheSize;
+    Uint32 mFrame;
+
+    TilemapStats mStats;
+};
+
+#endif
@@ -0,0 +1,702 @@
+#include "vector_shapes.h"
+#include <cmath>
+#include "profiler.h"
+
+// Corners sharper than this are clipped rather than mitered out to a spike
+const float MITER_LIMIT = 4.0f;
+
+static const Uint64 FNV_OFFSET = 14695981039346656037ull;
+static const Uint64 FNV_PRIME = 1099511628211ull;
+
+static Uint64 hashBytes(Uint64 hash, const void *data, size_t size)
+{
+    const Uint8 *bytes = (const Uint8 *)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static bool sameColor(SDL_Color a, SDL_Color b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static SDL_Color withAlpha(SDL_Color color, float scale)
+{
+    color.a = (Uint8)(color.a * scale + 0.5f);
+    return color;
+}
+
+void VectorPath::push(Command command, const float *data, int count)
+{
+    mCommands.push_back((Uint8)command);
+    mData.insert(mData.end(), data, data + count);
+}
+
+void VectorPath::moveTo(float x, float y)
+{
+    float data[] = {x, y};
+    push(PATH_MOVE, data, 2);
+}
+
+void VectorPath::lineTo(float x, float y)
+{
+    float data[] = {x, y};
+    push(PATH_LINE, data, 2);
+}
+
+void VectorPath::quadTo(float cx, float cy, float x, float y)
+{
+    float data[] = {cx, cy, x, y};
+    push(PATH_QUAD, data, 4);
+}
+
+void VectorPath::cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y)
+{
+    float data[] = {c1x, c1y, c2x, c2y, x, y};
+    push(PATH_CUBIC, data, 6);
+}
+
+void VectorPath::arc(float cx, float cy, float radius, float startAngle, float endAngle)
+{
+    float data[] = {cx, cy, radius, startAngle, endAngle};
+    push(PATH_ARC, data, 5);
+}
+
+void VectorPath::close()
+{
+    push(PATH_CLOSE, NULL, 0);
+}
+
+void VectorPath::circle(float cx, float cy, float radius)
+{
+    moveTo(cx + radius, cy);
+    arc(cx, cy, radius, 0.0f, 2.0f * (float)M_PI);
+    close();
+}
+
+void VectorPath::roundedRect(const SDL_FRect &rect, float radius)
+{
+    float r = SDL_min(SDL_max(radius, 0.0f), SDL_min(rect.w, rect.h) / 2.0f);
+    float right = rect.x + rect.w;
+    float bottom = rect.y + rect.h;
+    float half = (float)M_PI / 2.0f;
+
+    moveTo(rect.x + r, rect.y);
+    arc(right - r, rect.y + r, r, -half, 0.0f);
+    arc(right - r, bottom - r, r, 0.0f, half);
+    arc(rect.x + r, bottom - r, r, half, 2.0f * half);
+    arc(rect.x + r, rect.y + r, r, 2.0f * half, 3.0f * half);
+    close();
+}
+
+void VectorPath::clear()
+{
+    mCommands.clear();
+    mData.clear();
+}
+
+bool VectorPath::empty() const
+{
+    return mCommands.empty();
+}
+
+// Adds a point unless it repeats the last one, which would leave a
+// zero-length segment without a direction.
+static void addPoint(std::vector<SDL_FPoint> &contour, float x, float y)
+{
+    if (!contour.empty())
+    {
+        const SDL_FPoint &last = contour.back();
+        if (fabsf(last.x - x) < 0.001f && fabsf(last.y - y) < 0.001f)
+        {
+            return;
+        }
+    }
+
+    SDL_FPoint p = {x, y};
+    contour.push_back(p);
+}
+
+static void endContour(std::vector<SDL_FPoint> &contour, bool isClosed,
+                       std::vector<std::vector<SDL_FPoint>> &contours, std::vector<bool> &closed)
+{
+    if (isClosed && contour.size() > 1)
+    {
+        const SDL_FPoint &first = contour.front();
+        const SDL_FPoint &last = contour.back();
+        if (fabsf(last.x - first.x) < 0.001f && fabsf(last.y - first.y) < 0.001f)
+        {
+            contour.pop_back();
+        }
+    }
+
+    if (contour.size() > 1)
+    {
+        contours.push_back(contour);
+        closed.push_back(isClosed);
+    }
+    contour.clear();
+}
+
+void VectorPath::flatten(float tolerance, std::vector<std::vector<SDL_FPoint>> &contours, std::vector<bool> &closed) const
+{
+    std::vector<SDL_FPoint> contour;
+    SDL_FPoint current = {0.0f, 0.0f};
+    SDL_FPoint start = {0.0f, 0.0f};
+    const float *data = mData.data();
+
+    for (size_t i = 0; i < mCommands.size(); ++i)
+    {
+        switch (mCommands[i])
+        {
+        case PATH_MOVE:
+            endContour(contour, false, contours, closed);
+            current.x = data[0];
+            current.y = data[1];
+            start = current;
+            addPoint(contour, current.x, current.y);
+            data += 2;
+            break;
+
+        case PATH_LINE:
+            if (contour.empty())
+            {
+                addPoint(contour, current.x, current.y);
+            }
+            current.x = data[0];
+            current.y = data[1];
+            addPoint(contour, current.x, current.y);
+            data += 2;
+            break;
+
+        case PATH_QUAD:
+        {
+            if (contour.empty())
+            {
+                addPoint(contour, current.x, current.y);
+            }
+
+            // A quadratic strays from its chords by at most |p0 - 2p1 + p2| / 4n^2
+            float ddx = current.x - 2.0f * data[0] + data[2];
+            float ddy = current.y - 2.0f * data[1] + data[3];
+            float dd = sqrtf(ddx * ddx + ddy * ddy);
+            int segments = SDL_min(SDL_max((int)ceilf(sqrtf(dd / (4.0f * tolerance))), 1), 256);
+
+            for (int s = 1; s <= segments; ++s)
+            {
+                float t = (float)s / segments;
+                float u = 1.0f - t;
+                addPoint(contour,
+                         u * u * current.x + 2.0f * u * t * data[0] + t * t * data[2],
+                         u * u * current.y + 2.0f * u * t * data[1] + t * t * data[3]);
+            }
+            current.x = data[2];
+            current.y = data[3];
+            data += 4;
+            break;
+        }
+
+        case PATH_CUBIC:
+        {
+            if (contour.empty())
+            {
+                addPoint(contour, current.x, current.y);
+            }
+
+            // And a cubic by at most 3/4 of its largest second difference over n^2
+            float d1x = current.x - 2.0f * data[0] + data[2];
+            float d1y = current.y - 2.0f * data[1] + data[3];
+            float d2x = data[0] - 2.0f * data[2] + data[4];
+            float d2y = data[1] - 2.0f * data[3] + data[5];
+            float dd = SDL_max(sqrtf(d1x * d1x + d1y * d1y), sqrtf(d2x * d2x + d2y * d2y));
+            int segments = SDL_min(SDL_max((int)ceilf(sqrtf(3.0f * dd / (4.0f * tolerance))), 1), 256);
+
+            for (int s = 1; s <= segments; ++s)
+            {
+                float t = (float)s / segments;
+                float u = 1.0f - t;
+                float a = u * u * u;
+                float b = 3.0f * u * u * t;
+                float c = 3.0f * u * t * t;
+                float d = t * t * t;
+                addPoint(contour,
+                         a * current.x + b * data[0] + c * data[2] + d * data[4],
+                         a * current.y + b * data[1] + c * data[3] + d * data[5]);
+            }
+            current.x = data[4];
+            current.y = data[5];
+            data += 6;
+            break;
+        }
+
+        case PATH_ARC:
+        {
+            float cx = data[0];
+            float cy = data[1];
+            float radius = fabsf(data[2]);
+            float sweep = data[4] - data[3];
+
+            // Steps short enough that each chord stays within tolerance
+            float step = (float)M_PI / 4.0f;
+            if (radius > tolerance)
+            {
+                step = SDL_min(step, 2.0f * acosf(1.0f - tolerance / radius));
+            }
+            int segments = SDL_min(SDL_max((int)ceilf(fabsf(sweep) / step), 1), 1024);
+
+            if (contour.empty())
+            {
+                start.x = cx + cosf(data[3]) * radius;
+                start.y = cy + sinf(data[3]) * radius;
+            }
+
+            for (int s = 0; s <= segments; ++s)
+            {
+                float angle = data[3] + sweep * s / segments;
+                addPoint(contour, cx + cosf(angle) * radius, cy + sinf(angle) * radius);
+            }
+            current = contour.back();
+            data += 5;
+            break;
+        }
+
+        case PATH_CLOSE:
+            endContour(contour, true, contours, closed);
+            current = start;
+            break;
+        }
+    }
+
+    endContour(contour, false, contours, closed);
+}
+
+Uint64 VectorPath::hash() const
+{
+    Uint64 hash = FNV_OFFSET;
+    hash = hashBytes(hash, mCommands.data(), mCommands.size());
+    hash = hashBytes(hash, mData.data(), mData.size() * sizeof(float));
+    return hash;
+}
+
+bool VectorPath::operator==(const VectorPath &other) const
+{
+    return mCommands == other.mCommands && mData == other.mData;
+}
+
+VectorStyle::VectorStyle()
+{
+    fill.r = 0x00;
+    fill.g = 0x00;
+    fill.b = 0x00;
+    fill.a = 0x00;
+    stroke.r = 0x00;
+    stroke.g = 0x00;
+    stroke.b = 0x00;
+    stroke.a = 0xFF;
+    strokeWidth = 1.0f;
+}
+
+bool VectorStyle::operator==(const VectorStyle &other) const
+{
+    return sameColor(fill, other.fill) && sameColor(stroke, other.stroke) && strokeWidth == other.strokeWidth;
+}
+
+VectorRenderer::VectorRenderer()
+{
+    mRebuilt = false;
+    mBuilt = 0;
+
+    mFeather = 1.0f;
+    mTolerance = 0.25f;
+    mCacheFrames = 60;
+    mFrameNumber = 0;
+
+    mStats.meshesDrawn = 0;
+    mStats.meshesBuilt = 0;
+    mStats.vertices = 0;
+    mStats.geometryReused = false;
+}
+
+void VectorRenderer::setFeather(float pixels)
+{
+    if (pixels != mFeather)
+    {
+        // Every cached mesh was built with the old feather
+        clear();
+        mFeather = SDL_max(pixels, 0.0f);
+    }
+}
+
+void VectorRenderer::setTolerance(float pixels)
+{
+    if (pixels != mTolerance)
+    {
+        clear();
+        mTolerance = SDL_max(pixels, 0.01f);
+    }
+}
+
+void VectorRenderer::setCacheFrames(int frames)
+{
+    mCacheFrames = SDL_max(frames, 1);
+}
+
+void VectorRenderer::draw(const VectorPath &path, const VectorStyle &style)
+{
+    Uint64 key = path.hash();
+    key = hashBytes(key, &style.fill, sizeof(style.fill));
+    key = hashBytes(key, &style.stroke, sizeof(style.stroke));
+    key = hashBytes(key, &style.strokeWidth, sizeof(style.strokeWidth));
+
+    // A colliding shape simply takes the slot over
+    std::unordered_map<Uint64, Mesh>::iterator found = mMeshes.find(key);
+    if (found == mMeshes.end() || !(found->second.path == path && found->second.style == style))
+    {
+        Mesh &mesh = mMeshes[key];
+        mesh.path = path;
+        mesh.style = style;
+        tessellate(mesh);
+
+        ++mBuilt;
+        mRebuilt = true;
+        found = mMeshes.find(key);
+    }
+
+    found->second.lastFrame = mFrameNumber;
+    mFrame.push_back(&found->second);
+}
+
+void VectorRenderer::tessellate(Mesh &mesh)
+{
+    PROFILE_SCOPE("VectorRenderer::tessellate");
+
+    mesh.vertices.clear();
+    mesh.indices.clear();
+
+    std::vector<std::vector<SDL_FPoint>> contours;
+    std::vector<bool> closed;
+    mesh.path.flatten(mTolerance, contours, closed);
+
+    // Fills first so strokes cover their fringe
+    if (mesh.style.fill.a > 0)
+    {
+        for (size_t i = 0; i < contours.size(); ++i)
+        {
+            fillContour(mesh, contours[i]);
+        }
+    }
+
+    if (mesh.style.stroke.a > 0 && mesh.style.strokeWidth > 0.0f)
+    {
+        for (size_t i = 0; i < contours.size(); ++i)
+        {
+            strokeContour(mesh, contours[i], closed[i]);
+        }
+    }
+}
+
+// Offset direction at a corner between two unit normals: along their
+// bisector and long enough that both edges move by one unit.
+static SDL_FPoint miter(float n1x, float n1y, float n2x, float n2y)
+{
+    float mx = n1x + n2x;
+    float my = n1y + n2y;
+    float dot = 1.0f + n1x * n2x + n1y * n2y;
+
+    SDL_FPoint m;
+    if (dot < 2.0f / (MITER_LIMIT * MITER_LIMIT))
+    {
+        // Nearly reversed: fall back to the limit along whatever bisector there is
+        float length = sqrtf(mx * mx + my * my);
+        if (length < 0.0001f)
+        {
+            m.x = n1x;
+            m.y = n1y;
+            return m;
+        }
+        m.x = mx / length * MITER_LIMIT;
+        m.y = my / length * MITER_LIMIT;
+        return m;
+    }
+
+    m.x = mx / dot;
+    m.y = my / dot;
+    return m;
+}
+
+static void addVertex(std::vector<SDL_Vertex> &vertices, float x, float y, SDL_Color color)
+{
+    SDL_Vertex vertex;
+    vertex.position.x = x;
+    vertex.position.y = y;
+    vertex.color = color;
+    vertex.tex_coord.x = 0.0f;
+    vertex.tex_coord.y = 0.0f;
+    vertices.push_back(vertex);
+}
+
+static void addQuad(std::vector<int> &indices, int a, int b, int c, int d)
+{
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+    indices.push_back(a);
+    indices.push_back(c);
+    indices.push_back(d);
+}
+
+void VectorRenderer::fillContour(Mesh &mesh, const std::vector<SDL_FPoint> &contour)
+{
+    int count = (int)contour.size();
+    if (count < 3)
+    {
+        return;
+    }
+
+    // Edge normals point out of the shape whichever way it winds
+    float area = 0.0f;
+    for (int i = 0; i < count; ++i)
+    {
+        const SDL_FPoint &a = contour[i];
+        const SDL_FPoint &b = contour[(i + 1) % count];
+        area += a.x * b.y - b.x * a.y;
+    }
+    float side = area >= 0.0f ? 1.0f : -1.0f;
+
+    std::vector<SDL_FPoint> normals(count);
+    for (int i = 0; i < count; ++i)
+    {
+        const SDL_FPoint &a = contour[i];
+        const SDL_FPoint &b = contour[(i + 1) % count];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float length = sqrtf(dx * dx + dy * dy);
+        normals[i].x = side * dy / length;
+        normals[i].y = -side * dx / length;
+    }
+
+    // Each point becomes an opaque vertex half a feather inside the edge
+    // and a clear one half a feather outside.
+    float half = mFeather / 2.0f;
+    SDL_Color clear = withAlpha(mesh.style.fill, 0.0f);
+    int first = (int)mesh.vertices.size();
+
+    for (int i = 0; i < count; ++i)
+    {
+        const SDL_FPoint &prev = normals[(i + count - 1) % count];
+        SDL_FPoint m = miter(prev.x, prev.y, normals[i].x, normals[i].y);
+        addVertex(mesh.vertices, contour[i].x - m.x * half, contour[i].y - m.y * half, mesh.style.fill);
+        addVertex(mesh.vertices, contour[i].x + m.x * half, contour[i].y + m.y * half, clear);
+    }
+
+    for (int i = 1; i + 1 < count; ++i)
+    {
+        mesh.indices.push_back(first);
+        mesh.indices.push_back(first + i * 2);
+        mesh.indices.push_back(first + (i + 1) * 2);
+    }
+
+    if (mFeather > 0.0f)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            int a = first + i * 2;
+            int b = first + ((i + 1) % count) * 2;
+            addQuad(mesh.indices, a, a + 1, b + 1, b);
+        }
+    }
+}
+
+void VectorRenderer::strokeContour(Mesh &mesh, const std::vector<SDL_FPoint> &contour, bool closed)
+{
+    int count = (int)contour.size();
+    if (closed && count < 3)
+    {
+        closed = false;
+    }
+    if (count < 2)
+    {
+        return;
+    }
+
+    // Strokes thinner than the feather keep the feather's width and fade
+    // instead, so they do not break up into dashes.
+    float width = mesh.style.strokeWidth;
+    SDL_Color color = mesh.style.stroke;
+    if (width < mFeather)
+    {
+        color = withAlpha(color, width / mFeather);
+        width = mFeather;
+    }
+    SDL_Color clear = withAlpha(color, 0.0f);
+
+    float core = (width - mFeather) / 2.0f;
+    float outer = (width + mFeather) / 2.0f;
+
+    int segments = closed ? count : count - 1;
+    std::vector<SDL_FPoint> normals(segments);
+    for (int i = 0; i < segments; ++i)
+    {
+        const SDL_FPoint &a = contour[i];
+        const SDL_FPoint &b = contour[(i + 1) % count];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float length = sqrtf(dx * dx + dy * dy);
+        normals[i].x = -dy / length;
+        normals[i].y = dx / length;
+    }
+
+    // Four vertices across each point: clear, opaque, opaque, clear
+    int first = (int)mesh.vertices.size();
+    for (int i = 0; i < count; ++i)
+    {
+        SDL_FPoint m;
+        if (!closed && i == 0)
+        {
+            m = normals[0];
+        }
+        else if (!closed && i == count - 1)
+        {
+            m = normals[segments - 1];
+        }
+        else
+        {
+            const SDL_FPoint &prev = normals[(i + segments - 1) % segments];
+            m = miter(prev.x, prev.y, normals[i % segments].x, normals[i % segments].y);
+        }
+
+        float x = contour[i].x;
+        float y = contour[i].y;
+
+        // Open ends pull in by half a feather so the cap fades out centred
+        // on the end point, as the sides do on the stroke's edge.
+        if (!closed && (i == 0 || i == count - 1))
+        {
+            float sign = i == 0 ? 1.0f : -1.0f;
+            x += normals[i == 0 ? 0 : segments - 1].y * sign * mFeather / 2.0f;
+            y -= normals[i == 0 ? 0 : segments - 1].x * sign * mFeather / 2.0f;
+        }
+
+        addVertex(mesh.vertices, x + m.x * outer, y + m.y * outer, clear);
+        addVertex(mesh.vertices, x + m.x * core, y + m.y * core, color);
+        addVertex(mesh.vertices, x - m.x * core, y - m.y * core, color);
+        addVertex(mesh.vertices, x - m.x * outer, y - m.y * outer, clear);
+    }
+
+    for (int i = 0; i < segments; ++i)
+    {
+        int a = first + i * 4;
+        int b = first + ((i + 1) % count) * 4;
+        addQuad(mesh.indices, a, b, b + 1, a + 1);
+        addQuad(mesh.indices, a + 1, b + 1, b + 2, a + 2);
+        addQuad(mesh.indices, a + 2, b + 2, b + 3, a + 3);
+    }
+
+    if (closed || mFeather <= 0.0f)
+    {
+        return;
+    }
+
+    // Caps: the end vertices again, a feather further out and all clear
+    for (int end = 0; end < 2; ++end)
+    {
+        int point = end == 0 ? first : first + (count - 1) * 4;
+        const SDL_FPoint &n = normals[end == 0 ? 0 : segments - 1];
+        float sign = end == 0 ? -1.0f : 1.0f;
+        float dx = n.y * sign * mFeather;
+        float dy = -n.x * sign * mFeather;
+
+        int cap = (int)mesh.vertices.size();
+        for (int k = 0; k < 4; ++k)
+        {
+            SDL_FPoint p = mesh.vertices[point + k].position;
+            addVertex(mesh.vertices, p.x + dx, p.y + dy, clear);
+        }
+
+        for (int k = 0; k < 3; ++k)
+        {
+            addQuad(mesh.indices, point + k, cap + k, cap + k + 1, point + k + 1);
+        }
+    }
+}
+
+void VectorRenderer::flush(SDL_Renderer *renderer)
+{
+    PROFILE_SCOPE("VectorRenderer::flush");
+
+    // Same meshes in the same order as last time: nothing to rebuild
+    mStats.geometryReused = !mRebuilt && mFrame == mCombined;
+    if (!mStats.geometryReused)
+    {
+        mVertices.clear();
+        mIndices.clear();
+
+        for (size_t i = 0; i < mFrame.size(); ++i)
+        {
+            const Mesh &mesh = *mFrame[i];
+            int offset = (int)mVertices.size();
+            mVertices.insert(mVertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+            for (size_t k = 0; k < mesh.indices.size(); ++k)
+            {
+                mIndices.push_back(mesh.indices[k] + offset);
+            }
+        }
+
+        mCombined = mFrame;
+    }
+
+    if (!mIndices.empty())
+    {
+        SDL_BlendMode blendMode;
+        SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_RenderGeometry(renderer, NULL, mVertices.data(), (int)mVertices.size(), mIndices.data(), (int)mIndices.size());
+        SDL_SetRenderDrawBlendMode(renderer, blendMode);
+    }
+
+    mStats.meshesDrawn = (int)mFrame.size();
+    mStats.meshesBuilt = mBuilt;
+    mStats.vertices = (int)mVertices.size();
+
+    // Meshes drawn this frame are in mCombined, and never old enough to go.
+    std::unordered_map<Uint64, Mesh>::iterator it = mMeshes.begin();
+    while (it != mMeshes.end())
+    {
+        if (mFrameNumber - it->second.lastFrame >= (Uint32)mCacheFrames)
+        {
+            it = mMeshes.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    ++mFrameNumber;
+    mFrame.clear();
+    mRebuilt = false;
+    mBuilt = 0;
+}
+
+void VectorRenderer::clear()
+{
+    mMeshes.clear();
+    mFrame.clear();
+    mCombined.clear();
+    mVertices.clear();
+    mIndices.clear();
+    mRebuilt = false;
+}
+
+int VectorRenderer::getCacheSize() const
+{
+    return (int)mMeshes.size();
+}
+
+const VectorStats &VectorRenderer::getStats() const
+{
+    return mStats;
+}
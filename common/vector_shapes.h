@@ -0,0 +1,132 @@
+#ifndef VECTOR_SHAPES_H
+#define VECTOR_SHAPES_H
+
+#include <SDL2/SDL.h>
+#include <unordered_map>
+#include <vector>
+
+// Outline made of subpaths, each started with moveTo. Curves and arcs are
+// kept as given and only flattened when the shape is tessellated.
+class VectorPath
+{
+public:
+    void moveTo(float x, float y);
+    void lineTo(float x, float y);
+    void quadTo(float cx, float cy, float x, float y);
+    void cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y);
+
+    // Angles in radians, clockwise on screen. Joins the current point to the
+    // start of the arc with a line, or starts a subpath if there is none.
+    void arc(float cx, float cy, float radius, float startAngle, float endAngle);
+    void close();
+
+    void circle(float cx, float cy, float radius);
+    void roundedRect(const SDL_FRect &rect, float radius);
+
+    void clear();
+    bool empty() const;
+
+    // Polylines no further than tolerance pixels from the curves
+    void flatten(float tolerance, std::vector<std::vector<SDL_FPoint>> &contours, std::vector<bool> &closed) const;
+
+    Uint64 hash() const;
+    bool operator==(const VectorPath &other) const;
+
+private:
+    enum Command
+    {
+        PATH_MOVE,
+        PATH_LINE,
+        PATH_QUAD,
+        PATH_CUBIC,
+        PATH_ARC,
+        PATH_CLOSE
+    };
+
+    void push(Command command, const float *data, int count);
+
+    std::vector<Uint8> mCommands;
+    std::vector<float> mData;
+};
+
+// Fills cover convex subpaths only; strokes may take any shape. Either is
+// skipped when its alpha is zero.
+struct VectorStyle
+{
+    SDL_Color fill;
+    SDL_Color stroke;
+    float strokeWidth;
+
+    VectorStyle();
+
+    bool operator==(const VectorStyle &other) const;
+};
+
+struct VectorStats
+{
+    int meshesDrawn;
+    int meshesBuilt;
+    int vertices;
+    bool geometryReused;
+};
+
+// Draws paths as triangle meshes with a feathered edge: the outermost
+// vertices fade to alpha zero over about a pixel, which anti-aliases the
+// shape without multisampling. Meshes are cached by path and style, so a
+// shape is only tessellated again once it changes, and when a frame draws
+// exactly the meshes of the previous one the combined geometry is reused as
+// is. Everything goes out in one SDL_RenderGeometry call per flush.
+class VectorRenderer
+{
+public:
+    VectorRenderer();
+
+    void setFeather(float pixels);
+    void setTolerance(float pixels);
+
+    // Meshes not drawn for this many flushes are dropped
+    void setCacheFrames(int frames);
+
+    void draw(const VectorPath &path, const VectorStyle &style);
+
+    void flush(SDL_Renderer *renderer);
+
+    void clear();
+
+    int getCacheSize() const;
+    const VectorStats &getStats() const;
+
+private:
+    struct Mesh
+    {
+        VectorPath path;
+        VectorStyle style;
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+        Uint32 lastFrame;
+    };
+
+    void tessellate(Mesh &mesh);
+    void fillContour(Mesh &mesh, const std::vector<SDL_FPoint> &contour);
+    void strokeContour(Mesh &mesh, const std::vector<SDL_FPoint> &contour, bool closed);
+
+    std::unordered_map<Uint64, Mesh> mMeshes;
+
+    // This frame's meshes in draw order, and the ones mVertices holds
+    std::vector<const Mesh *> mFrame;
+    std::vector<const Mesh *> mCombined;
+    bool mRebuilt;
+    int mBuilt;
+
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int> mIndices;
+
+    float mFeather;
+    float mTolerance;
+    int mCacheFrames;
+    Uint32 mFrameNumber;
+
+    VectorStats mStats;
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "view_renderer.h"
+#include "profiler.h"
+
+ViewRenderer::ViewRenderer()
+{
+    mStopping = false;
+    mGeneration = 0;
+    mJobCount = 0;
+    mNext = 0;
+    mBusy = 0;
+}
+
+ViewRenderer::~ViewRenderer()
+{
+    stop();
+}
+
+bool ViewRenderer::start(int workerCount)
+{
+    if (!mWorkers.empty())
+    {
+        return true;
+    }
+
+    if (workerCount <= 0)
+    {
+        workerCount = SDL_GetCPUCount() - 1;
+    }
+
+    // The render thread records a view too, so more would only sleep.
+    workerCount = SDL_min(workerCount, (int)mViews.size() - 1);
+
+    mStopping = false;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        mWorkers.push_back(std::thread(&ViewRenderer::workerLoop, this));
+    }
+
+    return true;
+}
+
+void ViewRenderer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWork.notify_all();
+
+    for (size_t i = 0; i < mWorkers.size(); ++i)
+    {
+        mWorkers[i].join();
+    }
+    mWorkers.clear();
+}
+
+int ViewRenderer::addView(const SDL_Rect &viewport)
+{
+    mViews.push_back(View());
+    mViews.back().enabled = true;
+    mViews.back().dirty = true;
+    setViewport((int)mViews.size() - 1, viewport);
+    return (int)mViews.size() - 1;
+}
+
+void ViewRenderer::setViewport(int view, const SDL_Rect &viewport)
+{
+    mViews[view].viewport = viewport;
+    mViews[view].camera.setViewSize(viewport.w, viewport.h);
+    mViews[view].dirty = true;
+}
+
+void ViewRenderer::setEnabled(int view, bool enabled)
+{
+    mViews[view].dirty = mViews[view].dirty || (enabled && !mViews[view].enabled);
+    mViews[view].enabled = enabled;
+}
+
+int ViewRenderer::getViewCount() const
+{
+    return (int)mViews.size();
+}
+
+const SDL_Rect &ViewRenderer::getViewport(int view) const
+{
+    return mViews[view].viewport;
+}
+
+Camera &ViewRenderer::getCamera(int view)
+{
+    return mViews[view].camera;
+}
+
+void ViewRenderer::invalidate(int view)
+{
+    mViews[view].dirty = true;
+}
+
+void ViewRenderer::invalidateAll()
+{
+    for (size_t i = 0; i < mViews.size(); ++i)
+    {
+        mViews[i].dirty = true;
+    }
+}
+
+void ViewRenderer::recordViews(const ViewRecorder &recorder, int count)
+{
+    int job;
+    while ((job = mNext++) < count)
+    {
+        int view = mJobs[job];
+        View &v = mViews[view];
+        recorder(view, v.camera, v.queue);
+    }
+}
+
+void ViewRenderer::workerLoop()
+{
+    PROFILE_THREAD("view recorder");
+
+    Uint64 seen = 0;
+    while (true)
+    {
+        const ViewRecorder *recorder;
+        int count;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (!mStopping && seen == mGeneration)
+            {
+                mWork.wait(lock);
+            }
+
+            if (mStopping)
+            {
+                return;
+            }
+
+            seen = mGeneration;
+            recorder = &mRecorder;
+            count = mJobCount;
+
+            // Woke after its generation finished; the jobs may be reused.
+            if (count == 0)
+            {
+                continue;
+            }
+            ++mBusy;
+        }
+
+        recordViews(*recorder, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mBusy;
+        }
+        mDone.notify_all();
+    }
+}
+
+int ViewRenderer::record(ViewRecorder recorder)
+{
+    PROFILE_SCOPE("ViewRenderer::record");
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    // A worker that woke late for the last generation may still hold its
+    // jobs and recorder.
+    while (mBusy > 0)
+    {
+        mDone.wait(lock);
+    }
+
+    mJobs.clear();
+    for (size_t i = 0; i < mViews.size(); ++i)
+    {
+        View &v = mViews[i];
+        if (v.enabled && v.dirty)
+        {
+            v.queue.clear();
+            v.dirty = false;
+            mJobs.push_back((int)i);
+        }
+    }
+
+    int count = (int)mJobs.size();
+    mNext = 0;
+
+    if (mWorkers.empty() || count < 2)
+    {
+        lock.unlock();
+        recordViews(recorder, count);
+        return count;
+    }
+
+    mRecorder = recorder;
+    mJobCount = count;
+    ++mGeneration;
+    lock.unlock();
+    mWork.notify_all();
+
+    // The render thread takes views too rather than sit idle.
+    recordViews(mRecorder, count);
+
+    lock.lock();
+    while (mBusy > 0)
+    {
+        mDone.wait(lock);
+    }
+    mJobCount = 0;
+
+    return count;
+}
+
+void ViewRenderer::submit(SDL_Renderer *renderer, RetainedCanvas *canvas)
+{
+    PROFILE_SCOPE("ViewRenderer::submit");
+
+    for (size_t i = 0; i < mViews.size(); ++i)
+    {
+        View &v = mViews[i];
+        if (!v.enabled)
+        {
+            continue;
+        }
+
+        if (canvas != NULL)
+        {
+            if (canvas->setViewport(&v.viewport))
+            {
+                v.queue.submit(renderer, true);
+            }
+        }
+        else
+        {
+            SDL_Rect scissor = {0, 0, v.viewport.w, v.viewport.h};
+            SDL_RenderSetViewport(renderer, &v.viewport);
+            SDL_RenderSetClipRect(renderer, &scissor);
+            v.queue.submit(renderer, true);
+        }
+    }
+
+    if (canvas == NULL)
+    {
+        SDL_RenderSetClipRect(renderer, NULL);
+        SDL_RenderSetViewport(renderer, NULL);
+    }
+}
+
+int ViewRenderer::getCommandCount() const
+{
+    int count = 0;
+    for (size_t i = 0; i < mViews.size(); ++i)
+    {
+        count += mViews[i].queue.getCommandCount();
+    }
+    return count;
+}
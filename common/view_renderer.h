@@ -0,0 +1,97 @@
+#ifndef VIEW_RENDERER_H
+#define VIEW_RENDERER_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "camera.h"
+#include "dirty_rects.h"
+#include "render_queue.h"
+
+// Called once per view to fill its queue, in view-local screen coordinates.
+// Runs on worker threads, so it may read shared state but must not call
+// into SDL; the queue only records.
+typedef std::function<void(int view, const Camera &camera, RenderQueue &queue)> ViewRecorder;
+
+// Any number of views, each a viewport with its own camera and render
+// queue. Recording fans the dirty views out over a small worker pool;
+// submitting then replays the queues on the render thread in view order,
+// each scissored to its viewport.
+class ViewRenderer
+{
+public:
+    ViewRenderer();
+    ~ViewRenderer();
+
+    // Defaults to one worker per core, less the render thread, and never
+    // more than the views added so far can use. Without workers views are
+    // recorded inline.
+    bool start(int workerCount = 0);
+    void stop();
+
+    // Returns the view id. The camera's view size follows the viewport. New,
+    // resized and re-enabled views are marked dirty.
+    int addView(const SDL_Rect &viewport);
+    void setViewport(int view, const SDL_Rect &viewport);
+    void setEnabled(int view, bool enabled);
+
+    int getViewCount() const;
+    const SDL_Rect &getViewport(int view) const;
+    Camera &getCamera(int view);
+
+    // Marks a view to be recorded again, e.g. after moving its camera.
+    void invalidate(int view);
+    void invalidateAll();
+
+    // Clears and records the enabled views marked dirty since the last
+    // call; the others keep their queues. Returns how many were recorded,
+    // once they are all done.
+    int record(ViewRecorder recorder);
+
+    // Draws the recorded views. Queues are kept until the next record(), so
+    // through a canvas this can run once per dirty region, with the scissor
+    // kept to that region.
+    void submit(SDL_Renderer *renderer, RetainedCanvas *canvas = NULL);
+
+    int getCommandCount() const;
+
+private:
+    ViewRenderer(const ViewRenderer &);
+    ViewRenderer &operator=(const ViewRenderer &);
+
+    struct View
+    {
+        SDL_Rect viewport;
+        Camera camera;
+        RenderQueue queue;
+        bool enabled;
+        bool dirty;
+    };
+
+    void workerLoop();
+    void recordViews(const ViewRecorder &recorder, int count);
+
+    std::vector<View> mViews;
+
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mWork;
+    std::condition_variable mDone;
+    bool mStopping;
+
+    // One generation per record(); workers pick up the recorder under the
+    // lock and claim entries of mJobs through mNext. Both stay untouched
+    // until every worker of the generation is done.
+    Uint64 mGeneration;
+    ViewRecorder mRecorder;
+    std::vector<int> mJobs;
+    int mJobCount;
+    std::atomic<int> mNext;
+    int mBusy;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "check.h"
+#include "../common/animation.h"
+
+static std::vector<int> range(int count)
+{
+    std::vector<int> frames;
+    for (int i = 0; i < count; ++i)
+    {
+        frames.push_back(i);
+    }
+    return frames;
+}
+
+void testLoopsAndClamps()
+{
+    AnimationSet set;
+    set.addGrid(10, 10, 4, 1);
+    int loop = set.addAnimation("loop", ANIMATION_LOOP, range(4), 0.1f);
+    int pingPong = set.addAnimation("pingpong", ANIMATION_PING_PONG, range(4), 0.1f);
+    int once = set.addAnimation("once", ANIMATION_ONCE, range(2), 0.1f);
+    CHECK(loop >= 0 && pingPong >= 0 && once >= 0);
+    CHECK(set.getAnimation(pingPong).frames.size() == 6);
+
+    AnimationPool pool(&set);
+    int a = pool.spawn(loop);
+    int b = pool.spawn(pingPong);
+    int c = pool.spawn(once);
+
+    pool.update(0.45);
+    CHECK(pool.getFrame(a) == 0);
+    CHECK(pool.getFrame(b) == 2);
+    CHECK(pool.getFrame(c) == 1);
+    CHECK(pool.isFinished(c));
+    CHECK(!pool.isFinished(a));
+
+    // A long hitch still lands inside the timeline
+    pool.update(1000.1);
+    CHECK(pool.getFrame(a) == 1);
+    CHECK(pool.getClip(a) != NULL && pool.getClip(a)->x == 10);
+}
+
+void testRejectsBadTimelines()
+{
+    AnimationSet set;
+    set.addGrid(10, 10, 2, 1);
+
+    CHECK(set.addAnimation("empty", ANIMATION_LOOP, std::vector<int>(), 0.1f) == -1);
+    CHECK(set.addAnimation("zero", ANIMATION_LOOP, range(2), 0.0f) == -1);
+    CHECK(set.addAnimation("nan", ANIMATION_LOOP, range(2), std::numeric_limits<float>::quiet_NaN()) == -1);
+    CHECK(set.addAnimation("infinite", ANIMATION_LOOP, range(2), std::numeric_limits<float>::infinity()) == -1);
+    CHECK(set.addAnimation("missing", ANIMATION_LOOP, range(3), 0.1f) == -1);
+    CHECK(set.getAnimationCount() == 0);
+
+    // Bad per-step durations fall back to the frame time
+    std::vector<float> durations;
+    durations.push_back(std::numeric_limits<float>::quiet_NaN());
+    durations.push_back(-1.0f);
+    int index = set.addAnimation("fallback", ANIMATION_LOOP, range(2), 0.1f, durations);
+    CHECK(index >= 0);
+    CHECK(std::fabs(set.getAnimation(index).length - 0.2f) < 1e-6f);
+}
+
+void testRejectsBadIndices()
+{
+    AnimationSet set;
+    set.addGrid(10, 10, 2, 1);
+    int loop = set.addAnimation("loop", ANIMATION_LOOP, range(2), 0.1f);
+
+    AnimationPool pool(&set);
+    CHECK(pool.spawn(set.findAnimation("walk")) == -1);
+    CHECK(pool.spawn(loop + 1) == -1);
+    CHECK(pool.getCount() == 0);
+
+    int a = pool.spawn(loop, 1.0f, 0.15f);
+    CHECK(a == 0);
+    CHECK(pool.getFrame(a) == 1);
+
+    // Out of range calls are ignored
+    pool.play(a, 5);
+    pool.play(7, loop);
+    pool.setSpeed(-1, 2.0f);
+    CHECK(pool.getAnimation(a) == loop);
+    CHECK(pool.getFrame(a) == 1);
+
+    CHECK(pool.getClip(-1) == NULL);
+    CHECK(pool.getFrame(3) == -1);
+    CHECK(!pool.isFinished(3));
+
+    AnimationPool unset;
+    CHECK(unset.spawn(0) == -1);
+}
+
+int main(int argc, char const *argv[])
+{
+    testLoopsAndClamps();
+    testRejectsBadTimelines();
+    testRejectsBadIndices();
+
+    return checkResult("animation_test");
+}
@@ -0,0 +1,61 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include "check.h"
+#include "../common/asset_loader.h"
+
+// make test runs the checks from tests/
+const char *FOO_PATH = "../10/foo.png";
+
+void testLoadsWhileRunning()
+{
+    AssetLoader loader;
+    loader.start(2);
+
+    ImageHandle foo = loader.loadImage(FOO_PATH, true, false);
+    ImageHandle missing = loader.loadImage("missing.png", true, false);
+    loader.finish(NULL);
+
+    CHECK(loader.isIdle());
+    CHECK(foo->isReady() && foo->surface != NULL && foo->width > 0);
+    CHECK(missing->isFailed());
+}
+
+void testFailsAfterStop()
+{
+    AssetLoader loader;
+    loader.start(1);
+    loader.stop();
+
+    // Nothing is left to run these, so they fail at once instead of
+    // leaving finish() waiting
+    ImageHandle image = loader.loadImage(FOO_PATH, true, false);
+    FontHandle font = loader.loadFont("missing.ttf", 12);
+    CHECK(image->isFailed());
+    CHECK(font->isFailed());
+    CHECK(loader.isIdle());
+    loader.finish(NULL);
+
+    // A restart takes requests again
+    loader.start(1);
+    image = loader.loadImage(FOO_PATH, true, false);
+    loader.finish(NULL);
+    CHECK(image->isReady());
+}
+
+int main(int argc, char const *argv[])
+{
+    if (SDL_Init(0) < 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        std::cout << "SDL could not initialize! SDL error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    testLoadsWhileRunning();
+    testFailsAfterStop();
+
+    IMG_Quit();
+    SDL_Quit();
+
+    return checkResult("asset_loader_test");
+}
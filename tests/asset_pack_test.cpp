@@ -0,0 +1,204 @@
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "check.h"
+#include "../common/asset_pack.h"
+
+const char *PACK_PATH = "asset_pack_test.pack";
+
+const int PAGE_WIDTH = 16;
+const int PAGE_HEIGHT = 8;
+
+// Offsets of the tables in the pack built below, for corrupting them
+const size_t PAGE_TABLE = sizeof(AssetPackHeader);
+const size_t SPRITE_TABLE = PAGE_TABLE + sizeof(AssetPackPage);
+const size_t CLIP_TABLE = SPRITE_TABLE + 2 * sizeof(AssetPackSprite);
+const size_t STRINGS = CLIP_TABLE + 2 * sizeof(AssetPackClip);
+
+template <typename T>
+static void put(std::vector<Uint8> &data, size_t offset, const T &value)
+{
+    memcpy(&data[offset], &value, sizeof(value));
+}
+
+// One 16x8 page holding sprite "a" with two frames and sprite "b", laid out
+// the way tools/asset_packer writes them.
+static std::vector<Uint8> buildPack()
+{
+    const char strings[] = "a\0b";
+    size_t pixelOffset = (STRINGS + sizeof(strings) + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+
+    std::vector<Uint8> data(pixelOffset + PAGE_WIDTH * 4 * PAGE_HEIGHT, 0);
+
+    AssetPackHeader header = {ASSET_PACK_MAGIC, ASSET_PACK_VERSION, SDL_PIXELFORMAT_ARGB8888, 1, 2, 2, sizeof(strings), 0};
+    put(data, 0, header);
+
+    AssetPackPage page = {PAGE_WIDTH, PAGE_HEIGHT, PAGE_WIDTH * 4, 0, pixelOffset};
+    put(data, PAGE_TABLE, page);
+
+    AssetPackSprite a = {0, 0, 0, 0, 8, 8, 0, 2, 0, 0};
+    AssetPackSprite b = {2, 0, 8, 0, 8, 8, 0, 0, ASSET_PACK_SPRITE_OPAQUE, 0};
+    put(data, SPRITE_TABLE, a);
+    put(data, SPRITE_TABLE + sizeof(AssetPackSprite), b);
+
+    AssetPackClip first = {0, 0, 4, 8};
+    AssetPackClip second = {4, 0, 4, 8};
+    put(data, CLIP_TABLE, first);
+    put(data, CLIP_TABLE + sizeof(AssetPackClip), second);
+
+    memcpy(&data[STRINGS], strings, sizeof(strings));
+
+    for (int i = 0; i < PAGE_WIDTH * PAGE_HEIGHT; ++i)
+    {
+        put(data, pixelOffset + i * 4, (Uint32)(0xFF000000 | i));
+    }
+
+    return data;
+}
+
+static bool openBytes(AssetPack &pack, const std::vector<Uint8> &data)
+{
+    std::ofstream out(PACK_PATH, std::ios::binary | std::ios::trunc);
+    out.write((const char *)data.data(), data.size());
+    out.close();
+
+    return pack.open(PACK_PATH);
+}
+
+void testReadsTables()
+{
+    AssetPack pack;
+    CHECK(openBytes(pack, buildPack()));
+
+    AtlasSprite *a = pack.getSprite("a");
+    AtlasSprite *b = pack.getSprite("b");
+    CHECK(a != NULL && b != NULL);
+    CHECK(pack.getSprite("c") == NULL);
+
+    if (a != NULL && b != NULL)
+    {
+        CHECK(a->clip.x == 0 && a->clip.w == 8 && a->clip.h == 8);
+        CHECK(b->clip.x == 8 && b->page == 0);
+    }
+
+    CHECK(pack.getClipCount("a") == 2);
+    CHECK(pack.getClipCount("b") == 0);
+    CHECK(pack.getClips("b") == NULL);
+
+    SDL_Rect *clips = pack.getClips("a");
+    CHECK(clips != NULL);
+    if (clips != NULL)
+    {
+        CHECK(clips[1].x == 4 && clips[1].w == 4 && clips[1].h == 8);
+    }
+
+    pack.free();
+    CHECK(pack.getSprite("a") == NULL);
+}
+
+void testUploadReplacesPages()
+{
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(target);
+    CHECK(renderer != NULL);
+
+    AssetPack pack;
+    CHECK(openBytes(pack, buildPack()));
+
+    if (renderer != NULL)
+    {
+        CHECK(pack.upload(renderer));
+        CHECK(pack.upload(renderer));
+        CHECK(pack.getPageCount() == 1);
+
+        AtlasSprite *a = pack.getSprite("a");
+        CHECK(a != NULL && a->texture != NULL && a->texture == pack.getPage(0));
+
+        pack.free();
+        SDL_DestroyRenderer(renderer);
+    }
+
+    SDL_FreeSurface(target);
+}
+
+void testRejectsTruncated()
+{
+    std::vector<Uint8> data = buildPack();
+
+    // Anything cut short of the last page row is refused
+    bool rejected = true;
+    for (size_t size = 0; size < data.size(); size += 61)
+    {
+        AssetPack pack;
+        rejected = rejected && !openBytes(pack, std::vector<Uint8>(data.begin(), data.begin() + size));
+    }
+    CHECK(rejected);
+
+    AssetPack pack;
+    CHECK(!openBytes(pack, std::vector<Uint8>(data.begin(), data.end() - 1)));
+}
+
+void testRejectsCorrupt()
+{
+    AssetPack pack;
+
+    std::vector<Uint8> badMagic = buildPack();
+    put(badMagic, 0, (Uint32)0);
+    CHECK(!openBytes(pack, badMagic));
+
+    std::vector<Uint8> badVersion = buildPack();
+    put(badVersion, offsetof(AssetPackHeader, version), ASSET_PACK_VERSION + 1);
+    CHECK(!openBytes(pack, badVersion));
+
+    std::vector<Uint8> hugeCounts = buildPack();
+    put(hugeCounts, offsetof(AssetPackHeader, clipCount), (Uint32)0xFFFFFFFF);
+    CHECK(!openBytes(pack, hugeCounts));
+
+    std::vector<Uint8> pageOutside = buildPack();
+    put(pageOutside, PAGE_TABLE + offsetof(AssetPackPage, offset), (Uint64)pageOutside.size());
+    CHECK(!openBytes(pack, pageOutside));
+
+    // width * 4 wraps to 0 in 32 bits, which a zero pitch must not pass
+    std::vector<Uint8> wrappedPitch = buildPack();
+    put(wrappedPitch, PAGE_TABLE + offsetof(AssetPackPage, width), (Uint32)0x40000000);
+    put(wrappedPitch, PAGE_TABLE + offsetof(AssetPackPage, pitch), (Uint32)0);
+    CHECK(!openBytes(pack, wrappedPitch));
+
+    std::vector<Uint8> emptyPage = buildPack();
+    put(emptyPage, PAGE_TABLE + offsetof(AssetPackPage, height), (Uint32)0);
+    CHECK(!openBytes(pack, emptyPage));
+
+    std::vector<Uint8> badPage = buildPack();
+    put(badPage, SPRITE_TABLE + offsetof(AssetPackSprite, page), (Uint32)1);
+    CHECK(!openBytes(pack, badPage));
+
+    std::vector<Uint8> spriteOutside = buildPack();
+    put(spriteOutside, SPRITE_TABLE + offsetof(AssetPackSprite, x), (Sint32)(PAGE_WIDTH - 4));
+    CHECK(!openBytes(pack, spriteOutside));
+
+    std::vector<Uint8> clipsOutside = buildPack();
+    put(clipsOutside, SPRITE_TABLE + offsetof(AssetPackSprite, clipCount), (Uint32)3);
+    CHECK(!openBytes(pack, clipsOutside));
+
+    std::vector<Uint8> unterminated = buildPack();
+    put(unterminated, STRINGS + 3, (char)'c');
+    CHECK(!openBytes(pack, unterminated));
+
+    // The same file with its tables intact still opens
+    CHECK(openBytes(pack, buildPack()));
+}
+
+int main(int argc, char const *argv[])
+{
+    testReadsTables();
+    testUploadReplacesPages();
+    testRejectsTruncated();
+    testRejectsCorrupt();
+
+    remove(PACK_PATH);
+
+    return checkResult("asset_pack_test");
+}
@@ -0,0 +1,35 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+
+// Minimal checks for the programs in tests/. A failed check prints where it
+// failed and the test keeps going; main returns checkResult() so that
+// make test stops at the first program with failures.
+static int gCheckFailures = 0;
+static int gCheckCount = 0;
+
+#define CHECK(condition)                                                                            \
+    do                                                                                              \
+    {                                                                                               \
+        ++gCheckCount;                                                                              \
+        if (!(condition))                                                                           \
+        {                                                                                           \
+            std::cout << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            ++gCheckFailures;                                                                       \
+        }                                                                                           \
+    } while (0)
+
+inline int checkResult(const char *name)
+{
+    if (gCheckFailures == 0)
+    {
+        std::cout << name << ": " << gCheckCount << " checks passed" << std::endl;
+        return 0;
+    }
+
+    std::cout << name << ": " << gCheckFailures << " of " << gCheckCount << " checks failed" << std::endl;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,117 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <vector>
+#include "check.h"
+#include "../common/dirty_rects.h"
+
+static bool covers(const DirtyRects &dirty, const SDL_Rect &rect)
+{
+    // Every pixel of rect must be in some dirty rect
+    const std::vector<SDL_Rect> &rects = dirty.getRects();
+    for (int y = rect.y; y < rect.y + rect.h; ++y)
+    {
+        for (int x = rect.x; x < rect.x + rect.w; ++x)
+        {
+            SDL_Point p = {x, y};
+            bool found = false;
+            for (size_t i = 0; i < rects.size() && !found; ++i)
+            {
+                found = SDL_PointInRect(&p, &rects[i]);
+            }
+            if (!found)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void testMergesNearbyRects()
+{
+    DirtyRects dirty(640, 480);
+    CHECK(dirty.isEmpty());
+
+    SDL_Rect a = {10, 10, 20, 20};
+    SDL_Rect b = {35, 10, 20, 20};
+    dirty.add(a);
+    dirty.add(b);
+
+    CHECK(dirty.getRects().size() == 1);
+    SDL_Rect merged = dirty.getRects()[0];
+    CHECK(merged.x == 10 && merged.y == 10 && merged.w == 45 && merged.h == 20);
+
+    SDL_Rect far = {300, 300, 10, 10};
+    dirty.add(far);
+    CHECK(dirty.getRects().size() == 2);
+    CHECK(!dirty.isFull());
+}
+
+void testClipsToScreen()
+{
+    DirtyRects dirty(100, 100);
+
+    SDL_Rect outside = {200, 200, 10, 10};
+    dirty.add(outside);
+    CHECK(dirty.isEmpty());
+
+    SDL_Rect edge = {90, -5, 20, 20};
+    dirty.add(edge);
+    CHECK(dirty.getRects().size() == 1);
+    SDL_Rect clipped = dirty.getRects()[0];
+    CHECK(clipped.x == 90 && clipped.y == 0 && clipped.w == 10 && clipped.h == 15);
+}
+
+void testFallsBackToFullScreen()
+{
+    DirtyRects dirty(100, 100);
+
+    SDL_Rect big = {0, 0, 90, 90};
+    dirty.add(big);
+    CHECK(dirty.isFull());
+    CHECK(dirty.getRects().size() == 1);
+    CHECK(dirty.getRects()[0].w == 100 && dirty.getRects()[0].h == 100);
+
+    dirty.clear();
+    CHECK(dirty.isEmpty());
+    CHECK(!dirty.isFull());
+}
+
+void testKeepsCoverage()
+{
+    DirtyRects dirty(640, 480);
+    std::vector<SDL_Rect> added;
+
+    srand(1);
+    for (int i = 0; i < 100; ++i)
+    {
+        SDL_Rect rect = {rand() % 640, rand() % 480, 1 + rand() % 12, 1 + rand() % 12};
+        dirty.add(rect);
+        added.push_back(rect);
+    }
+
+    CHECK((int)dirty.getRects().size() <= DirtyRects::MAX_RECTS);
+
+    SDL_Rect screen = {0, 0, 640, 480};
+    bool covered = true;
+    for (size_t i = 0; i < added.size(); ++i)
+    {
+        SDL_Rect visible;
+        if (SDL_IntersectRect(&added[i], &screen, &visible))
+        {
+            covered = covered && covers(dirty, visible);
+            covered = covered && dirty.intersects(visible);
+        }
+    }
+    CHECK(covered);
+}
+
+int main(int argc, char const *argv[])
+{
+    testMergesNearbyRects();
+    testClipsToScreen();
+    testFallsBackToFullScreen();
+    testKeepsCoverage();
+
+    return checkResult("dirty_rects_test");
+}
@@ -0,0 +1,67 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <iostream>
+#include <string>
+#include "check.h"
+#include "../common/glyph_cache.h"
+
+// make test runs the checks from tests/
+const char *FONT_PATH = "../16/lazy.ttf";
+
+static int layoutWidth(GlyphCache &cache, std::string text)
+{
+    SDL_Color white = {0xFF, 0xFF, 0xFF, 0xFF};
+    TextLayout layout;
+    layout.setText(&cache, text, white);
+    return layout.getWidth();
+}
+
+// Every malformed or non-BMP sequence lays out as one '?'
+void testReplacesWholeSequences(GlyphCache &cache)
+{
+    int expected = layoutWidth(cache, "a?b");
+    CHECK(expected > 0);
+
+    // U+1F600, four bytes
+    CHECK(layoutWidth(cache, "a\xF0\x9F\x98\x80" "b") == expected);
+
+    // Stray continuation bytes and an invalid lead
+    CHECK(layoutWidth(cache, "a\x80\x80\x80" "b") == expected);
+    CHECK(layoutWidth(cache, "a\xFF\x80" "b") == expected);
+
+    // Cut short by the next character, which still draws
+    CHECK(layoutWidth(cache, "a\xE4\xB8" "b") == expected);
+    CHECK(layoutWidth(cache, "a\xF0\x9F" "b") == expected);
+
+    // Two-byte and three-byte characters are one glyph each
+    CHECK(layoutWidth(cache, "\xC3\xA9") == layoutWidth(cache, "\xC3\xA9\xC3\xA9") - layoutWidth(cache, "\xC3\xA9"));
+    CHECK(layoutWidth(cache, "\xE4\xB8\xAD") > 0);
+}
+
+int main(int argc, char const *argv[])
+{
+    if (SDL_Init(0) < 0 || TTF_Init() < 0)
+    {
+        std::cout << "SDL could not initialize! SDL error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(target);
+
+    GlyphCache cache;
+    CHECK(renderer != NULL && cache.load(renderer, FONT_PATH, 16));
+
+    if (renderer != NULL)
+    {
+        testReplacesWholeSequences(cache);
+        cache.free();
+        SDL_DestroyRenderer(renderer);
+    }
+
+    SDL_FreeSurface(target);
+    TTF_Quit();
+    SDL_Quit();
+
+    return checkResult("glyph_cache_test");
+}
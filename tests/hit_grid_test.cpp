@@ -0,0 +1,64 @@
+#include <SDL2/SDL.h>
+#include "check.h"
+#include "../common/hit_grid.h"
+
+void testHitGridTopmost()
+{
+    HitGrid grid(640, 480, 64);
+
+    SDL_Rect back = {0, 0, 200, 200};
+    SDL_Rect front = {100, 100, 200, 200};
+    int lower = grid.add(back);
+    int upper = grid.add(front);
+
+    CHECK(grid.hitTest(50, 50) == lower);
+    CHECK(grid.hitTest(150, 150) == upper);
+    CHECK(grid.hitTest(250, 250) == upper);
+    CHECK(grid.hitTest(400, 400) == -1);
+    CHECK(grid.hitTest(-1, 10) == -1);
+
+    grid.raise(lower);
+    CHECK(grid.hitTest(150, 150) == lower);
+
+    grid.setLayer(upper, 1);
+    CHECK(grid.hitTest(150, 150) == upper);
+
+    grid.setEnabled(upper, false);
+    CHECK(grid.hitTest(150, 150) == lower);
+
+    SDL_Rect moved = {300, 300, 50, 50};
+    grid.move(lower, moved);
+    CHECK(grid.hitTest(50, 50) == -1);
+    CHECK(grid.hitTest(320, 320) == lower);
+}
+
+void testHitGridHover()
+{
+    HitGrid grid(640, 480, 64);
+
+    SDL_Rect left = {0, 0, 100, 100};
+    SDL_Rect right = {200, 0, 100, 100};
+    int a = grid.add(left);
+    int b = grid.add(right);
+
+    HoverChange change = grid.updateHover(10, 10);
+    CHECK(change.left == -1 && change.entered == a);
+
+    change = grid.updateHover(20, 20);
+    CHECK(change.left == -1 && change.entered == -1);
+
+    change = grid.updateHover(210, 10);
+    CHECK(change.left == a && change.entered == b);
+
+    change = grid.clearHover();
+    CHECK(change.left == b && change.entered == -1);
+    CHECK(grid.getHovered() == -1);
+}
+
+int main(int argc, char const *argv[])
+{
+    testHitGridTopmost();
+    testHitGridHover();
+
+    return checkResult("hit_grid_test");
+}
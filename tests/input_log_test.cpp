@@ -0,0 +1,202 @@
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "check.h"
+#include "../common/input_log.h"
+
+const char *LOG_PATH = "input_log_test.inputlog";
+
+static SDL_Event makeEvent(Uint32 type)
+{
+    SDL_Event event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    return event;
+}
+
+// Frame f holds f mouse motions, a key press every third frame and a text
+// event the log does not keep.
+static std::vector<SDL_Event> makeFrame(int f)
+{
+    std::vector<SDL_Event> events;
+    for (int i = 0; i < f; ++i)
+    {
+        SDL_Event motion = makeEvent(SDL_MOUSEMOTION);
+        motion.motion.x = f * 10 + i;
+        motion.motion.y = -i;
+        motion.motion.xrel = 1;
+        events.push_back(motion);
+    }
+    if (f % 3 == 0)
+    {
+        SDL_Event key = makeEvent(SDL_KEYDOWN);
+        key.key.keysym.scancode = (SDL_Scancode)(40 + f);
+        key.key.keysym.sym = 'a' + f;
+        events.push_back(key);
+    }
+    events.push_back(makeEvent(SDL_TEXTINPUT));
+    return events;
+}
+
+static bool sameFrame(const std::vector<SDL_Event> &recorded, const std::vector<SDL_Event> &replayed)
+{
+    std::vector<SDL_Event> kept;
+    for (size_t i = 0; i < recorded.size(); ++i)
+    {
+        if (recorded[i].type != SDL_TEXTINPUT)
+        {
+            kept.push_back(recorded[i]);
+        }
+    }
+
+    if (kept.size() != replayed.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < kept.size(); ++i)
+    {
+        const SDL_Event &a = kept[i];
+        const SDL_Event &b = replayed[i];
+        if (a.type != b.type)
+        {
+            return false;
+        }
+        if (a.type == SDL_MOUSEMOTION && (a.motion.x != b.motion.x || a.motion.y != b.motion.y || a.motion.xrel != b.motion.xrel))
+        {
+            return false;
+        }
+        if (a.type == SDL_KEYDOWN && (a.key.keysym.scancode != b.key.keysym.scancode || a.key.keysym.sym != b.key.keysym.sym || b.key.state != SDL_PRESSED))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void recordFrames(int count)
+{
+    InputRecorder recorder;
+    CHECK(recorder.open(LOG_PATH));
+    for (int f = 0; f < count; ++f)
+    {
+        recorder.recordFrame(makeFrame(f));
+    }
+    recorder.close();
+}
+
+void testRoundTrip()
+{
+    recordFrames(10);
+
+    InputReplayer replayer;
+    CHECK(replayer.open(LOG_PATH));
+    CHECK(replayer.getFrameCount() == 10);
+
+    bool same = true;
+    for (int f = 0; f < 10; ++f)
+    {
+        std::vector<SDL_Event> events;
+        replayer.nextFrame(events);
+        same = same && sameFrame(makeFrame(f), events);
+    }
+    CHECK(same);
+    CHECK(!replayer.isFinished());
+
+    std::vector<SDL_Event> events;
+    replayer.nextFrame(events);
+    CHECK(events.size() == 1 && events[0].type == SDL_QUIT);
+    CHECK(replayer.isFinished());
+}
+
+void testPacksEventTypes()
+{
+    Uint32 kept[] = {SDL_QUIT, SDL_KEYUP, SDL_MOUSEBUTTONDOWN, SDL_MOUSEWHEEL, SDL_WINDOWEVENT, SDL_CONTROLLERAXISMOTION};
+    bool packed = true;
+    for (size_t i = 0; i < sizeof(kept) / sizeof(kept[0]); ++i)
+    {
+        InputLogEvent out;
+        packed = packed && packInputEvent(makeEvent(kept[i]), &out) && unpackInputEvent(out).type == kept[i];
+    }
+    CHECK(packed);
+
+    SDL_Event wheel = makeEvent(SDL_MOUSEWHEEL);
+    wheel.wheel.y = -3;
+    InputLogEvent out;
+    packInputEvent(wheel, &out);
+    CHECK(unpackInputEvent(out).wheel.y == -3);
+
+    CHECK(!packInputEvent(makeEvent(SDL_TEXTINPUT), &out));
+}
+
+void testTruncatedReplaysToCut()
+{
+    recordFrames(10);
+
+    std::ifstream in(LOG_PATH, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    // Keep the header and the first four frames plus half of the fifth
+    size_t cut = sizeof(InputLogHeader);
+    for (int f = 0; f < 4; ++f)
+    {
+        InputLogFrame frame;
+        memcpy(&frame, &data[cut], sizeof(frame));
+        cut += sizeof(frame) + frame.eventCount * sizeof(InputLogEvent);
+    }
+    cut += sizeof(InputLogFrame) + sizeof(InputLogEvent) / 2;
+
+    std::ofstream out(LOG_PATH, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), cut);
+    out.close();
+
+    InputReplayer replayer;
+    CHECK(replayer.open(LOG_PATH));
+
+    int frames = 0;
+    bool quit = false;
+    while (!quit && frames < 20)
+    {
+        std::vector<SDL_Event> events;
+        replayer.nextFrame(events);
+        quit = !events.empty() && events.back().type == SDL_QUIT;
+        if (!quit)
+        {
+            ++frames;
+        }
+    }
+    CHECK(quit);
+    CHECK(frames == 4);
+}
+
+void testRejectsCorrupt()
+{
+    InputReplayer replayer;
+    CHECK(!replayer.open("missing.inputlog"));
+
+    InputLogHeader header = {INPUT_LOG_MAGIC + 1, INPUT_LOG_VERSION, 0, 0};
+    std::ofstream out(LOG_PATH, std::ios::binary | std::ios::trunc);
+    out.write((const char *)&header, sizeof(header));
+    out.close();
+    CHECK(!replayer.open(LOG_PATH));
+
+    out.open(LOG_PATH, std::ios::binary | std::ios::trunc);
+    out.write((const char *)&header, sizeof(header) - 1);
+    out.close();
+    CHECK(!replayer.open(LOG_PATH));
+}
+
+int main(int argc, char const *argv[])
+{
+    testRoundTrip();
+    testPacksEventTypes();
+    testTruncatedReplaysToCut();
+    testRejectsCorrupt();
+
+    remove(LOG_PATH);
+
+    return checkResult("input_log_test");
+}
@@ -0,0 +1,48 @@
+#include <SDL2/SDL.h>
+#include "check.h"
+#include "../common/primitive_batch.h"
+
+void testRestoresRendererState(SDL_Renderer *renderer)
+{
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_ADD);
+    SDL_SetRenderDrawColor(renderer, 1, 2, 3, 4);
+
+    PrimitiveBatch batch;
+    batch.setBlendMode(SDL_BLENDMODE_BLEND);
+    SDL_FRect rect = {1.0f, 1.0f, 8.0f, 8.0f};
+    batch.setColor(0xFF, 0x00, 0x00);
+    batch.fillRect(rect);
+    batch.point(2.0f, 2.0f);
+    CHECK(batch.flush(renderer) == 2);
+
+    SDL_BlendMode mode = SDL_BLENDMODE_INVALID;
+    SDL_GetRenderDrawBlendMode(renderer, &mode);
+    CHECK(mode == SDL_BLENDMODE_ADD);
+
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    CHECK(r == 1 && g == 2 && b == 3 && a == 4);
+
+    // Nothing queued still leaves the state alone
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_MOD);
+    CHECK(batch.flush(renderer) == 0);
+    SDL_GetRenderDrawBlendMode(renderer, &mode);
+    CHECK(mode == SDL_BLENDMODE_MOD);
+}
+
+int main(int argc, char const *argv[])
+{
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(target);
+    CHECK(renderer != NULL);
+
+    if (renderer != NULL)
+    {
+        testRestoresRendererState(renderer);
+        SDL_DestroyRenderer(renderer);
+    }
+
+    SDL_FreeSurface(target);
+
+    return checkResult("primitive_batch_test");
+}
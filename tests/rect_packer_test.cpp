@@ -0,0 +1,86 @@
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <vector>
+#include "check.h"
+#include "../common/rect_packer.h"
+
+void testFillsWithoutOverlap()
+{
+    RectPacker packer(256, 256);
+    std::vector<SDL_Rect> placed;
+
+    srand(1);
+    for (int i = 0; i < 1000; ++i)
+    {
+        SDL_Rect rect;
+        if (packer.insert(4 + rand() % 28, 4 + rand() % 28, &rect))
+        {
+            placed.push_back(rect);
+        }
+    }
+
+    CHECK(placed.size() > 50);
+    CHECK(packer.getOccupancy() > 0.5f);
+    CHECK(packer.getOccupancy() <= 1.0f);
+
+    bool inside = true;
+    bool overlaps = false;
+    for (size_t i = 0; i < placed.size(); ++i)
+    {
+        const SDL_Rect &a = placed[i];
+        inside = inside && a.x >= 0 && a.y >= 0 && a.x + a.w <= 256 && a.y + a.h <= 256;
+        for (size_t j = i + 1; j < placed.size(); ++j)
+        {
+            overlaps = overlaps || SDL_HasIntersection(&a, &placed[j]);
+        }
+    }
+    CHECK(inside);
+    CHECK(!overlaps);
+}
+
+void testExactFit()
+{
+    RectPacker packer(64, 64);
+    SDL_Rect rect;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        CHECK(packer.insert(16, 16, &rect));
+    }
+    CHECK(!packer.insert(1, 1, &rect));
+    CHECK(packer.getOccupancy() == 1.0f);
+}
+
+void testRejectsOversized()
+{
+    RectPacker packer(64, 32);
+    SDL_Rect rect;
+
+    CHECK(!packer.insert(65, 1, &rect));
+    CHECK(!packer.insert(1, 33, &rect));
+    CHECK(packer.insert(64, 32, &rect));
+    CHECK(rect.x == 0 && rect.y == 0);
+}
+
+void testReset()
+{
+    RectPacker packer(32, 32);
+    SDL_Rect rect;
+
+    CHECK(packer.insert(32, 32, &rect));
+    CHECK(!packer.insert(1, 1, &rect));
+
+    packer.reset(32, 32);
+    CHECK(packer.getOccupancy() == 0.0f);
+    CHECK(packer.insert(32, 32, &rect));
+}
+
+int main(int argc, char const *argv[])
+{
+    testFillsWithoutOverlap();
+    testExactFit();
+    testRejectsOversized();
+    testReset();
+
+    return checkResult("rect_packer_test");
+}
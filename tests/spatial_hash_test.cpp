@@ -0,0 +1,108 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "check.h"
+#include "../common/spatial_hash.h"
+
+static SDL_Rect randomRect(int range, int maxSize)
+{
+    SDL_Rect rect = {rand() % range - range / 4, rand() % range - range / 4, 1 + rand() % maxSize, 1 + rand() % maxSize};
+    return rect;
+}
+
+// The hash against a plain scan over every live object
+void testSpatialHashMatchesScan()
+{
+    SpatialHash hash(64);
+    std::vector<SDL_Rect> bounds;
+    std::vector<bool> live;
+
+    srand(1);
+    for (int i = 0; i < 2000; ++i)
+    {
+        SDL_Rect rect = randomRect(4000, 200);
+        int id = hash.add(rect);
+        if (id >= (int)bounds.size())
+        {
+            bounds.resize(id + 1);
+            live.resize(id + 1);
+        }
+        bounds[id] = rect;
+        live[id] = true;
+    }
+
+    for (int i = 0; i < 500; ++i)
+    {
+        int id = rand() % bounds.size();
+        if (!live[id])
+        {
+            continue;
+        }
+        if (i % 3 == 0)
+        {
+            hash.remove(id);
+            live[id] = false;
+        }
+        else
+        {
+            bounds[id] = randomRect(4000, 200);
+            hash.move(id, bounds[id]);
+        }
+    }
+
+    int liveCount = (int)std::count(live.begin(), live.end(), true);
+    CHECK(hash.getCount() == liveCount);
+
+    bool matches = true;
+    std::vector<int> results;
+    for (int q = 0; q < 200; ++q)
+    {
+        SDL_Rect area = randomRect(4000, 800);
+        hash.query(area, results);
+
+        std::vector<int> expected;
+        for (size_t id = 0; id < bounds.size(); ++id)
+        {
+            if (live[id] && SDL_HasIntersection(&bounds[id], &area))
+            {
+                expected.push_back((int)id);
+            }
+        }
+
+        std::sort(results.begin(), results.end());
+        matches = matches && results == expected;
+    }
+    CHECK(matches);
+}
+
+void testSpatialHashReusesIds()
+{
+    SpatialHash hash(32);
+    SDL_Rect rect = {0, 0, 10, 10};
+
+    int a = hash.add(rect);
+    int b = hash.add(rect);
+    CHECK(a != b);
+
+    hash.remove(a);
+    CHECK(hash.getCount() == 1);
+    CHECK(hash.add(rect) == a);
+
+    std::vector<int> results;
+    SDL_Rect far = {1000, 1000, 10, 10};
+    hash.query(far, results);
+    CHECK(results.empty());
+
+    hash.reset(32);
+    CHECK(hash.getCount() == 0);
+    CHECK(hash.getCellCount() == 0);
+}
+
+int main(int argc, char const *argv[])
+{
+    testSpatialHashMatchesScan();
+    testSpatialHashReusesIds();
+
+    return checkResult("spatial_hash_test");
+}
@@ -0,0 +1,48 @@
+#include <SDL2/SDL.h>
+#include "check.h"
+#include "../common/sprite_batch.h"
+
+void testKeepsTextureBlendMode(SDL_Renderer *renderer)
+{
+    SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 8, 8);
+    CHECK(texture != NULL);
+    if (texture == NULL)
+    {
+        return;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_ADD);
+
+    SpriteBatch batch;
+    batch.draw(texture, 0, 0);
+    batch.draw(texture, 8, 0);
+    CHECK(batch.flush(renderer) == 1);
+
+    // An override only lasts for the flush and groups separately
+    batch.draw(texture, 0, 0);
+    batch.setBlendMode(SDL_BLENDMODE_BLEND);
+    batch.draw(texture, 8, 0);
+    CHECK(batch.flush(renderer) == 2);
+
+    SDL_BlendMode mode = SDL_BLENDMODE_INVALID;
+    SDL_GetTextureBlendMode(texture, &mode);
+    CHECK(mode == SDL_BLENDMODE_ADD);
+
+    SDL_DestroyTexture(texture);
+}
+
+int main(int argc, char const *argv[])
+{
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(target);
+    CHECK(renderer != NULL);
+
+    if (renderer != NULL)
+    {
+        testKeepsTextureBlendMode(renderer);
+        SDL_DestroyRenderer(renderer);
+    }
+
+    SDL_FreeSurface(target);
+
+    return checkResult("sprite_batch_test");
+}
@@ -0,0 +1,123 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <utility>
+#include "check.h"
+#include "../common/ltexture.h"
+#include "../common/texture_cache.h"
+
+// make test runs the checks from tests/
+const char *FOO_PATH = "../10/foo.png";
+const char *BACKGROUND_PATH = "../10/background.png";
+
+void testSharesOneLoad(SDL_Renderer *renderer)
+{
+    TextureCache cache;
+
+    LTexture first;
+    LTexture second;
+    CHECK(first.loadFromCache(cache, renderer, FOO_PATH));
+    CHECK(second.loadFromCache(cache, renderer, "../10/./foo.png"));
+
+    // One decode and one texture for both
+    CHECK(cache.getMisses() == 1);
+    CHECK(cache.getHits() == 1);
+    CHECK(first.getTexture() != NULL && first.getTexture() == second.getTexture());
+    CHECK(first.getWidth() > 0 && first.getWidth() == second.getWidth());
+
+    // Different options are a different texture
+    TextureLoadOptions unkeyed;
+    unkeyed.colorKey = false;
+    LTexture third;
+    CHECK(third.loadFromCache(cache, renderer, FOO_PATH, unkeyed));
+    CHECK(cache.getMisses() == 2);
+    CHECK(third.getTexture() != first.getTexture());
+
+    // Without custom blend modes a premultiplied load still succeeds, as
+    // straight alpha
+    TextureLoadOptions premultiplied;
+    premultiplied.premultiply = true;
+    LTexture baked;
+    int misses = cache.getMisses();
+    CHECK(baked.loadFromCache(cache, renderer, FOO_PATH, premultiplied));
+    CHECK(baked.getTexture() != first.getTexture());
+    CHECK(cache.getMisses() == misses + 1);
+
+    // and is cached as such, so asking again neither decodes nor misses
+    LTexture bakedAgain;
+    CHECK(bakedAgain.loadFromCache(cache, renderer, FOO_PATH, premultiplied));
+    CHECK(bakedAgain.getTexture() == baked.getTexture());
+    CHECK(cache.getMisses() == misses + 1);
+    CHECK(!cache.load(renderer, FOO_PATH, premultiplied)->premultiplied);
+
+    // Freeing one holder leaves the texture to the other
+    first.free();
+    CHECK(first.getTexture() == NULL);
+    CHECK(second.getTexture() != NULL);
+
+    LTexture moved(std::move(second));
+    CHECK(second.getTexture() == NULL);
+    CHECK(moved.getTexture() != NULL);
+}
+
+void testEvictsOverBudget(SDL_Renderer *renderer)
+{
+    TextureCache cache;
+
+    LTexture foo;
+    CHECK(foo.loadFromCache(cache, renderer, FOO_PATH));
+    size_t fooBytes = cache.getResidentBytes();
+    CHECK(fooBytes > 0);
+
+    // Room for foo alone; it stays while in use
+    cache.setBudget(fooBytes);
+
+    LTexture background;
+    CHECK(background.loadFromCache(cache, renderer, BACKGROUND_PATH));
+    CHECK(cache.getEvictions() == 0);
+    CHECK(cache.getResidentBytes() > fooBytes);
+
+    foo.free();
+    cache.trim();
+    CHECK(cache.getEvictions() == 1);
+
+    // Evicted, so loading it again decodes again
+    int misses = cache.getMisses();
+    CHECK(foo.loadFromCache(cache, renderer, FOO_PATH));
+    CHECK(cache.getMisses() == misses + 1);
+
+    // Nothing in use can be evicted, whatever the budget
+    cache.setBudget(0);
+    CHECK(foo.getTexture() != NULL && background.getTexture() != NULL);
+
+    foo.free();
+    background.free();
+    cache.trim();
+    CHECK(cache.getResidentBytes() == 0);
+}
+
+int main(int argc, char const *argv[])
+{
+    if (SDL_Init(0) < 0 || !(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG))
+    {
+        std::cout << "SDL could not initialize! SDL error: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(target);
+    CHECK(renderer != NULL);
+
+    if (renderer != NULL)
+    {
+        testSharesOneLoad(renderer);
+        testEvictsOverBudget(renderer);
+        SDL_DestroyRenderer(renderer);
+    }
+
+    SDL_FreeSurface(target);
+    IMG_Quit();
+    SDL_Quit();
+
+    return checkResult("texture_cache_test");
+}
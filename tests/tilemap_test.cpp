@@ -0,0 +1,157 @@
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "../common/tilemap.h"
+
+const char *MAP_PATH = "tilemap_test.map";
+
+static std::vector<char> readFile(const char *path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const char *path, const std::vector<char> &data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+}
+
+static void fillMap(Tilemap &map)
+{
+    map.create(70, 40, 2);
+
+    std::vector<Uint16> frames;
+    frames.push_back(1);
+    frames.push_back(2);
+    map.setAnimation(9, frames, 100);
+
+    for (int y = 0; y < 40; ++y)
+    {
+        for (int x = 0; x < 70; ++x)
+        {
+            map.setTile(0, x, y, (Uint16)((x / 7 + y / 3) % 4));
+            if ((x * 31 + y * 17) % 23 == 0)
+            {
+                map.setTile(1, x, y, 9);
+            }
+        }
+    }
+}
+
+void testRoundTrip()
+{
+    Tilemap original;
+    fillMap(original);
+    CHECK(original.saveToFile(MAP_PATH));
+
+    Tilemap loaded;
+    CHECK(loaded.loadFromFile(MAP_PATH));
+    CHECK(loaded.getWidth() == 70);
+    CHECK(loaded.getHeight() == 40);
+    CHECK(loaded.getLayerCount() == 2);
+
+    bool same = true;
+    for (int layer = 0; layer < 2; ++layer)
+    {
+        for (int y = 0; y < 40; ++y)
+        {
+            for (int x = 0; x < 70; ++x)
+            {
+                same = same && loaded.getTile(layer, x, y) == original.getTile(layer, x, y);
+            }
+        }
+    }
+    CHECK(same);
+
+    // Runs keep the file well under two bytes a tile
+    CHECK(readFile(MAP_PATH).size() < 70 * 40 * 2);
+}
+
+void testRejectsTruncated()
+{
+    Tilemap original;
+    fillMap(original);
+    CHECK(original.saveToFile(MAP_PATH));
+
+    std::vector<char> data = readFile(MAP_PATH);
+    bool rejected = true;
+    for (size_t size = 0; size < data.size(); size += 31)
+    {
+        writeFile(MAP_PATH, std::vector<char>(data.begin(), data.begin() + size));
+
+        Tilemap loaded;
+        rejected = rejected && !loaded.loadFromFile(MAP_PATH) && loaded.getWidth() == 0;
+    }
+    CHECK(rejected);
+}
+
+void testRejectsCorrupt()
+{
+    Tilemap original;
+    fillMap(original);
+    CHECK(original.saveToFile(MAP_PATH));
+    std::vector<char> data = readFile(MAP_PATH);
+
+    std::vector<char> badMagic = data;
+    badMagic[0] ^= 0xFF;
+    writeFile(MAP_PATH, badMagic);
+    Tilemap loaded;
+    CHECK(!loaded.loadFromFile(MAP_PATH));
+
+    // Runs that overflow the layer
+    std::vector<char> longRun = data;
+    TilemapHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+    size_t firstRun = sizeof(header) + sizeof(TilemapAnimation) + 2 * sizeof(Uint16) + sizeof(Uint32);
+    TilemapRun run;
+    memcpy(&run, &longRun[firstRun], sizeof(run));
+    run.count = 0xFFFF;
+    memcpy(&longRun[firstRun], &run, sizeof(run));
+    writeFile(MAP_PATH, longRun);
+    CHECK(!loaded.loadFromFile(MAP_PATH));
+
+    CHECK(!loaded.loadFromFile("missing.map"));
+}
+
+static bool loadHeader(Uint32 width, Uint32 height, Uint32 layerCount, size_t padding)
+{
+    TilemapHeader header = {TILEMAP_MAGIC, TILEMAP_VERSION, width, height, layerCount, 0};
+    std::vector<char> data(sizeof(header) + padding, 0);
+    memcpy(data.data(), &header, sizeof(header));
+    writeFile(MAP_PATH, data);
+
+    Tilemap loaded;
+    return loaded.loadFromFile(MAP_PATH);
+}
+
+// Headers asking for more than the file could hold are refused before
+// anything is allocated
+void testRejectsHostileHeader()
+{
+    CHECK(!loadHeader(0xFFFFFFFF, 0xFFFFFFFF, 1, 0));
+    CHECK(!loadHeader(0x10000, 0x10000, 1, 64));
+    CHECK(!loadHeader(64, 64, 0xFFFFFFFF, 64));
+    CHECK(!loadHeader(64, 64, TILEMAP_MAX_LAYERS + 1, 4096));
+    CHECK(!loadHeader(4096, 4096, 1, 16));
+    CHECK(!loadHeader(1, 1, 2, sizeof(Uint32) + sizeof(TilemapRun)));
+
+    // An empty map is still fine
+    CHECK(loadHeader(0, 0, 0, 0));
+}
+
+int main(int argc, char const *argv[])
+{
+    testRoundTrip();
+    testRejectsTruncated();
+    testRejectsCorrupt();
+    testRejectsHostileHeader();
+
+    remove(MAP_PATH);
+
+    return checkResult("tilemap_test");
+}
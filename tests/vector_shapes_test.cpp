@@ -0,0 +1,39 @@
+#include <SDL2/SDL.h>
+#include "check.h"
+#include "../common/vector_shapes.h"
+
+void testRestoresBlendMode(SDL_Renderer *renderer)
+{
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    VectorPath circle;
+    circle.circle(16.0f, 16.0f, 10.0f);
+    VectorStyle style;
+    style.fill = {0xFF, 0x00, 0x00, 0xFF};
+
+    VectorRenderer vectors;
+    vectors.draw(circle, style);
+    vectors.flush(renderer);
+    CHECK(vectors.getStats().vertices > 0);
+
+    SDL_BlendMode mode = SDL_BLENDMODE_INVALID;
+    SDL_GetRenderDrawBlendMode(renderer, &mode);
+    CHECK(mode == SDL_BLENDMODE_NONE);
+}
+
+int main(int argc, char const *argv[])
+{
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = SDL_CreateSoftwareRenderer(target);
+    CHECK(renderer != NULL);
+
+    if (renderer != NULL)
+    {
+        testRestoresBlendMode(renderer);
+        SDL_DestroyRenderer(renderer);
+    }
+
+    SDL_FreeSurface(target);
+
+    return checkResult("vector_shapes_test");
+}
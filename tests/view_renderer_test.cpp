@@ -0,0 +1,117 @@
+#include <SDL2/SDL.h>
+#include <vector>
+#include "check.h"
+#include "../common/view_renderer.h"
+
+const int VIEW_COUNT = 8;
+
+static void addViews(ViewRenderer &views)
+{
+    for (int i = 0; i < VIEW_COUNT; ++i)
+    {
+        SDL_Rect viewport = {i * 10, 0, 10, 10};
+        views.addView(viewport);
+    }
+}
+
+// Each view records view + 1 commands plus a per-frame extra, so stale
+// queues show up in the command count
+static int expectedCommands(const std::vector<int> &extras)
+{
+    int count = 0;
+    for (int i = 0; i < VIEW_COUNT; ++i)
+    {
+        count += i + 1 + extras[i];
+    }
+    return count;
+}
+
+// start(0) means one worker per core, so the inline path is tested by not
+// starting at all
+void testRecordsOnlyDirtyViews(bool threaded, int workerCount)
+{
+    ViewRenderer views;
+    addViews(views);
+    if (threaded)
+    {
+        views.start(workerCount);
+    }
+
+    std::vector<int> extras(VIEW_COUNT, 0);
+    bool counted = true;
+    bool matched = true;
+
+    for (int frame = 0; frame < 2000; ++frame)
+    {
+        int extra = frame % 3;
+        int expected = VIEW_COUNT;
+        if (frame > 0)
+        {
+            views.invalidate(frame % VIEW_COUNT);
+            expected = 1;
+            if (frame % 5 == 0)
+            {
+                views.invalidate((frame + 3) % VIEW_COUNT);
+                expected = 2;
+            }
+        }
+
+        int recorded = views.record([&extras, extra](int view, const Camera &camera, RenderQueue &queue)
+                                    {
+                                        for (int i = 0; i <= view + extra; ++i)
+                                        {
+                                            queue.drawPoint(i, i);
+                                        }
+                                        extras[view] = extra;
+                                    });
+
+        counted = counted && recorded == expected;
+        matched = matched && views.getCommandCount() == expectedCommands(extras);
+    }
+
+    CHECK(counted);
+    CHECK(matched);
+
+    // Nothing dirty, nothing recorded
+    CHECK(views.record([](int, const Camera &, RenderQueue &) {}) == 0);
+
+    views.stop();
+}
+
+void testStateChangesMarkDirty()
+{
+    ViewRenderer views;
+    addViews(views);
+
+    ViewRecorder none = [](int, const Camera &, RenderQueue &) {};
+    CHECK(views.record(none) == VIEW_COUNT);
+
+    SDL_Rect moved = {0, 20, 30, 30};
+    views.setViewport(1, moved);
+    CHECK(views.record(none) == 1);
+
+    views.setEnabled(2, false);
+    CHECK(views.record(none) == 0);
+    views.setEnabled(2, true);
+    CHECK(views.record(none) == 1);
+
+    // Disabled views wait until they are enabled again
+    views.setEnabled(3, false);
+    views.invalidate(3);
+    CHECK(views.record(none) == 0);
+    views.setEnabled(3, true);
+    CHECK(views.record(none) == 1);
+
+    views.invalidateAll();
+    CHECK(views.record(none) == VIEW_COUNT);
+}
+
+int main(int argc, char const *argv[])
+{
+    testRecordsOnlyDirtyViews(false, 0);
+    testRecordsOnlyDirtyViews(true, 3);
+    testRecordsOnlyDirtyViews(true, 64);
+    testStateChangesMarkDirty();
+
+    return checkResult("view_renderer_test");
+}
@@ -0,0 +1,394 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../common/asset_pack.h"
+#include "../common/key_alpha.h"
+#include "../common/rect_packer.h"
+#include "../common/soft_blit.h"
+
+// Bakes the images listed in a manifest into one asset pack.
+//
+//   asset_packer [--page-size N] <manifest> <output.pack>
+//
+// Manifest lines, with paths relative to the manifest:
+//
+//   image <name> <path> [key]   add an image, optionally keying out cyan
+//   clip <x> <y> <w> <h>        add a clip to the previous image
+//   grid <columns> <rows>       split the previous image into equal clips
+//
+// A make dependency file is written next to the pack as <output>.d.
+
+const int DEFAULT_PAGE_SIZE = 2048;
+const int PADDING = 1;
+
+struct PackImage
+{
+    std::string name;
+    std::string path;
+    bool colorKey;
+    int gridColumns;
+    int gridRows;
+    std::vector<AssetPackClip> clips;
+
+    SDL_Surface *surface;
+    bool opaque;
+    int page;
+    SDL_Rect rect;
+};
+
+struct PackPage
+{
+    RectPacker packer;
+    int width;
+    int height;
+};
+
+bool parseManifest(std::string manifestPath, std::vector<PackImage> &images)
+{
+    std::ifstream in(manifestPath);
+    if (!in)
+    {
+        std::cout << "Unable to open manifest " << manifestPath << std::endl;
+        return false;
+    }
+
+    std::filesystem::path baseDir = std::filesystem::path(manifestPath).parent_path();
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+
+        std::istringstream fields(line);
+        std::string command;
+        if (!(fields >> command) || command[0] == '#')
+        {
+            continue;
+        }
+
+        bool valid = true;
+        if (command == "image")
+        {
+            PackImage image;
+            std::string option;
+            valid = (bool)(fields >> image.name >> image.path);
+            image.path = (baseDir / image.path).string();
+            image.colorKey = (bool)(fields >> option) && option == "key";
+            image.gridColumns = 0;
+            image.gridRows = 0;
+            image.surface = NULL;
+            image.opaque = false;
+            image.page = 0;
+            images.push_back(image);
+        }
+        else if (command == "clip" && !images.empty())
+        {
+            AssetPackClip clip;
+            valid = (bool)(fields >> clip.x >> clip.y >> clip.w >> clip.h);
+            images.back().clips.push_back(clip);
+        }
+        else if (command == "grid" && !images.empty())
+        {
+            // Resolved against the image size once it is loaded.
+            PackImage &image = images.back();
+            valid = (bool)(fields >> image.gridColumns >> image.gridRows) && image.gridColumns > 0 && image.gridRows > 0;
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            std::cout << manifestPath << ":" << lineNumber << ": cannot parse '" << line << "'" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool loadImage(PackImage &image)
+{
+    SDL_Surface *loadedSurface = IMG_Load(image.path.c_str());
+    if (loadedSurface == NULL)
+    {
+        std::cout << "Unable to load image " << image.path << "! SDL_image error: " << IMG_GetError() << std::endl;
+        return false;
+    }
+
+    image.surface = softConvertSurface(loadedSurface, SDL_PIXELFORMAT_ARGB8888);
+    SDL_FreeSurface(loadedSurface);
+    if (image.surface == NULL)
+    {
+        std::cout << "Unable to convert image " << image.path << "! SDL error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // Same cyan key the lessons use at runtime, baked in once here.
+    if (image.colorKey)
+    {
+        KeyAlphaOptions options;
+        keyToAlpha(image.surface, options.keyColor);
+        bleedAlpha(image.surface);
+    }
+
+    image.opaque = true;
+    for (int y = 0; y < image.surface->h && image.opaque; ++y)
+    {
+        const Uint32 *row = (const Uint32 *)((const Uint8 *)image.surface->pixels + y * image.surface->pitch);
+        for (int x = 0; x < image.surface->w; ++x)
+        {
+            if ((row[x] >> 24) != 0xFF)
+            {
+                image.opaque = false;
+                break;
+            }
+        }
+    }
+
+    int cellWidth = image.gridColumns > 0 ? image.surface->w / image.gridColumns : 0;
+    int cellHeight = image.gridRows > 0 ? image.surface->h / image.gridRows : 0;
+    for (int row = 0; row < image.gridRows; ++row)
+    {
+        for (int column = 0; column < image.gridColumns; ++column)
+        {
+            AssetPackClip cell = {column * cellWidth, row * cellHeight, cellWidth, cellHeight};
+            image.clips.push_back(cell);
+        }
+    }
+
+    return true;
+}
+
+static bool tallerFirst(const PackImage *a, const PackImage *b)
+{
+    if (a->surface->h != b->surface->h)
+    {
+        return a->surface->h > b->surface->h;
+    }
+    return a->surface->w > b->surface->w;
+}
+
+bool placeImages(std::vector<PackImage> &images, std::vector<PackPage> &pages, int pageSize)
+{
+    std::vector<PackImage *> order;
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        order.push_back(&images[i]);
+    }
+    std::sort(order.begin(), order.end(), tallerFirst);
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        PackImage &image = *order[i];
+        int w = image.surface->w + PADDING;
+        int h = image.surface->h + PADDING;
+
+        if (w > pageSize || h > pageSize)
+        {
+            std::cout << image.path << " does not fit in a " << pageSize << " page" << std::endl;
+            return false;
+        }
+
+        SDL_Rect placed;
+        bool inserted = !pages.empty() && pages.back().packer.insert(w, h, &placed);
+        if (!inserted)
+        {
+            PackPage page;
+            page.packer.reset(pageSize, pageSize);
+            page.width = 0;
+            page.height = 0;
+            pages.push_back(page);
+            pages.back().packer.insert(w, h, &placed);
+        }
+
+        PackPage &page = pages.back();
+        image.page = (int)pages.size() - 1;
+        image.rect.x = placed.x;
+        image.rect.y = placed.y;
+        image.rect.w = image.surface->w;
+        image.rect.h = image.surface->h;
+
+        // Pages are trimmed to what was actually used.
+        page.width = std::max(page.width, placed.x + image.rect.w);
+        page.height = std::max(page.height, placed.y + image.rect.h);
+    }
+
+    return true;
+}
+
+static Uint64 alignUp(Uint64 value)
+{
+    return (value + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+}
+
+bool writePack(std::string outputPath, std::vector<PackImage> &images, std::vector<PackPage> &pages)
+{
+    std::vector<AssetPackPage> pageTable(pages.size());
+    std::vector<AssetPackSprite> sprites(images.size());
+    std::vector<AssetPackClip> clips;
+    std::string strings;
+
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        const PackImage &image = images[i];
+        AssetPackSprite &sprite = sprites[i];
+
+        sprite.nameOffset = (Uint32)strings.size();
+        sprite.page = image.page;
+        sprite.x = image.rect.x;
+        sprite.y = image.rect.y;
+        sprite.w = image.rect.w;
+        sprite.h = image.rect.h;
+        sprite.firstClip = (Uint32)clips.size();
+        sprite.clipCount = (Uint32)image.clips.size();
+        sprite.flags = image.opaque ? ASSET_PACK_SPRITE_OPAQUE : 0;
+        sprite.reserved = 0;
+
+        strings += image.name;
+        strings += '\0';
+        clips.insert(clips.end(), image.clips.begin(), image.clips.end());
+    }
+
+    AssetPackHeader header;
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.pixelFormat = SDL_PIXELFORMAT_ARGB8888;
+    header.pageCount = (Uint32)pages.size();
+    header.spriteCount = (Uint32)sprites.size();
+    header.clipCount = (Uint32)clips.size();
+    header.stringBytes = (Uint32)strings.size();
+    header.reserved = 0;
+
+    Uint64 offset = alignUp(sizeof(header) + pageTable.size() * sizeof(AssetPackPage) + sprites.size() * sizeof(AssetPackSprite) +
+                            clips.size() * sizeof(AssetPackClip) + strings.size());
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        pageTable[i].width = pages[i].width;
+        pageTable[i].height = pages[i].height;
+        pageTable[i].pitch = pages[i].width * 4;
+        pageTable[i].reserved = 0;
+        pageTable[i].offset = offset;
+        offset = alignUp(offset + (Uint64)pageTable[i].pitch * pageTable[i].height);
+    }
+
+    std::string tempPath = outputPath + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+
+    out.write((const char *)&header, sizeof(header));
+    out.write((const char *)pageTable.data(), pageTable.size() * sizeof(AssetPackPage));
+    out.write((const char *)sprites.data(), sprites.size() * sizeof(AssetPackSprite));
+    out.write((const char *)clips.data(), clips.size() * sizeof(AssetPackClip));
+    out.write(strings.data(), strings.size());
+
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        const AssetPackPage &page = pageTable[i];
+        std::vector<Uint32> pixels((size_t)page.width * page.height, 0);
+
+        for (size_t j = 0; j < images.size(); ++j)
+        {
+            const PackImage &image = images[j];
+            if (image.page != (int)i)
+            {
+                continue;
+            }
+
+            for (int y = 0; y < image.rect.h; ++y)
+            {
+                const Uint8 *row = (const Uint8 *)image.surface->pixels + y * image.surface->pitch;
+                memcpy(&pixels[(size_t)(image.rect.y + y) * page.width + image.rect.x], row, image.rect.w * sizeof(Uint32));
+            }
+        }
+
+        std::vector<char> padding((size_t)(page.offset - out.tellp()), 0);
+        out.write(padding.data(), padding.size());
+        out.write((const char *)pixels.data(), pixels.size() * sizeof(Uint32));
+    }
+
+    out.close();
+    if (!out)
+    {
+        std::cout << "Unable to write " << outputPath << std::endl;
+        std::error_code error;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, outputPath, error);
+    if (error)
+    {
+        std::cout << "Unable to write " << outputPath << "! " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    std::ofstream depfile(outputPath + ".d");
+    depfile << outputPath << ":";
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        depfile << " " << images[i].path;
+    }
+    depfile << std::endl;
+
+    return true;
+}
+
+int main(int argc, char const *argv[])
+{
+    int pageSize = DEFAULT_PAGE_SIZE;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--page-size") == 0 && i + 1 < argc)
+        {
+            pageSize = atoi(argv[++i]);
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (paths.size() != 2 || pageSize <= 0)
+    {
+        std::cout << "usage: asset_packer [--page-size N] <manifest> <output.pack>" << std::endl;
+        return 1;
+    }
+
+    std::vector<PackImage> images;
+    std::vector<PackPage> pages;
+    bool success = parseManifest(paths[0], images);
+
+    for (size_t i = 0; success && i < images.size(); ++i)
+    {
+        success = loadImage(images[i]);
+    }
+
+    success = success && placeImages(images, pages, pageSize) && writePack(paths[1], images, pages);
+
+    if (success)
+    {
+        std::cout << paths[1] << ": " << images.size() << " images on " << pages.size() << " pages" << std::endl;
+    }
+
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        SDL_FreeSurface(images[i].surface);
+    }
+    IMG_Quit();
+
+    return success ? 0 : 1;
+}